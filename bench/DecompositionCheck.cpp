@@ -0,0 +1,140 @@
+#include <ConvexDecomposition.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Checks convex decomposition on a solid whose answer is known: a U of unit
+// cells, which three boxes cover exactly. The decomposition must return three
+// hulls, each a box on the cell grid, that between them cover every filled
+// cell once and no empty one. Which three boxes is up to the plane search;
+// the span may go with either upright. Exits non-zero otherwise.
+//
+//   particlefront_check_decomposition
+
+namespace {
+    // Cells of the U, one unit each and one deep, as rows from the top.
+    constexpr int kColumns = 3;
+    constexpr int kRows = 3;
+    constexpr std::array<const char*, kRows> kShape = {
+        "#.#",
+        "#.#",
+        "###",
+    };
+    constexpr size_t kExpectedHulls = 3;
+    constexpr float kTolerance = 1e-4f;
+
+    struct Box {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    bool filled(int x, int y) {
+        if (x < 0 || x >= kColumns || y < 0 || y >= kRows) return false;
+        return kShape[kRows - 1 - y][x] == '#';
+    }
+
+    void addQuad(std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices, glm::vec3 a, glm::vec3 b, glm::vec3 c, glm::vec3 d) {
+        uint32_t base = static_cast<uint32_t>(vertices.size());
+        vertices.insert(vertices.end(), {a, b, c, d});
+        indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+
+    // Closed surface of the filled cells, one quad per face between a filled
+    // cell and an empty one, wound counter-clockwise seen from outside.
+    void buildShape(std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices) {
+        for (int y = 0; y < kRows; ++y) {
+            for (int x = 0; x < kColumns; ++x) {
+                if (!filled(x, y)) continue;
+                float x0 = float(x), x1 = float(x + 1);
+                float y0 = float(y), y1 = float(y + 1);
+                addQuad(vertices, indices, {x0, y0, 1.0f}, {x1, y0, 1.0f}, {x1, y1, 1.0f}, {x0, y1, 1.0f});
+                addQuad(vertices, indices, {x0, y0, 0.0f}, {x0, y1, 0.0f}, {x1, y1, 0.0f}, {x1, y0, 0.0f});
+                if (!filled(x + 1, y)) addQuad(vertices, indices, {x1, y0, 0.0f}, {x1, y1, 0.0f}, {x1, y1, 1.0f}, {x1, y0, 1.0f});
+                if (!filled(x - 1, y)) addQuad(vertices, indices, {x0, y0, 0.0f}, {x0, y0, 1.0f}, {x0, y1, 1.0f}, {x0, y1, 0.0f});
+                if (!filled(x, y + 1)) addQuad(vertices, indices, {x0, y1, 0.0f}, {x0, y1, 1.0f}, {x1, y1, 1.0f}, {x1, y1, 0.0f});
+                if (!filled(x, y - 1)) addQuad(vertices, indices, {x0, y0, 0.0f}, {x1, y0, 0.0f}, {x1, y0, 1.0f}, {x0, y0, 1.0f});
+            }
+        }
+    }
+
+    Box bounds(const ConvexHull& hull) {
+        Box box{glm::vec3(INFINITY), glm::vec3(-INFINITY)};
+        for (const glm::vec3& vertex : hull.vertices) {
+            box.min = glm::min(box.min, vertex);
+            box.max = glm::max(box.max, vertex);
+        }
+        return box;
+    }
+
+    bool onGrid(float value) {
+        return std::abs(value - std::round(value)) <= kTolerance;
+    }
+
+    // A box is its bounds' eight corners and nothing else, lying on cell
+    // boundaries.
+    bool isGridBox(const ConvexHull& hull, const Box& box) {
+        if (hull.vertices.size() != 8) return false;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (!onGrid(box.min[axis]) || !onGrid(box.max[axis])) return false;
+        }
+        for (const glm::vec3& vertex : hull.vertices) {
+            for (int axis = 0; axis < 3; ++axis) {
+                if (std::abs(vertex[axis] - box.min[axis]) > kTolerance && std::abs(vertex[axis] - box.max[axis]) > kTolerance) return false;
+            }
+        }
+        return true;
+    }
+
+    std::ostream& operator<<(std::ostream& out, const Box& box) {
+        return out << "(" << box.min.x << ", " << box.min.y << ", " << box.min.z << ")-(" << box.max.x << ", " << box.max.y << ", " << box.max.z << ")";
+    }
+}
+
+int main() {
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices;
+    buildShape(vertices, indices);
+
+    std::vector<ConvexHull> hulls = decomposeConvex(vertices, indices);
+    auto report = [&](const char* problem) {
+        std::cerr << "U-shaped solid: " << problem << "\n";
+        for (const ConvexHull& hull : hulls) {
+            std::cerr << "  " << bounds(hull) << ", " << hull.vertices.size() << " vertices\n";
+        }
+        return 1;
+    };
+    if (hulls.size() != kExpectedHulls) {
+        return report("expected three hulls");
+    }
+
+    std::array<std::array<int, kColumns>, kRows> covered{};
+    for (const ConvexHull& hull : hulls) {
+        Box box = bounds(hull);
+        if (!isGridBox(hull, box)) {
+            return report("a hull is not a box on the cell grid");
+        }
+        if (std::round(box.min.z) != 0.0f || std::round(box.max.z) != 1.0f) {
+            return report("a hull is not one cell deep");
+        }
+        for (int y = int(std::round(box.min.y)); y < int(std::round(box.max.y)); ++y) {
+            for (int x = int(std::round(box.min.x)); x < int(std::round(box.max.x)); ++x) {
+                if (!filled(x, y)) {
+                    return report("a hull covers an empty cell");
+                }
+                ++covered[y][x];
+            }
+        }
+    }
+    for (int y = 0; y < kRows; ++y) {
+        for (int x = 0; x < kColumns; ++x) {
+            if (filled(x, y) && covered[y][x] != 1) {
+                return report("a filled cell is not covered exactly once");
+            }
+        }
+    }
+    std::cout << "U-shaped solid decomposed into " << kExpectedHulls << " boxes covering it exactly\n";
+    return 0;
+}
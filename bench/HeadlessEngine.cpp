@@ -0,0 +1,29 @@
+#include <Renderer.h>
+#include <ShaderManager.h>
+#include <TextureManager.h>
+#include <iostream>
+
+// Stand-ins for the renderer-side singletons that entities reach for, so the
+// collision and physics sources link without a window or Vulkan device.
+// Entity already treats a missing renderer as "nothing to draw": no uniform
+// buffers or descriptor sets are created and destruction skips the device.
+
+Renderer* Renderer::getInstance() { return nullptr; }
+ShaderManager* Renderer::getShaderManager() const { return nullptr; }
+std::vector<VkDescriptorSet> Renderer::createDescriptorSets(VkDescriptorPool, VkDescriptorSetLayout&, int, int, std::vector<Image*>&, std::vector<VkBuffer>&) { return {}; }
+void Renderer::createBuffer(VkDeviceSize, VkBufferUsageFlags, VkMemoryPropertyFlags, VkBuffer&, VkDeviceMemory&) {}
+
+TextureManager* TextureManager::getInstance() { return nullptr; }
+Image* TextureManager::getTexture(const std::string&) { return nullptr; }
+bool TextureManager::loadHeightmap(const std::string& path, std::vector<uint16_t>&, int&, int&) {
+    std::cerr << "HeadlessEngine - heightmap images are not loaded headless: " << path << "\n";
+    return false;
+}
+
+Shader* ShaderManager::getShader(const std::string&) { return nullptr; }
+
+// Entity only calls these with a device, which never exists here.
+VKAPI_ATTR VkResult VKAPI_CALL vkMapMemory(VkDevice, VkDeviceMemory, VkDeviceSize, VkDeviceSize, VkMemoryMapFlags, void**) { return VK_ERROR_DEVICE_LOST; }
+VKAPI_ATTR void VKAPI_CALL vkUnmapMemory(VkDevice, VkDeviceMemory) {}
+VKAPI_ATTR void VKAPI_CALL vkDestroyBuffer(VkDevice, VkBuffer, const VkAllocationCallbacks*) {}
+VKAPI_ATTR void VKAPI_CALL vkFreeMemory(VkDevice, VkDeviceMemory, const VkAllocationCallbacks*) {}
@@ -0,0 +1,646 @@
+#include <CharacterEntity.h>
+#include <Collider.h>
+#include <CollisionWorld.h>
+#include <Entity.h>
+#include <EntityPool.h>
+#include <JobSystem.h>
+#include <MeshCollider.h>
+#include <PhysicsWorld.h>
+#include <RigidBody.h>
+#include <glm/glm.hpp>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// Microbenchmarks for the collision and physics hot paths, run headless
+// against synthetic worlds of static boxes and convex hulls, characters on a
+// mesh floor or standing idle, and towers of stacked rigid boxes. Prints one
+// JSON document with the time and heap allocations per operation of each
+// benchmark, and what each job of the job system took while it ran, so runs
+// can be compared across releases. Exits non-zero when a benchmark's scene
+// did not behave, such as a stack that fell over.
+//
+//   particlefront_bench_physics [colliders...]      default: 10000 100000
+
+namespace {
+    std::atomic<uint64_t> allocationCount{0};
+}
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+    constexpr double kMinBenchSeconds = 0.25;
+    constexpr size_t kProbeCount = 256;
+    constexpr size_t kHullShapes = 16;
+    constexpr size_t kCharacterGrid = 16;
+    constexpr int kCharacterSettleFrames = 60;
+    constexpr float kGridSpacing = 4.0f;
+    constexpr float kCharacterSpacing = 6.0f;
+    // Characters walking over a bumpy triangle-mesh floor, with capsule and
+    // with box bodies of the same size.
+    constexpr size_t kMeshCharacterGrid = 20;
+    constexpr float kMeshCharacterSpacing = 4.0f;
+    constexpr size_t kMeshFloorCells = 64;
+    constexpr float kMeshFloorCellSize = 2.0f;
+    constexpr float kMeshFloorBump = 0.25f;
+    // Characters standing still, long enough for every one to fall asleep.
+    constexpr size_t kIdleCharacterGrid = 20;
+    constexpr int kIdleSettleFrames = 240;
+    // Box towers for the rigid-body step, kStackHeight boxes each.
+    constexpr size_t kStackedBoxes = 3000;
+    constexpr size_t kStackHeight = 10;
+    constexpr float kStackSpacing = 3.0f;
+    constexpr float kStackSettleSeconds = 1.0f;
+    // A box further than this from where it was stacked has fallen.
+    constexpr float kStackTolerance = 0.25f;
+    constexpr double kFrameBudgetMs = 1000.0 / 60.0;
+    // A wave of props, each an entity with a box collider, spawned and then
+    // despawned all together.
+    constexpr size_t kSpawnCount = 4000;
+    // Hull pairs resolved by both SAT and GJK/EPA, whose depths must agree
+    // to within kDepthTolerance.
+    constexpr size_t kHullPairs = 2000;
+    // Hulls of 20 points: three rings of six between the poles.
+    constexpr uint32_t kSmallHullRings = 4;
+    constexpr uint32_t kSmallHullSegments = 6;
+    constexpr float kDepthTolerance = 1e-3f;
+    // Every this many grid cells holds a convex hull instead of a box.
+    constexpr size_t kConvexEvery = 8;
+    // Interleaved like Model: position, normal, uv.
+    constexpr size_t kInterleavedStride = 8;
+    constexpr float kPi = 3.14159265358979323846f;
+
+    struct BenchResult {
+        std::string name;
+        size_t colliders = 0;
+        uint64_t operations = 0;
+        double nsPerOp = 0.0;
+        double allocsPerOp = 0.0;
+        std::vector<JobSystem::JobStats> jobs;
+        bool failed = false;
+    };
+
+    // Results are folded in here so the optimiser cannot drop the work.
+    volatile float sink = 0.0f;
+
+    // Runs pass, which performs opsPerPass operations, once to warm caches and
+    // then repeatedly until kMinBenchSeconds have passed.
+    template <typename Pass>
+    BenchResult runBench(const std::string& name, size_t colliders, uint64_t opsPerPass, Pass&& pass) {
+        using Clock = std::chrono::steady_clock;
+        pass();
+        JobSystem* jobSystem = JobSystem::getInstance();
+        jobSystem->resetStats();
+        uint64_t operations = 0;
+        const uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        const Clock::time_point start = Clock::now();
+        double seconds = 0.0;
+        do {
+            pass();
+            operations += opsPerPass;
+            seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (seconds < kMinBenchSeconds);
+        const uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        const double ops = static_cast<double>(std::max<uint64_t>(operations, 1));
+        return {name, colliders, operations, seconds * 1e9 / ops, static_cast<double>(allocations) / ops, jobSystem->getStats()};
+    }
+
+    struct Mesh {
+        std::vector<float> interleaved;
+        std::vector<uint32_t> indices;
+    };
+
+    // Ellipsoid with the given radii, wound counter-clockwise from outside,
+    // with rings - 1 rings of segments points between its two poles.
+    Mesh buildEllipsoid(const glm::vec3& radii, uint32_t rings = 6, uint32_t segments = 10) {
+        Mesh mesh;
+        auto addVertex = [&](const glm::vec3& normal, float u, float v) {
+            const glm::vec3 position = normal * radii;
+            mesh.interleaved.insert(mesh.interleaved.end(), {position.x, position.y, position.z, normal.x, normal.y, normal.z, u, v});
+        };
+        addVertex({0.0f, 1.0f, 0.0f}, 0.5f, 0.0f);
+        for (uint32_t r = 1; r < rings; ++r) {
+            const float phi = kPi * static_cast<float>(r) / rings;
+            for (uint32_t s = 0; s < segments; ++s) {
+                const float theta = 2.0f * kPi * static_cast<float>(s) / segments;
+                addVertex({std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)},
+                          static_cast<float>(s) / segments, static_cast<float>(r) / rings);
+            }
+        }
+        addVertex({0.0f, -1.0f, 0.0f}, 0.5f, 1.0f);
+        const uint32_t bottom = 1 + (rings - 1) * segments;
+        auto ring = [&](uint32_t r, uint32_t s) { return 1 + (r - 1) * segments + s % segments; };
+        for (uint32_t s = 0; s < segments; ++s) {
+            mesh.indices.insert(mesh.indices.end(), {0, ring(1, s + 1), ring(1, s)});
+            for (uint32_t r = 1; r + 1 < rings; ++r) {
+                mesh.indices.insert(mesh.indices.end(), {ring(r, s), ring(r, s + 1), ring(r + 1, s)});
+                mesh.indices.insert(mesh.indices.end(), {ring(r, s + 1), ring(r + 1, s + 1), ring(r + 1, s)});
+            }
+            mesh.indices.insert(mesh.indices.end(), {bottom, ring(rings - 1, s), ring(rings - 1, s + 1)});
+        }
+        return mesh;
+    }
+
+    glm::vec3 randomVec3(std::mt19937& rng, float lo, float hi) {
+        std::uniform_real_distribution<float> dist(lo, hi);
+        return {dist(rng), dist(rng), dist(rng)};
+    }
+
+    ConvexCollider* makeHull(const glm::vec3& position, const glm::vec3& rotation, const Mesh& mesh) {
+        auto* hull = new ConvexCollider(position, rotation, "bench");
+        hull->setVerticesInterleaved(mesh.interleaved, kInterleavedStride, 0, mesh.indices);
+        return hull;
+    }
+
+    // A floor slab with static boxes and hulls on a grid above it; the slab
+    // counts as one of the colliders.
+    struct World {
+        Entity* level = nullptr;
+        std::vector<Collider*> boxes;
+        std::vector<Collider*> hulls;
+        std::vector<Collider*> all;
+    };
+
+    World buildWorld(size_t colliderCount, const std::vector<Mesh>& hullMeshes, std::mt19937& rng) {
+        World world;
+        world.level = new Entity("level", "", glm::vec3(0.0f), glm::vec3(0.0f));
+        const size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(colliderCount))));
+        const float halfExtent = 0.5f * kGridSpacing * static_cast<float>(side);
+        auto* floor = new OBBCollider({0.0f, -1.0f, 0.0f}, glm::vec3(0.0f), "level", {halfExtent + kGridSpacing, 1.0f, halfExtent + kGridSpacing});
+        world.level->addChild(floor);
+        world.boxes.push_back(floor);
+        std::uniform_real_distribution<float> yaw(0.0f, 360.0f);
+        for (size_t i = 1; i < colliderCount; ++i) {
+            const glm::vec3 cell(kGridSpacing * static_cast<float>(i % side) - halfExtent, 0.0f, kGridSpacing * static_cast<float>(i / side) - halfExtent);
+            const glm::vec3 rotation = glm::vec3(0.0f, yaw(rng), 0.0f) + randomVec3(rng, -10.0f, 10.0f);
+            if (i % kConvexEvery == 0) {
+                ConvexCollider* hull = makeHull(cell + glm::vec3(0.0f, 0.6f, 0.0f), rotation, hullMeshes[i % hullMeshes.size()]);
+                world.level->addChild(hull);
+                world.hulls.push_back(hull);
+            } else {
+                const glm::vec3 half = randomVec3(rng, 0.3f, 1.2f);
+                auto* box = new OBBCollider(cell + glm::vec3(0.0f, half.y, 0.0f), rotation, "level", half);
+                world.level->addChild(box);
+                world.boxes.push_back(box);
+            }
+        }
+        for (Entity* child : world.level->getChildren()) {
+            auto* collider = static_cast<Collider*>(child);
+            collider->setStatic(true);
+            collider->updateWorldTransform();
+            world.all.push_back(collider);
+        }
+        CollisionWorld::getInstance()->refit();
+        return world;
+    }
+
+    glm::vec3 boundsCenter(const Collider& collider) {
+        const ColliderAABB bounds = collider.getWorldAABB();
+        return 0.5f * (bounds.min + bounds.max);
+    }
+
+    // MTV queries of detached probes against every target, each probe
+    // displaced onto its target so that every pair overlaps.
+    BenchResult benchIntersects(const std::string& name, size_t colliders, const std::vector<Collider*>& probes, const std::vector<Collider*>& targets, std::mt19937& rng) {
+        std::vector<glm::vec3> deltas(targets.size());
+        for (size_t i = 0; i < targets.size(); ++i) {
+            const Collider& probe = *probes[i % probes.size()];
+            deltas[i] = boundsCenter(*targets[i]) - boundsCenter(probe) + randomVec3(rng, -0.4f, 0.4f);
+        }
+        return runBench(name, colliders, targets.size(), [&] {
+            float total = 0.0f;
+            for (size_t i = 0; i < targets.size(); ++i) {
+                CollisionMTV mtv{};
+                if (probes[i % probes.size()]->intersectsMTV(*targets[i], mtv, deltas[i])) {
+                    total += mtv.penetration;
+                }
+            }
+            sink = sink + total;
+        });
+    }
+
+    BenchResult benchWorldAABB(const std::string& name, const std::vector<Collider*>& colliders) {
+        return runBench(name, colliders.size(), colliders.size(), [&] {
+            float total = 0.0f;
+            for (const Collider* collider : colliders) {
+                total += collider->getWorldAABB().max.y;
+            }
+            sink = sink + total;
+        });
+    }
+
+    // Frames of characters walking through the world: broadphase refit, then
+    // one fixed physics step. One operation is one character stepped once.
+    // The characters are deleted afterwards.
+    BenchResult benchCharacterFrames(const std::string& name, size_t colliders, std::vector<CharacterEntity*>& characters) {
+        PhysicsWorld* physics = PhysicsWorld::getInstance();
+        const float timestep = physics->getTimestep();
+        auto frame = [&] {
+            for (CharacterEntity* character : characters) {
+                character->updateWorldTransform();
+                for (Entity* child : character->getChildren()) {
+                    child->updateWorldTransform();
+                }
+            }
+            CollisionWorld::getInstance()->refit();
+            physics->update(timestep);
+        };
+        for (int i = 0; i < kCharacterSettleFrames; ++i) {
+            frame();
+        }
+        BenchResult result = runBench(name, colliders, characters.size(), frame);
+        for (CharacterEntity* character : characters) {
+            delete character;
+        }
+        characters.clear();
+        return result;
+    }
+
+    // grid by grid characters, spacing apart and each walking on its own heading.
+    std::vector<CharacterEntity*> spawnWalkers(size_t grid, float spacing, float height, bool capsules) {
+        std::vector<CharacterEntity*> characters;
+        const float offset = 0.5f * spacing * static_cast<float>(grid - 1);
+        for (size_t i = 0; i < grid * grid; ++i) {
+            const glm::vec3 position(spacing * static_cast<float>(i % grid) - offset, height, spacing * static_cast<float>(i / grid) - offset);
+            auto* character = new CharacterEntity("walker" + std::to_string(i), "", position, glm::vec3(0.0f));
+            if (capsules) {
+                character->addChild(new CapsuleCollider({0.0f, 0.6f, 0.0f}, glm::vec3(0.0f), character->getName(), 0.5f, 1.8f));
+            } else {
+                character->addChild(new OBBCollider({0.0f, 0.6f, 0.0f}, glm::vec3(0.0f), character->getName(), {0.5f, 1.8f, 0.5f}));
+            }
+            const float heading = 2.0f * kPi * static_cast<float>(i) / static_cast<float>(grid * grid);
+            character->move({std::cos(heading), 0.0f, std::sin(heading)});
+            characters.push_back(character);
+        }
+        return characters;
+    }
+
+    BenchResult benchCharacters(size_t colliders) {
+        std::vector<CharacterEntity*> characters = spawnWalkers(kCharacterGrid, kCharacterSpacing, 3.0f, true);
+        return benchCharacterFrames("CharacterEntity::simulate", colliders, characters);
+    }
+
+    // kMeshCharacterGrid squared characters on a static mesh floor of random
+    // heights, once with capsule bodies and once with boxes.
+    std::vector<BenchResult> benchCharactersOnMesh() {
+        std::mt19937 rng(static_cast<uint32_t>(kMeshFloorCells));
+        std::uniform_real_distribution<float> bump(0.0f, kMeshFloorBump);
+        const size_t side = kMeshFloorCells + 1;
+        const float offset = 0.5f * kMeshFloorCellSize * static_cast<float>(kMeshFloorCells);
+        std::vector<float> positions;
+        for (size_t i = 0; i < side * side; ++i) {
+            positions.insert(positions.end(), {kMeshFloorCellSize * static_cast<float>(i % side) - offset, bump(rng), kMeshFloorCellSize * static_cast<float>(i / side) - offset});
+        }
+        std::vector<uint32_t> indices;
+        for (uint32_t z = 0; z < kMeshFloorCells; ++z) {
+            for (uint32_t x = 0; x < kMeshFloorCells; ++x) {
+                const uint32_t corner = z * static_cast<uint32_t>(side) + x;
+                const uint32_t below = corner + static_cast<uint32_t>(side);
+                indices.insert(indices.end(), {corner, below, corner + 1, corner + 1, below, below + 1});
+            }
+        }
+        auto* floor = new Entity("meshFloor", "", glm::vec3(0.0f), glm::vec3(0.0f));
+        auto* mesh = new MeshCollider(glm::vec3(0.0f), glm::vec3(0.0f), "meshFloor");
+        mesh->setVertices(positions, indices);
+        mesh->setStatic(true);
+        floor->addChild(mesh);
+        floor->updateWorldTransform();
+        mesh->updateWorldTransform();
+        CollisionWorld::getInstance()->refit();
+
+        std::vector<BenchResult> results;
+        for (bool capsules : {true, false}) {
+            std::vector<CharacterEntity*> characters = spawnWalkers(kMeshCharacterGrid, kMeshCharacterSpacing, 3.0f, capsules);
+            results.push_back(benchCharacterFrames(capsules ? "CharacterEntity::simulate/meshCapsule" : "CharacterEntity::simulate/meshOBB", 1, characters));
+        }
+        delete floor;
+        return results;
+    }
+
+    // Frames of kIdleCharacterGrid squared characters standing on a floor
+    // without input, once with every body woken before each step and once
+    // left asleep. One operation is one frame.
+    std::vector<BenchResult> benchIdleCharacters() {
+        auto* floor = new Entity("idleFloor", "", glm::vec3(0.0f), glm::vec3(0.0f));
+        floor->addChild(new OBBCollider({0.0f, -0.5f, 0.0f}, glm::vec3(0.0f), "idleFloor", {200.0f, 0.5f, 200.0f}));
+        floor->updateWorldTransform();
+        for (Entity* child : floor->getChildren()) {
+            child->updateWorldTransform();
+        }
+        std::vector<CharacterEntity*> characters;
+        const float offset = 0.5f * kCharacterSpacing * static_cast<float>(kIdleCharacterGrid - 1);
+        for (size_t i = 0; i < kIdleCharacterGrid * kIdleCharacterGrid; ++i) {
+            const glm::vec3 position(kCharacterSpacing * static_cast<float>(i % kIdleCharacterGrid) - offset, 1.3f, kCharacterSpacing * static_cast<float>(i / kIdleCharacterGrid) - offset);
+            auto* character = new CharacterEntity("idler" + std::to_string(i), "", position, glm::vec3(0.0f));
+            character->addChild(new CapsuleCollider({0.0f, 0.6f, 0.0f}, glm::vec3(0.0f), character->getName(), 0.5f, 1.8f));
+            characters.push_back(character);
+        }
+        PhysicsWorld* physics = PhysicsWorld::getInstance();
+        const float timestep = physics->getTimestep();
+        auto frame = [&](bool wake) {
+            for (CharacterEntity* character : characters) {
+                if (wake) {
+                    character->wake();
+                }
+                character->updateWorldTransform();
+                for (Entity* child : character->getChildren()) {
+                    child->updateWorldTransform();
+                }
+            }
+            CollisionWorld::getInstance()->refit();
+            physics->update(timestep);
+        };
+        for (int i = 0; i < kIdleSettleFrames; ++i) {
+            frame(false);
+        }
+        std::vector<BenchResult> results;
+        results.push_back(runBench("PhysicsWorld::update/idleCharactersAwake", 1, 1, [&] { frame(true); }));
+        for (int i = 0; i < kIdleSettleFrames; ++i) {
+            frame(false);
+        }
+        if (physics->getAwakeBodyCount() != 0) {
+            std::cerr << "idle characters: " << physics->getAwakeBodyCount() << " still awake\n";
+        }
+        results.push_back(runBench("PhysicsWorld::update/idleCharactersAsleep", 1, 1, [&] { frame(false); }));
+        for (CharacterEntity* character : characters) {
+            delete character;
+        }
+        delete floor;
+        return results;
+    }
+
+    // Towers of unit boxes on a floor, stepped at the PhysicsWorld timestep
+    // (120 Hz by default). Every body is woken before each step so the towers
+    // are solved in full rather than left asleep. One operation is one step;
+    // the result fails if any box has moved off its place in the tower.
+    BenchResult benchStackedBoxes(size_t boxes) {
+        auto* floor = new Entity("stackFloor", "", glm::vec3(0.0f), glm::vec3(0.0f));
+        floor->addChild(new OBBCollider({0.0f, -0.5f, 0.0f}, glm::vec3(0.0f), "stackFloor", {500.0f, 0.5f, 500.0f}));
+        floor->updateWorldTransform();
+        for (Entity* child : floor->getChildren()) {
+            child->updateWorldTransform();
+        }
+        const size_t towers = (boxes + kStackHeight - 1) / kStackHeight;
+        const size_t towersPerRow = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(towers))));
+        const float offset = 0.5f * kStackSpacing * static_cast<float>(towersPerRow - 1);
+        std::vector<RigidBody*> bodies;
+        std::vector<glm::vec3> stacked;
+        for (size_t i = 0; i < boxes; ++i) {
+            const size_t tower = i / kStackHeight;
+            const size_t level = i % kStackHeight;
+            const glm::vec3 position(kStackSpacing * static_cast<float>(tower % towersPerRow) - offset, 0.5f + static_cast<float>(level), kStackSpacing * static_cast<float>(tower / towersPerRow) - offset);
+            auto* body = new RigidBody("box" + std::to_string(i), "", position, glm::vec3(0.0f), 10.0f);
+            body->addChild(new OBBCollider(glm::vec3(0.0f), glm::vec3(0.0f), body->getName(), glm::vec3(0.5f)));
+            bodies.push_back(body);
+            stacked.push_back(position);
+        }
+        PhysicsWorld* physics = PhysicsWorld::getInstance();
+        const float timestep = physics->getTimestep();
+        auto frame = [&] {
+            for (RigidBody* body : bodies) {
+                body->wake();
+                body->updateWorldTransform();
+                for (Entity* child : body->getChildren()) {
+                    child->updateWorldTransform();
+                }
+            }
+            CollisionWorld::getInstance()->refit();
+            physics->update(timestep);
+        };
+        const int settleFrames = static_cast<int>(std::ceil(kStackSettleSeconds / timestep));
+        for (int i = 0; i < settleFrames; ++i) {
+            frame();
+        }
+        BenchResult result = runBench("RigidBodySolver::step/stackedBoxes", boxes, 1, frame);
+        size_t fallen = 0;
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            if (glm::length(bodies[i]->getPosition() - stacked[i]) > kStackTolerance) {
+                ++fallen;
+            }
+            delete bodies[i];
+        }
+        const double stepMs = result.nsPerOp * 1e-6;
+        std::cerr << "stacked boxes: " << stepMs << " ms per " << timestep * 1000.0f << " ms step, "
+                  << 100.0 * stepMs / kFrameBudgetMs << "% of a " << kFrameBudgetMs << " ms frame\n";
+        if (fallen != 0) {
+            std::cerr << "stacked boxes: " << fallen << " of " << boxes << " boxes fell\n";
+            result.failed = true;
+        }
+        delete floor;
+        return result;
+    }
+
+    // kHullPairs random pairs of hulls, each resolved once by SAT over the
+    // hulls' half-edge structure and once by GJK/EPA. One operation is one
+    // pair. The results fail if the two disagree on whether or how deep a
+    // pair overlaps.
+    std::vector<BenchResult> benchHullPairs(const std::string& suffix, const std::vector<Mesh>& hullMeshes) {
+        std::mt19937 rng(static_cast<uint32_t>(kHullPairs));
+        std::vector<Collider*> hullsA;
+        std::vector<Collider*> hullsB;
+        for (size_t i = 0; i < kHullPairs; ++i) {
+            hullsA.push_back(makeHull(glm::vec3(0.0f), randomVec3(rng, -180.0f, 180.0f), hullMeshes[rng() % hullMeshes.size()]));
+            hullsB.push_back(makeHull(randomVec3(rng, -1.0f, 1.0f), randomVec3(rng, -180.0f, 180.0f), hullMeshes[rng() % hullMeshes.size()]));
+            hullsA.back()->updateWorldTransform();
+            hullsB.back()->updateWorldTransform();
+        }
+        CollisionWorld* world = CollisionWorld::getInstance();
+        auto resolve = [&](const std::string& name, Narrowphase mode, std::vector<CollisionMTV>& mtvs, std::vector<uint8_t>& hits) {
+            for (size_t i = 0; i < kHullPairs; ++i) {
+                world->setNarrowphase(hullsA[i], hullsB[i], mode);
+            }
+            mtvs.assign(kHullPairs, CollisionMTV{});
+            hits.assign(kHullPairs, 0);
+            return runBench(name, 0, kHullPairs, [&] {
+                for (size_t i = 0; i < kHullPairs; ++i) {
+                    hits[i] = hullsA[i]->intersectsMTV(*hullsB[i], mtvs[i]) ? 1 : 0;
+                }
+            });
+        };
+        std::vector<CollisionMTV> satMtvs;
+        std::vector<CollisionMTV> epaMtvs;
+        std::vector<uint8_t> satHits;
+        std::vector<uint8_t> epaHits;
+        std::vector<BenchResult> results;
+        results.push_back(resolve("ConvexCollider::intersectsMTV/hullPairsSAT" + suffix, Narrowphase::SAT, satMtvs, satHits));
+        results.push_back(resolve("ConvexCollider::intersectsMTV/hullPairsEPA" + suffix, Narrowphase::GJK, epaMtvs, epaHits));
+
+        size_t overlapping = 0;
+        size_t disagreements = 0;
+        float worst = 0.0f;
+        for (size_t i = 0; i < kHullPairs; ++i) {
+            const float sat = satHits[i] ? satMtvs[i].penetration : 0.0f;
+            const float epa = epaHits[i] ? epaMtvs[i].penetration : 0.0f;
+            overlapping += satHits[i];
+            worst = std::max(worst, std::abs(sat - epa));
+            if (std::abs(sat - epa) > kDepthTolerance) {
+                ++disagreements;
+            }
+            world->setNarrowphase(hullsA[i], hullsB[i], Narrowphase::Auto);
+            delete hullsA[i];
+            delete hullsB[i];
+        }
+        std::cerr << "hull pairs" << suffix << ": " << overlapping << " of " << kHullPairs << " overlap, SAT and EPA depths differ by at most " << worst << "\n";
+        if (disagreements != 0) {
+            std::cerr << "hull pairs" << suffix << ": " << disagreements << " pairs differ by more than " << kDepthTolerance << "\n";
+            for (BenchResult& result : results) {
+                result.failed = true;
+            }
+        }
+        return results;
+    }
+
+    // One operation is one entity spawned with its collider and despawned.
+    BenchResult benchSpawnDespawn() {
+        std::vector<Entity*> spawned(kSpawnCount);
+        return runBench("EntityPool/spawnDespawn", 0, kSpawnCount, [&] {
+            for (size_t i = 0; i < kSpawnCount; ++i) {
+                auto* prop = new Entity("prop", "", glm::vec3(static_cast<float>(i), 0.0f, 0.0f), glm::vec3(0.0f));
+                prop->addChild(new OBBCollider(glm::vec3(0.0f), glm::vec3(0.0f), "prop", glm::vec3(0.5f)));
+                spawned[i] = prop;
+            }
+            for (Entity* prop : spawned) {
+                delete prop;
+            }
+        });
+    }
+
+    std::vector<BenchResult> benchWorld(size_t colliderCount, const std::vector<Mesh>& hullMeshes) {
+        std::mt19937 rng(static_cast<uint32_t>(colliderCount));
+        World world = buildWorld(colliderCount, hullMeshes, rng);
+        std::vector<Collider*> boxProbes;
+        std::vector<Collider*> hullProbes;
+        for (size_t i = 0; i < kProbeCount; ++i) {
+            const glm::vec3 rotation = randomVec3(rng, -180.0f, 180.0f);
+            boxProbes.push_back(new OBBCollider(glm::vec3(0.0f), rotation, "probe", randomVec3(rng, 0.3f, 1.0f)));
+            hullProbes.push_back(makeHull(glm::vec3(0.0f), rotation, hullMeshes[i % hullMeshes.size()]));
+        }
+
+        std::vector<BenchResult> results;
+        results.push_back(benchIntersects("OBBCollider::intersectsMTV/OBB", colliderCount, boxProbes, world.boxes, rng));
+        results.push_back(benchIntersects("OBBCollider::intersectsMTV/Convex", colliderCount, boxProbes, world.hulls, rng));
+        results.push_back(benchIntersects("ConvexCollider::intersectsMTV/OBB", colliderCount, hullProbes, world.boxes, rng));
+        results.push_back(benchIntersects("ConvexCollider::intersectsMTV/Convex", colliderCount, hullProbes, world.hulls, rng));
+        results.push_back(benchWorldAABB("Collider::getWorldAABB/baked", world.all));
+        // Nudging the level changes every world transform, which drops the
+        // baked bounds until the next refit.
+        world.level->setPosition({0.0f, 1e-3f, 0.0f});
+        world.level->updateWorldTransform();
+        for (Collider* collider : world.all) {
+            collider->updateWorldTransform();
+        }
+        results.push_back(benchWorldAABB("Collider::getWorldAABB/unbaked", world.all));
+        world.level->setPosition(glm::vec3(0.0f));
+        world.level->updateWorldTransform();
+        for (Collider* collider : world.all) {
+            collider->updateWorldTransform();
+        }
+        CollisionWorld::getInstance()->refit();
+        results.push_back(benchCharacters(colliderCount));
+
+        for (size_t i = 0; i < kProbeCount; ++i) {
+            delete boxProbes[i];
+            delete hullProbes[i];
+        }
+        delete world.level;
+        return results;
+    }
+
+    BenchResult benchSetVertices(const Mesh& mesh) {
+        ConvexCollider hull(glm::vec3(0.0f), glm::vec3(0.0f), "bench");
+        return runBench("ConvexCollider::setVerticesInterleaved", 0, 1, [&] {
+            hull.setVerticesInterleaved(mesh.interleaved, kInterleavedStride, 0, mesh.indices);
+            sink = sink + static_cast<float>(hull.getVertices().size());
+        });
+    }
+
+    void printJson(std::ostream& out, const std::vector<BenchResult>& results) {
+        const size_t threads = JobSystem::getInstance()->getThreadCount();
+        out << "{\n  \"suite\": \"physics\",\n  \"threads\": " << threads << ",\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"colliders\": " << r.colliders
+                      << ", \"operations\": " << r.operations << ", \"ns_per_op\": " << r.nsPerOp
+                      << ", \"allocs_per_op\": " << r.allocsPerOp << ", \"jobs\": [";
+            for (size_t j = 0; j < r.jobs.size(); ++j) {
+                const JobSystem::JobStats& job = r.jobs[j];
+                out << (j > 0 ? ", " : "") << "{\"name\": \"" << job.name << "\", \"runs\": " << job.runs
+                    << ", \"total_ms\": " << job.totalMs << ", \"max_ms\": " << job.maxMs << "}";
+            }
+            out << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    // Engine logging goes to stderr so that stdout holds only the JSON.
+    std::ostream json(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+    std::vector<size_t> worldSizes;
+    for (int i = 1; i < argc; ++i) {
+        const long long count = std::atoll(argv[i]);
+        if (count < 2) {
+            std::cerr << "usage: " << argv[0] << " [colliders...]\n";
+            return 1;
+        }
+        worldSizes.push_back(static_cast<size_t>(count));
+    }
+    if (worldSizes.empty()) {
+        worldSizes = {10000, 100000};
+    }
+
+    std::mt19937 rng(1);
+    std::vector<Mesh> hullMeshes;
+    for (size_t i = 0; i < kHullShapes; ++i) {
+        hullMeshes.push_back(buildEllipsoid(randomVec3(rng, 0.4f, 1.2f)));
+    }
+
+    std::vector<BenchResult> results;
+    results.push_back(benchSetVertices(hullMeshes.front()));
+    results.push_back(benchSpawnDespawn());
+    std::vector<Mesh> smallHullMeshes;
+    for (size_t i = 0; i < kHullShapes; ++i) {
+        smallHullMeshes.push_back(buildEllipsoid(randomVec3(rng, 0.4f, 1.2f), kSmallHullRings, kSmallHullSegments));
+    }
+    for (const auto& [suffix, meshes] : {std::pair{"/20", &smallHullMeshes}, std::pair{"/52", &hullMeshes}}) {
+        for (BenchResult& result : benchHullPairs(suffix, *meshes)) {
+            results.push_back(std::move(result));
+        }
+    }
+    for (size_t count : worldSizes) {
+        for (BenchResult& result : benchWorld(count, hullMeshes)) {
+            results.push_back(std::move(result));
+        }
+    }
+    for (BenchResult& result : benchCharactersOnMesh()) {
+        results.push_back(std::move(result));
+    }
+    for (BenchResult& result : benchIdleCharacters()) {
+        results.push_back(std::move(result));
+    }
+    results.push_back(benchStackedBoxes(kStackedBoxes));
+    printJson(json, results);
+    for (const BenchResult& result : results) {
+        if (result.failed) {
+            return 1;
+        }
+    }
+    return 0;
+}
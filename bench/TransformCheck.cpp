@@ -0,0 +1,161 @@
+#include <Entity.h>
+#include <EntityManager.h>
+#include <EntityStore.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Checks the dirty-flag world transforms against a rebuild from the root, bit
+// for bit. A nested scene is moved, rescaled and reparented at random for a
+// number of rounds; after each round every entity is brought up to date,
+// either by EntityManager::updateAll like the renderer's frame pass or in
+// random order, which exercises stale parents being refreshed from below.
+// The frame pass must also visit entities in the order of the tree walk it
+// replaced, or recorded sessions would replay differently. Exits non-zero on
+// the first mismatch.
+//
+//   particlefront_check_transforms [rounds]      default: 500
+
+namespace {
+    constexpr size_t kRoots = 8;
+    constexpr size_t kEntities = 600;
+    // Share of entities touched in a round, and of those touches that reparent.
+    constexpr float kTouchChance = 0.05f;
+    constexpr float kReparentChance = 0.1f;
+    // Every this many rounds the frame pass runs, sorting the store first,
+    // which moves every slot.
+    constexpr int kSortEvery = 7;
+
+    glm::vec3 randomVec3(std::mt19937& rng, float lo, float hi) {
+        std::uniform_real_distribution<float> dist(lo, hi);
+        return {dist(rng), dist(rng), dist(rng)};
+    }
+
+    // The transform as the root-to-leaf walk built it before world
+    // transforms were cached: every ancestor's steps, outermost first.
+    glm::mat4 rebuildFromRoot(Entity* entity) {
+        std::vector<Entity*> chain;
+        for (Entity* current = entity; current; current = current->getParent()) {
+            chain.push_back(current);
+        }
+        glm::mat4 transform(1.0f);
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            transform = glm::translate(transform, (*it)->getPosition());
+            const glm::vec3 rot = (*it)->getRotation();
+            transform = glm::rotate(transform, glm::radians(rot.x), glm::vec3(1.0f, 0.0f, 0.0f));
+            transform = glm::rotate(transform, glm::radians(rot.y), glm::vec3(0.0f, 1.0f, 0.0f));
+            transform = glm::rotate(transform, glm::radians(rot.z), glm::vec3(0.0f, 0.0f, 1.0f));
+            transform = glm::scale(transform, (*it)->getScale());
+        }
+        return transform;
+    }
+
+    // The frame pass before the store: each root in name order, followed by
+    // its subtree depth first.
+    void walkTree(Entity* entity, std::vector<Entity*>& order) {
+        order.push_back(entity);
+        for (Entity* child : entity->getChildren()) {
+            walkTree(child, order);
+        }
+    }
+
+    bool isAncestor(Entity* ancestor, Entity* entity) {
+        for (Entity* current = entity; current; current = current->getParent()) {
+            if (current == ancestor) return true;
+        }
+        return false;
+    }
+}
+
+int main(int argc, char** argv) {
+    int rounds = 500;
+    if (argc > 1) {
+        rounds = std::atoi(argv[1]);
+        if (rounds < 1) {
+            std::cerr << "usage: " << argv[0] << " [rounds]\n";
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    std::vector<Entity*> entities;
+    for (size_t i = 0; i < kEntities; ++i) {
+        auto* entity = new Entity("node" + std::to_string(i), "", randomVec3(rng, -5.0f, 5.0f), randomVec3(rng, -180.0f, 180.0f), randomVec3(rng, 0.5f, 2.0f));
+        if (i < kRoots) {
+            EntityManager::getInstance()->addEntity(entity->getName(), entity);
+        } else {
+            // Parents are drawn from the newest entities, so chains run deep.
+            std::uniform_int_distribution<size_t> parent(i > 16 ? i - 16 : 0, i - 1);
+            entities[parent(rng)]->addChild(entity);
+        }
+        entities.push_back(entity);
+    }
+
+    EntityManager* entityMgr = EntityManager::getInstance();
+    EntityStore* store = EntityStore::getInstance();
+    size_t checked = 0;
+    for (int round = 0; round < rounds; ++round) {
+        for (Entity* entity : entities) {
+            if (chance(rng) >= kTouchChance) continue;
+            const float action = chance(rng);
+            if (action < kReparentChance) {
+                if (entity->getParent()) {
+                    Entity* target = entities[std::uniform_int_distribution<size_t>(0, kEntities - 1)(rng)];
+                    if (!isAncestor(entity, target)) {
+                        entity->moveToParent(target);
+                    }
+                }
+            } else if (action < 0.4f) {
+                entity->setPosition(randomVec3(rng, -5.0f, 5.0f));
+            } else if (action < 0.7f) {
+                entity->setRotation(randomVec3(rng, -180.0f, 180.0f));
+            } else if (action < 0.9f) {
+                entity->setScale(randomVec3(rng, 0.5f, 2.0f));
+            } else {
+                // Writing the current value must not mark anything stale.
+                entity->setPosition(entity->getPosition());
+            }
+        }
+
+        if (round % kSortEvery == 0) {
+            entityMgr->updateAll(0.0f);
+            std::vector<Entity*> walked;
+            for (auto& [name, root] : entityMgr->getAllEntities()) {
+                walkTree(root, walked);
+            }
+            const size_t count = entityMgr->sortScene();
+            for (size_t slot = 0; slot < std::max(count, walked.size()); ++slot) {
+                if (slot >= count || slot >= walked.size() || store->getOwner(slot) != walked[slot]) {
+                    std::cerr << "round " << round << ": the frame pass leaves the tree walk's order at position " << slot << "\n";
+                    return 1;
+                }
+            }
+        } else {
+            std::vector<Entity*> order = entities;
+            std::shuffle(order.begin(), order.end(), rng);
+            for (Entity* entity : order) {
+                entity->updateWorldTransform();
+            }
+        }
+
+        for (Entity* entity : entities) {
+            const glm::mat4 expected = rebuildFromRoot(entity);
+            const glm::mat4 actual = entity->getWorldTransform();
+            if (std::memcmp(&expected, &actual, sizeof(glm::mat4)) != 0) {
+                std::cerr << "round " << round << ": world transform of " << entity->getName() << " differs from the rebuild from the root\n";
+                return 1;
+            }
+            ++checked;
+        }
+    }
+    std::cout << "world transforms matched the rebuild from the root: " << checked << " checks over " << rounds << " rounds\n";
+    entityMgr->shutdown();
+    return 0;
+}
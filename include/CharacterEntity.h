@@ -3,7 +3,10 @@
 #include <cmath>
 #include <Entity.h>
 #include <Collider.h>
+#include <CollisionWorld.h>
+#include <PhysicsWorld.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <span>
 
 struct collision {
     Collider* other = nullptr;
@@ -17,8 +20,15 @@ public:
         const std::string& shader,
         const glm::vec3& position = {0.0f, 0.0f, 0.0f},
         const glm::vec3& rotation = {0.0f, 0.0f, 0.0f}
-    ) : Entity(name, shader, position, rotation) {}
-    void update(float deltaTime) override;
+    ) : Entity(name, shader, position, rotation) {
+        PhysicsWorld::getInstance()->addBody(this);
+    }
+    ~CharacterEntity() override {
+        PhysicsWorld::getInstance()->removeBody(this);
+    }
+    // One fixed physics step, driven by PhysicsWorld. update() is left to
+    // per-frame gameplay such as input and AI.
+    void simulate(float timestep);
     void move(const glm::vec3& delta);
     void stopMove(const glm::vec3& delta);
     void jump();
@@ -26,17 +36,70 @@ public:
     void rotate(const glm::vec3& delta);
     void setMoveSpeed(float speed) { moveSpeed = speed; }
     float getMoveSpeed() const { return moveSpeed; }
+    // Ledges up to this high are walked onto; ground up to this far below is snapped to.
+    void setStepHeight(float height) { stepHeight = std::max(height, 0.0f); }
+    float getStepHeight() const { return stepHeight; }
+    // How hard the character shoves rigid bodies it walks into; see RigidBodySolver::push.
+    void setPushMass(float mass) { pushMass = std::max(mass, 0.0f); }
+    float getPushMass() const { return pushMass; }
+    // A body left standing on the ground without input goes to sleep and is
+    // not simulated until input, a nearby body, a trigger or a query hit
+    // wakes it; see PhysicsWorld. Gameplay that moves the world under a
+    // sleeping body should wake it.
+    bool isSleeping() const { return sleeping; }
+    void wake() {
+        sleeping = false;
+        idleTime = 0.0f;
+    }
 protected:
+    friend class PhysicsWorld;
     collision willCollide(const glm::vec3& deltaPos, const glm::vec3& deltaRot = glm::vec3(0.0f));
+    // First solid collider attached to the character.
+    Collider* getBodyCollider();
+    // Sweeps the body collider along direction; first contact within distance.
+    bool castBody(const glm::vec3& direction, float distance, RaycastHit& hit);
+    void displace(const glm::vec3& delta);
 private:
     glm::vec3 velocity = glm::vec3(0.0f);
     glm::vec3 pressed = glm::vec3(0.0f);
     float moveSpeed = 10.0f;
+    float stepHeight = 0.3f;
+    float pushMass = 80.0f;
     const float jumpSpeed = 10.0f;
     const float groundedNormalThreshold = 0.5f;
     const float coyoteTime = 0.10f;
     bool grounded = false;
     float groundedTimer = 1.0f;
+    bool sleeping = false;
+    float idleTime = 0.0f;
+    bool depenetrated = false;
+    // Height a grounded step could not shed in its sweeps, dropped by the next one.
+    float pendingDrop = 0.0f;
+    std::vector<Collider*> broadphaseHits;
+    // Separating axes of everything the body swept near last step. Only this
+    // body's island thread touches it.
+    ContactCache contacts;
+    // Bodies stepped together with this one; only set while PhysicsWorld is stepping.
+    std::span<CharacterEntity* const> islandMates;
+    // Rigid bodies walked into during the step, applied by PhysicsWorld once islands are done.
+    struct Push {
+        const Collider* collider = nullptr;
+        glm::vec3 point{0.0f};
+        glm::vec3 direction{0.0f};
+        float speed = 0.0f;
+    };
+    std::vector<Push> pushes;
+
+    // Moves up to displacement and returns the distance covered.
+    float sweep(const glm::vec3& displacement);
+    // Moves along displacement, sliding along what is hit, in at most
+    // maxSweeps swept queries, each taken off sweepsLeft. Returns whether
+    // walkable ground was hit.
+    bool slide(glm::vec3 displacement, bool flattenWalls, int maxSweeps, int& sweepsLeft);
+    // Pushes the body out of whatever it overlaps; only needed when a sweep
+    // starts inside something, and done at most once a step.
+    void depenetrate();
+    bool testCollider(const Collider* myBody, const ColliderAABB& myAABB, const Collider* other, float margin, const glm::vec3& deltaPos, const glm::vec3& deltaRot, collision& out) const;
 
     static bool aabbIntersects(const ColliderAABB& a, const ColliderAABB& b, float margin = 0.0f) {
         if (a.min.x > b.max.x + margin || a.max.x < b.min.x - margin) return false;
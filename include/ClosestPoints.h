@@ -0,0 +1,18 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <GJK.h>
+
+// Closed-form closest points between a segment [p, q] and simple primitives.
+// Each returns the squared distance and writes the closest point on both.
+float closestPointsSegmentSegment(const glm::vec3& p1, const glm::vec3& q1, const glm::vec3& p2, const glm::vec3& q2, glm::vec3& onFirst, glm::vec3& onSecond);
+// box is a ConvexShape of Kind::Box.
+float closestPointsSegmentBox(const glm::vec3& p, const glm::vec3& q, const ConvexShape& box, glm::vec3& onSegment, glm::vec3& onBox);
+float closestPointsSegmentTriangle(const glm::vec3& p, const glm::vec3& q, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, glm::vec3& onSegment, glm::vec3& onTriangle);
+glm::vec3 closestPointOnTriangle(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+
+// Contact between a capsule (Kind::Capsule) and a box, sphere, capsule or
+// triangle (Points with three points) from the distance of the capsule's
+// segment to the other shape; other point sets measure it with GJK. Fills
+// out like gjkPenetration. Only when the segment itself touches the other
+// shape does it fall back to EPA.
+bool capsulePenetration(const ConvexShape& capsule, const ConvexShape& other, GJKResult& out);
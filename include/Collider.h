@@ -9,16 +9,28 @@
 #include <algorithm>
 #include <cstdint>
 #include <utils.h>
+#include <DynamicAABBTree.h>
+#include <GJK.h>
+#include <ConvexPolyhedron.h>
 
 enum class ColliderType {
     AABB,
     OBB,
-    Convex
+    Convex,
+    Mesh,
+    Capsule,
+    Heightfield
 };
 
-struct ColliderAABB {
-    glm::vec3 min{0.0f};
-    glm::vec3 max{0.0f};
+// Which narrowphase resolves a collider pair. Auto uses GJK/EPA whenever a
+// ConvexCollider is involved and SAT for box-box pairs. SAT on hulls finds
+// the same depths as EPA but is several times slower even on 20-point
+// hulls, since it still tries every pair of creases against the Gauss map
+// (PhysicsBench hullPairs), so it is only used where a pair asks for it.
+enum class Narrowphase {
+    Auto,
+    SAT,
+    GJK
 };
 
 struct CollisionMTV {
@@ -27,19 +39,105 @@ struct CollisionMTV {
     float penetration{0.0f};
 };
 
+// Collision layers are bit flags. Two colliders interact only when each one's
+// layer is in the other's mask; pairs that fail are dropped before any narrowphase.
+namespace CollisionLayer {
+    constexpr uint32_t Default = 1u << 0;
+    constexpr uint32_t Static = 1u << 1;
+    constexpr uint32_t Character = 1u << 2;
+    constexpr uint32_t Projectile = 1u << 3;
+    constexpr uint32_t Sensor = 1u << 4;
+    constexpr uint32_t All = DynamicAABBTree::kAllLayers;
+}
+
+class Collider;
+class ConvexCollider;
+
+// One triangle of a concave collider touched by a convex shape. The normal
+// pushes the shape out of the triangle.
+struct MeshContact {
+    uint32_t triangle = 0;
+    glm::vec3 point{0.0f};
+    glm::vec3 normal{0.0f};
+    float penetration = 0.0f;
+};
+
+struct RaycastHit {
+    Collider* collider = nullptr;
+    glm::vec3 point{0.0f};
+    glm::vec3 normal{0.0f};     // surface normal facing the ray or cast shape
+    float distance = 0.0f;
+};
+
 class Collider : public Entity {
 public:
     using Entity::Entity;
-    virtual ~Collider() = default;
+    virtual ~Collider();
     virtual ColliderType getColliderType() const = 0;
-    virtual ColliderAABB getWorldAABB() const = 0;
+    ColliderAABB getWorldAABB() const { return baked ? bakedBounds : computeWorldAABB(); }
     virtual bool intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos = glm::vec3(0.0f), const glm::vec3& deltaRot = glm::vec3(0.0f)) const = 0;
     glm::vec3 intersects(const Collider& other, const glm::vec3& deltaPos = glm::vec3(0.0f), const glm::vec3& deltaRot = glm::vec3(0.0f)) const {
         CollisionMTV res{};
         if (intersectsMTV(other, res, deltaPos, deltaRot)) return res.mtv;
         return glm::vec3(0.0f);
     }
+    // World-space support mapping of this collider, optionally displaced the
+    // same way intersectsMTV displaces it.
+    ConvexShape getSupportShape(const glm::vec3& deltaPos = glm::vec3(0.0f), const glm::vec3& deltaRot = glm::vec3(0.0f)) const {
+        if (!baked || deltaRot != glm::vec3(0.0f)) return computeSupportShape(deltaPos, deltaRot);
+        ConvexShape shape = bakedShape;
+        shape.translate(deltaPos);
+        return shape;
+    }
+    int32_t getProxyId() const { return proxyId; }
+    // Rebuilds any lazily cached world-space data now, so later queries only
+    // read it and several threads can query the collider at once.
+    virtual void prepareQueries() const {}
+    // Closest hit of origin + t * direction (unit length) for t in [0, maxDistance].
+    // The default treats the collider as the convex hull of its support shape.
+    virtual bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const;
+    // Sweeps a convex shape along direction; first contact within maxDistance.
+    // separatingAxis carries the pair's cached axis in and out, see gjkCast.
+    virtual bool shapeCast(const ConvexShape& shape, const glm::vec3& direction, float maxDistance, RaycastHit& hit, glm::vec3* separatingAxis = nullptr) const;
+    static ColliderAABB shapeBounds(const ConvexShape& shape);
+    // Concave colliders (meshes, heightfields) have no useful support mapping.
+    // Other colliders hand them their shape through collideShape instead.
+    virtual bool isConcave() const { return false; }
+    // Resolves a convex shape against every triangle it touches. The combined
+    // MTV pushes the shape out of all contacts at once; individual contacts
+    // are appended to `contacts` when provided.
+    virtual bool collideShape(const ConvexShape& /*shape*/, const ColliderAABB& /*shapeBounds*/, CollisionMTV& /*out*/, std::vector<MeshContact>* /*contacts*/ = nullptr) const { return false; }
+
+    void setCollisionLayer(uint32_t layer);
+    uint32_t getCollisionLayer() const { return collisionLayer; }
+    void setCollisionMask(uint32_t mask) { collisionMask = mask; }
+    uint32_t getCollisionMask() const { return collisionMask; }
+    bool canCollideWith(const Collider& other) const {
+        return (collisionLayer & other.collisionMask) != 0 && (other.collisionLayer & collisionMask) != 0;
+    }
+    // Triggers never block movement or casts. CollisionWorld reports what
+    // overlaps them once per physics step through the callbacks below, which
+    // run on both colliders of the pair.
+    void setTrigger(bool isTrigger);
+    bool isTrigger() const { return trigger; }
+    // Static colliders have their world bounds and shape baked as soon as
+    // they join the world, so queries skip all transform math. Any collider
+    // that sits still for a while is baked the same way. Baked data is
+    // dropped when the collider's world transform changes and rebaked once
+    // CollisionWorld next syncs it.
+    void setStatic(bool isStatic);
+    bool isStatic() const { return staticHint; }
+    bool isBaked() const { return baked; }
+    virtual void onTriggerEnter(Collider* /*other*/) {}
+    virtual void onTriggerStay(Collider* /*other*/) {}
+    virtual void onTriggerExit(Collider* /*other*/) {}
 protected:
+    void onAttached() override;
+    void onDetached() override;
+    void onWorldTransformChanged() override { baked = false; }
+    // The uncached versions of getWorldAABB and getSupportShape.
+    virtual ColliderAABB computeWorldAABB() const = 0;
+    virtual ConvexShape computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const = 0;
     static std::array<glm::vec3, 8> buildOBBCorners(const glm::mat4& transform, const glm::vec3& half);
     static ColliderAABB aabbFromCorners(const std::array<glm::vec3, 8>& corners);
     static void projectOntoAxis(const std::array<glm::vec3, 8>& corners, const glm::vec3& axis, float& min, float& max);
@@ -50,12 +148,48 @@ protected:
     static void addAxisUnique(std::vector<glm::vec3>& axes, const glm::vec3& axis);
     static void projectVertsOntoAxis(const std::vector<glm::vec3>& verts, const glm::vec3& axis, float& mn, float& mx, const glm::vec3& offset = glm::vec3(0.0f));
     static bool satMTV(const std::vector<glm::vec3>& vertsA, const std::vector<glm::vec3>& faceAxesA, const std::vector<glm::vec3>& edgeDirsA, const std::vector<glm::vec3>& vertsB, const std::vector<glm::vec3>& faceAxesB, const std::vector<glm::vec3>& edgeDirsB, const glm::vec3& centerDelta, CollisionMTV& out, const glm::vec3& offsetA = glm::vec3(0.0f), const glm::vec3& offsetB = glm::vec3(0.0f));
+    static glm::mat4 applyDelta(const glm::mat4& transform, const glm::vec3& deltaPos, const glm::vec3& deltaRot);
+    static bool boxConvexSAT(const glm::mat4& transform, const glm::vec3& half, const ConvexCollider& other, CollisionMTV& out);
+    // SAT between two half-edge hulls; the MTV pushes a out of b.
+    static bool polyhedronMTV(const PolyhedronView& a, const PolyhedronView& b, CollisionMTV& out);
+    // A box as a PolyhedronView whose vertices and planes live in the given arrays.
+    static PolyhedronView boxPolyhedron(const glm::mat4& transform, const glm::vec3& half, std::array<glm::vec3, 8>& vertices, std::array<glm::vec4, 6>& planes);
+    static bool obbOverlapMTV(const ConvexShape& a, const ConvexShape& b, CollisionMTV& out);
+    static bool gjkMTV(const ConvexShape& a, const ConvexShape& b, CollisionMTV& out);
+    // Either a or b must be a capsule; the MTV pushes a out of b.
+    static bool capsuleMTV(const ConvexShape& a, const ConvexShape& b, CollisionMTV& out);
+    static bool rayBox(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const ConvexShape& box, float& distance, glm::vec3& normal);
+    static bool rayTriangle(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, float& distance, glm::vec3& normal);
+    // Contact of shape with a world-space triangle, if it is deeper than a
+    // hair. Bit e of flatEdges marks edge (e, e+1) as shared with a coplanar
+    // neighbour; contacts on those edges resolve along the face normal so
+    // shapes slide across them without snagging. A one-sided triangle always
+    // pushes toward its front (counter-clockwise) face.
+    static bool triangleContact(const ConvexShape& shape, const std::array<glm::vec3, 3>& verts, uint8_t flatEdges, bool oneSided, MeshContact& out);
+    // Sums contacts [first, end) into one MTV, deepest first, each adding only
+    // what the push so far has not already resolved along its normal.
+    static bool combineContacts(const std::vector<MeshContact>& contacts, size_t first, CollisionMTV& out);
     static void buildConvexData(const std::vector<glm::vec3>& localVerts, const std::vector<glm::ivec3>& tris, const glm::mat4& worldTr, std::vector<glm::vec3>& outVerts, std::vector<glm::vec3>& outFaceAxes, std::vector<glm::vec3>& outEdgeDirs, glm::vec3& outCenter);
+private:
+    friend class CollisionWorld;
+    int32_t proxyId = DynamicAABBTree::kNullNode;
+    size_t worldIndex = 0;
+    glm::mat4 proxyTransform{0.0f};
+    glm::vec3 proxyCenter{0.0f};
+    uint32_t collisionLayer = CollisionLayer::Default;
+    uint32_t collisionMask = CollisionLayer::All;
+    bool trigger = false;
+    bool staticHint = false;
+    bool baked = false;
+    uint32_t idleRefits = 0;
+    ColliderAABB bakedBounds;
+    ConvexShape bakedShape;
+
+    void bake();
 };
 
 class OBBCollider;
 class AABBCollider;
-class ConvexCollider;
 
 class OBBCollider : public Collider {
 public:
@@ -64,14 +198,14 @@ public:
 
     ColliderType getColliderType() const override { return ColliderType::OBB; }
 
-    ColliderAABB getWorldAABB() const override {
-        glm::mat4 tr = const_cast<OBBCollider*>(this)->getWorldTransform();
-        auto corners = buildOBBCorners(tr, halfSize);
-        return aabbFromCorners(corners);
-    }
     bool intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const override;
     glm::vec3 getHalfSize() const { return halfSize; }
 
+protected:
+    ColliderAABB computeWorldAABB() const override;
+    ConvexShape computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
+
 private:
     glm::vec3 halfSize;
 };
@@ -81,12 +215,11 @@ public:
     AABBCollider(const glm::vec3 position, const glm::vec3 rotation, const std::string& parentName = "", const glm::vec3 halfSize = {0.5f, 0.5f, 0.5f})
         : Collider("collision_" + parentName, "", position, rotation, {1.0f,1.0f,1.0f}), half(halfSize) {}
     ColliderType getColliderType() const override { return ColliderType::AABB; }
-    ColliderAABB getWorldAABB() const override {
-        glm::mat4 tr = const_cast<AABBCollider*>(this)->getWorldTransform();
-        auto corners = buildOBBCorners(tr, half);
-        return aabbFromCorners(corners);
-    }
     bool intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const override;
+protected:
+    ColliderAABB computeWorldAABB() const override;
+    ConvexShape computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
 private:
     glm::vec3 half;
 };
@@ -96,9 +229,9 @@ public:
     ConvexCollider(const glm::vec3 position, const glm::vec3 rotation, const std::string& parentName = "")
         : Collider("collision_" + parentName, "", position, rotation, {1.0f,1.0f,1.0f}) {}
     ColliderType getColliderType() const override { return ColliderType::Convex; }
-    ColliderAABB getWorldAABB() const override;
 
     bool intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
+    void prepareQueries() const override { ensureCacheUpdated(); }
 
     void setVertices(const std::vector<float>& positions, const std::vector<uint32_t>& indices, const glm::vec3& rotationDegrees = glm::vec3(0.0f));
 
@@ -110,10 +243,21 @@ public:
     const std::vector<glm::vec3>& getFaceAxes() const { ensureCacheUpdated(); return faceAxesCached; }
     const std::vector<glm::vec3>& getEdgeDirs() const { ensureCacheUpdated(); return edgeDirsCached; }
     glm::vec3 getWorldCenter() const { ensureCacheUpdated(); return worldCenter; }
+    // Half-edge form of the hull of the vertices, built by setVertices.
+    // Empty when they span no volume, and SAT then falls back to projecting
+    // every vertex on every axis.
+    const ConvexPolyhedron& getPolyhedron() const { return polyhedron; }
+    PolyhedronView getPolyhedronView(const glm::vec3& offset = glm::vec3(0.0f)) const;
+protected:
+    ColliderAABB computeWorldAABB() const override;
+    ConvexShape computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
 private:
     std::vector<glm::vec3> localVertices;
     std::vector<glm::ivec3> triangles;
+    ConvexPolyhedron polyhedron;
     mutable std::vector<glm::vec3> worldVerts;
+    mutable std::vector<glm::vec3> hullVerts;
+    mutable std::vector<glm::vec4> hullPlanes;
     mutable std::vector<glm::vec3> faceAxesCached;
     mutable std::vector<glm::vec3> edgeDirsCached;
     mutable glm::vec3 worldCenter{0.0f};
@@ -121,4 +265,32 @@ private:
     mutable bool cacheValid{false};
 
     void ensureCacheUpdated() const;
-};
\ No newline at end of file
+};
+
+// Capsule along the local Y axis. halfHeight includes the caps, so it matches
+// OBBCollider::halfSize.y for a box of the same height. Contacts come from
+// closest points between the core segment and the other shape.
+class CapsuleCollider : public Collider {
+public:
+    CapsuleCollider(const glm::vec3 position, const glm::vec3 rotation, const std::string& parentName = "", float radius = 0.5f, float halfHeight = 1.0f)
+        : Collider("collision_" + parentName, "", position, rotation, {1.0f, 1.0f, 1.0f}), radius(radius), halfHeight(std::max(halfHeight, radius)) {}
+    ColliderType getColliderType() const override { return ColliderType::Capsule; }
+    bool intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
+    float getRadius() const { return radius; }
+    float getHalfHeight() const { return halfHeight; }
+    // True when turning the parent about its Y axis leaves the capsule where it
+    // is: it sits on that axis and is not tilted.
+    bool isYawInvariant() const {
+        const glm::vec3 p = getPosition();
+        const glm::vec3 r = getRotation();
+        return p.x == 0.0f && p.z == 0.0f && r.x == 0.0f && r.z == 0.0f;
+    }
+
+protected:
+    ColliderAABB computeWorldAABB() const override { return shapeBounds(computeSupportShape(glm::vec3(0.0f), glm::vec3(0.0f))); }
+    ConvexShape computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
+
+private:
+    float radius;
+    float halfHeight;
+};
@@ -0,0 +1,128 @@
+#pragma once
+#include <DynamicAABBTree.h>
+#include <Collider.h>
+#include <ContactCache.h>
+#include <glm/glm.hpp>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Which colliders a query considers. The query acts as a collider on
+// `layer` looking for `mask`, with the same two-way test as canCollideWith.
+// Colliders attached to `ignore` are skipped, e.g. the caster's own body;
+// `accept` can reject more. Shape casts that repeat every step, like a body
+// sweeping around where it stands, can keep each pair's separating axis in
+// `contacts` under (ignore, collider), so the next cast of a pair that stays
+// apart costs two support queries.
+struct QueryFilter {
+    const Entity* ignore = nullptr;
+    uint32_t layer = CollisionLayer::All;
+    uint32_t mask = CollisionLayer::All;
+    bool includeTriggers = false;
+    std::function<bool(const Collider*)> accept;
+    ContactCache* contacts = nullptr;
+
+    bool passes(const Collider* collider) const {
+        if (collider->isTrigger() && !includeTriggers) return false;
+        if ((collider->getCollisionLayer() & mask) == 0 || (collider->getCollisionMask() & layer) == 0) return false;
+        if (ignore && collider->getParent() == ignore) return false;
+        return !accept || accept(collider);
+    }
+};
+
+class CollisionWorld {
+public:
+    static CollisionWorld* getInstance();
+
+    void addCollider(Collider* collider);
+    void removeCollider(Collider* collider);
+    // Pulls the collider's current world bounds into the tree. Cheap when the
+    // collider is still inside its fattened box.
+    void updateCollider(Collider* collider);
+    // Resyncs every collider whose world transform changed since its last update.
+    void refit();
+    // Brings every collider's cached world data up to date before concurrent queries.
+    void prepareQueries() const;
+    // Pushes a collider's layer and trigger flag into the broadphase.
+    void updateFilter(Collider* collider);
+    // Finds what overlaps each trigger and queues enter/stay/exit callbacks,
+    // which dispatchTriggerEvents raises. PhysicsWorld calls both once per
+    // step, after the tree is synced, and wakes what entered or left between.
+    void updateTriggers();
+    void dispatchTriggerEvents();
+    // Calls callback(trigger, other) for every queued enter and exit.
+    template<typename Callback>
+    void forEachTriggerChange(Callback&& callback) const {
+        for (const auto& [pair, event] : pendingEvents) {
+            if (event != TriggerEvent::Stay) callback(pair.first, pair.second);
+        }
+    }
+
+    // Only colliders whose layer is in layerMask are reported.
+    void queryAABB(const ColliderAABB& aabb, std::vector<Collider*>& out, uint32_t layerMask = CollisionLayer::All) const;
+    template<typename Callback>
+    void query(const ColliderAABB& aabb, Callback&& callback) const {
+        query(aabb, CollisionLayer::All, std::forward<Callback>(callback));
+    }
+    template<typename Callback>
+    void query(const ColliderAABB& aabb, uint32_t layerMask, Callback&& callback) const {
+        tree.query(aabb, layerMask, [&](int32_t proxyId) { return callback(tree.getCollider(proxyId)); });
+    }
+
+    // Casts along a direction (normalized internally) up to maxDistance. The
+    // single-hit versions return the closest hit, the *All versions every hit
+    // sorted by distance. Shapes that start overlapping hit at distance 0.
+    // Nothing hit is woken; see PhysicsWorld::wake.
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit, const QueryFilter& filter = {}) const;
+    size_t raycastAll(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<RaycastHit>& hits, const QueryFilter& filter = {}) const;
+    bool sphereCast(const glm::vec3& origin, float radius, const glm::vec3& direction, float maxDistance, RaycastHit& hit, const QueryFilter& filter = {}) const;
+    size_t sphereCastAll(const glm::vec3& origin, float radius, const glm::vec3& direction, float maxDistance, std::vector<RaycastHit>& hits, const QueryFilter& filter = {}) const;
+    // rotation is in degrees, applied like Entity rotations.
+    bool boxCast(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec3& rotation, const glm::vec3& direction, float maxDistance, RaycastHit& hit, const QueryFilter& filter = {}) const;
+    size_t boxCastAll(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec3& rotation, const glm::vec3& direction, float maxDistance, std::vector<RaycastHit>& hits, const QueryFilter& filter = {}) const;
+    bool shapeCast(const ConvexShape& shape, const glm::vec3& direction, float maxDistance, RaycastHit& hit, const QueryFilter& filter = {}) const;
+    size_t shapeCastAll(const ConvexShape& shape, const glm::vec3& direction, float maxDistance, std::vector<RaycastHit>& hits, const QueryFilter& filter = {}) const;
+
+    // Forces a narrowphase for one collider pair, e.g. SAT to validate GJK
+    // results. Auto removes the override.
+    void setNarrowphase(const Collider* a, const Collider* b, Narrowphase mode);
+    Narrowphase getNarrowphase(const Collider& a, const Collider& b) const;
+
+    size_t getColliderCount() const { return colliders.size(); }
+    size_t getTriggerPairCount() const { return triggerPairs.size(); }
+    const DynamicAABBTree& getTree() const { return tree; }
+
+private:
+    CollisionWorld() = default;
+    ~CollisionWorld() = default;
+    CollisionWorld(const CollisionWorld&) = delete;
+    CollisionWorld& operator=(const CollisionWorld&) = delete;
+
+    DynamicAABBTree tree;
+    std::vector<Collider*> colliders;
+    std::map<std::pair<const Collider*, const Collider*>, Narrowphase> narrowphaseOverrides;
+
+    // (trigger, other) pairs overlapping as of the last updateTriggers, in discovery order.
+    using TriggerPair = std::pair<Collider*, Collider*>;
+    enum class TriggerEvent { Enter, Stay, Exit };
+    std::vector<Collider*> triggers;
+    std::vector<TriggerPair> triggerPairs;
+    std::vector<TriggerPair> currentPairs;
+    std::vector<TriggerPair> sortedPairs;
+    std::vector<std::pair<TriggerPair, TriggerEvent>> pendingEvents;
+    // Axes and depths of (trigger, other) pairs near each other.
+    ContactCache triggerContacts;
+
+    bool triggerOverlaps(Collider* trigger, Collider* other);
+    void dropTriggerPairs(Collider* collider);
+    static void raise(Collider* self, Collider* other, TriggerEvent event);
+
+    // Shared by every cast; shape == nullptr casts a ray from origin.
+    size_t cast(const ConvexShape* shape, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const QueryFilter& filter, RaycastHit* closest, std::vector<RaycastHit>* all) const;
+    static ConvexShape boxCastShape(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec3& rotation);
+
+    static std::pair<const Collider*, const Collider*> pairKey(const Collider* a, const Collider* b) {
+        return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+    }
+};
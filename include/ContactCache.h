@@ -0,0 +1,45 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+// What the narrowphase learned about a pair on its last visit. Nothing in
+// here is trusted as is: the axis is only used after checking it still
+// separates the pair, so stale entries cost speed, never correctness.
+// Pairs are keyed by address in the order they are looked up, (a, b), and
+// the axis points from b toward a like every GJK normal.
+class ContactCache {
+public:
+    struct Entry {
+        glm::vec3 axis{0.0f};       // last separating axis, zero if none is known
+        float depth = 0.0f;         // penetration when last found overlapping, else 0
+        glm::mat4 transformA{0.0f}; // world transforms at the time depth was measured
+        glm::mat4 transformB{0.0f};
+        uint64_t lastUsed = 0;
+    };
+
+    // The entry for (a, b), created empty on first use.
+    Entry& at(const void* a, const void* b);
+    // Forgets pairs that were not looked up since the previous call, so the
+    // cache only holds pairs that are actually close.
+    void endStep();
+    // Drops every pair involving key, e.g. a collider about to be destroyed
+    // whose address may be reused.
+    void forget(const void* key);
+    void clear() { entries.clear(); }
+    size_t size() const { return entries.size(); }
+
+private:
+    using Key = std::pair<const void*, const void*>;
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            const size_t a = std::hash<const void*>{}(key.first);
+            return a ^ (std::hash<const void*>{}(key.second) + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2));
+        }
+    };
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    uint64_t step = 1;
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <GJK.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+// One point of contact between two shapes a and b.
+struct ContactPoint {
+    glm::vec3 position{0.0f};   // midway between the two surfaces
+    glm::vec3 normal{0.0f};     // from b toward a, like every GJK normal
+    float separation = 0.0f;    // negative while the shapes overlap
+    // The pair of features that produced the point, stable while the same
+    // faces, edges or triangles keep touching. 0 when unknown.
+    uint32_t id = 0;
+};
+
+constexpr size_t kMaxManifoldPoints = 4;
+
+// Contact manifold of two boxes within margin of each other: SAT picks the
+// axis of least penetration; a face axis clips the other box's most
+// anti-parallel face against the reference face, an edge axis gives the
+// closest points of the two edges. Returns the number of points written,
+// at most kMaxManifoldPoints.
+size_t collideBoxes(const ConvexShape& a, const ConvexShape& b, float margin, ContactPoint* out);
+
+// A single contact for any other pair: GJK closest points while the shapes
+// are apart, EPA (or the capsule closest points) once they overlap.
+bool collideConvex(const ConvexShape& a, const ConvexShape& b, float margin, ContactPoint& out);
+
+// Keeps at most kMaxManifoldPoints of points[0, count): the deepest, then
+// the ones spanning the largest area, which holds a resting box steadiest.
+// Returns the new count.
+size_t reduceContacts(ContactPoint* points, size_t count);
@@ -0,0 +1,50 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class ConvexCollider;
+class Entity;
+class Model;
+
+// A convex piece of a collision mesh, in the mesh's own space, with
+// triangles wound to face outward.
+struct ConvexHull {
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices;
+};
+
+struct DecompositionSettings {
+    uint32_t maxHulls = 16;
+    uint32_t maxHullVertices = 32;
+    // Parts are split while a point of their surface lies deeper inside their
+    // hull than this share of the mesh's bounding diagonal.
+    float maxConcavity = 0.01f;
+    // Split planes tried along each axis of a part's bounds.
+    uint32_t planesPerAxis = 8;
+    // Every surface point is also pushed this far behind its face, so open
+    // surfaces such as terrain become solid slabs rather than flat hulls.
+    float thickness = 0.5f;
+};
+
+// Approximate convex decomposition in the spirit of V-HACD. The part with the
+// deepest concavity is cut by whichever axis-aligned plane leaves the two
+// halves least concave, until every part is convex enough or the hull
+// budget is spent. Triangles are clipped at the cut, so neighbouring hulls
+// meet without overlapping. Concavity is how far a surface point can travel
+// along its normal before leaving its part's hull, which works for open
+// meshes as well as closed ones.
+std::vector<ConvexHull> decomposeConvex(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const DecompositionSettings& settings = {});
+
+// Incremental hull that always adds the point farthest outside, stopping
+// after maxVertices. Empty when the points span no volume.
+ConvexHull buildConvexHull(const std::vector<glm::vec3>& points, uint32_t maxVertices);
+
+// Decomposes model's mesh, or reads the result of an earlier run from
+// "<asset>.hulls" beside the asset. The file records a hash of the mesh and
+// settings, so it is rebuilt whenever either changes.
+std::vector<ConvexHull> loadConvexDecomposition(const Model& model, const DecompositionSettings& settings = {});
+
+// Adds one ConvexCollider per hull under parent, each with its own
+// broadphase proxy.
+std::vector<ConvexCollider*> attachConvexHulls(Entity* parent, const std::vector<ConvexHull>& hulls);
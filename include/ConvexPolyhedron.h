@@ -0,0 +1,48 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Convex hull in half-edge form for the separating-axis test. Coplanar
+// triangles are merged into one face, so every face normal is unique and
+// every edge is a real crease between two faces. Twins are stored side by
+// side: the twin of edge e is e ^ 1.
+struct ConvexPolyhedron {
+    struct HalfEdge {
+        uint32_t origin = 0;
+        uint32_t next = 0;      // following edge around the face, counter-clockwise from outside
+        uint32_t face = 0;
+    };
+    std::vector<glm::vec3> vertices;
+    std::vector<HalfEdge> edges;
+    std::vector<glm::vec4> planes;          // outward unit normal and offset of each face
+    std::vector<uint32_t> vertexEdges;      // an edge leaving each vertex
+
+    // Hull of points. False, and left empty, when they span no volume.
+    bool build(const std::vector<glm::vec3>& points);
+    void clear();
+    bool empty() const { return planes.empty(); }
+    // Writes vertices.size() vertices and planes.size() planes under transform.
+    void transform(const glm::mat4& transform, glm::vec3* outVertices, glm::vec4* outPlanes) const;
+};
+
+// A polyhedron placed in the world: its topology with world-space vertices
+// and planes, all moved by offset.
+struct PolyhedronView {
+    const ConvexPolyhedron* shape = nullptr;
+    const glm::vec3* vertices = nullptr;
+    const glm::vec4* planes = nullptr;
+    glm::vec3 center{0.0f};     // any interior point, before offset
+    glm::vec3 offset{0.0f};
+};
+
+// Vertex furthest along direction, found by walking from start to whichever
+// neighbour lies further until none does.
+uint32_t polyhedronSupport(const PolyhedronView& view, const glm::vec3& direction, uint32_t start = 0);
+
+// Largest separation between a and b over the candidate axes, with the axis
+// (unit length, from a toward b); negative when they overlap. Face axes ask
+// a support query of the other hull, and an edge pair is only tried when
+// its arcs cross on the Gauss map, i.e. it forms a face of the Minkowski
+// difference. Stops at the first axis that separates.
+float polyhedronSeparation(const PolyhedronView& a, const PolyhedronView& b, glm::vec3& axis);
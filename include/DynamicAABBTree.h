@@ -0,0 +1,183 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+class Collider;
+
+struct ColliderAABB {
+    glm::vec3 min{0.0f};
+    glm::vec3 max{0.0f};
+};
+
+// Bounding volume hierarchy over fattened collider bounds. Leaves are only
+// reinserted when a collider leaves its fat box, so slow or static colliders
+// cost nothing per frame and queries descend in O(log N).
+class DynamicAABBTree {
+public:
+    static constexpr int32_t kNullNode = -1;
+    static constexpr float kAABBMargin = 0.1f;
+    static constexpr float kDisplacementMultiplier = 4.0f;
+    static constexpr uint32_t kAllLayers = 0xFFFFFFFFu;
+
+    DynamicAABBTree() = default;
+
+    // layers are the collider's collision layer bits; internal nodes keep the
+    // union of their subtree so masked queries skip whole branches.
+    int32_t createProxy(const ColliderAABB& aabb, Collider* collider, uint32_t layers = kAllLayers);
+    void destroyProxy(int32_t proxyId);
+    bool moveProxy(int32_t proxyId, const ColliderAABB& aabb, const glm::vec3& displacement = glm::vec3(0.0f));
+    void setProxyLayers(int32_t proxyId, uint32_t layers);
+    void clear();
+
+    Collider* getCollider(int32_t proxyId) const { return nodes[static_cast<size_t>(proxyId)].collider; }
+    const ColliderAABB& getFatAABB(int32_t proxyId) const { return nodes[static_cast<size_t>(proxyId)].aabb; }
+    int32_t getProxyCount() const { return proxyCount; }
+    int32_t getHeight() const { return root == kNullNode ? 0 : nodes[static_cast<size_t>(root)].height; }
+
+    // Calls callback(proxyId) for every leaf whose fat box overlaps aabb and
+    // whose layers intersect layerMask. Returning false from the callback stops the traversal.
+    template<typename Callback>
+    void query(const ColliderAABB& aabb, Callback&& callback) const {
+        query(aabb, kAllLayers, std::forward<Callback>(callback));
+    }
+    template<typename Callback>
+    void query(const ColliderAABB& aabb, uint32_t layerMask, Callback&& callback) const {
+        if (root == kNullNode) return;
+        TraversalStack stack;
+        stack.push(root);
+        while (!stack.empty()) {
+            int32_t nodeId = stack.pop();
+            const Node& node = nodes[static_cast<size_t>(nodeId)];
+            if ((node.layers & layerMask) == 0 || !overlaps(node.aabb, aabb)) continue;
+            if (node.isLeaf()) {
+                if (!callback(nodeId)) return;
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    // Calls callback(proxyId, maxDistance) for every leaf whose fat box, grown
+    // by extent on each side, the segment origin + t * direction (t in
+    // [0, maxDistance]) passes through. The callback returns the new maximum,
+    // so closest-hit queries clip the segment as they go; a negative value stops.
+    template<typename Callback>
+    void rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const glm::vec3& extent, Callback&& callback) const {
+        rayCast(origin, direction, maxDistance, extent, kAllLayers, std::forward<Callback>(callback));
+    }
+    template<typename Callback>
+    void rayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const glm::vec3& extent, uint32_t layerMask, Callback&& callback) const {
+        if (root == kNullNode) return;
+        const glm::vec3 invDirection = inverseDirection(direction);
+        TraversalStack stack;
+        stack.push(root);
+        while (!stack.empty()) {
+            int32_t nodeId = stack.pop();
+            const Node& node = nodes[static_cast<size_t>(nodeId)];
+            if ((node.layers & layerMask) == 0) continue;
+            const ColliderAABB grown{node.aabb.min - extent, node.aabb.max + extent};
+            float tEnter = 0.0f;
+            if (!rayIntersects(grown, origin, invDirection, maxDistance, tEnter)) continue;
+            if (node.isLeaf()) {
+                maxDistance = callback(nodeId, maxDistance);
+                if (maxDistance < 0.0f) return;
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    static bool overlaps(const ColliderAABB& a, const ColliderAABB& b) {
+        if (a.max.x < b.min.x || a.min.x > b.max.x) return false;
+        if (a.max.y < b.min.y || a.min.y > b.max.y) return false;
+        if (a.max.z < b.min.z || a.min.z > b.max.z) return false;
+        return true;
+    }
+    // Slab test of origin + t * d against box for t in [0, maxDistance]; invDirection is 1 / d
+    // as returned by inverseDirection. tEnter is 0 when the origin is inside.
+    static bool rayIntersects(const ColliderAABB& box, const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, float& tEnter) {
+        const glm::vec3 t0 = (box.min - origin) * invDirection;
+        const glm::vec3 t1 = (box.max - origin) * invDirection;
+        const glm::vec3 tNear = glm::min(t0, t1);
+        const glm::vec3 tFar = glm::max(t0, t1);
+        tEnter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        const float tExit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+        return tEnter <= tExit;
+    }
+    // Axis-parallel components map to a huge finite slope so slab tests never see 0 * inf.
+    static glm::vec3 inverseDirection(const glm::vec3& d) {
+        glm::vec3 inv;
+        for (int i = 0; i < 3; ++i) {
+            inv[i] = std::abs(d[i]) > 1e-12f ? 1.0f / d[i] : (d[i] < 0.0f ? -1e12f : 1e12f);
+        }
+        return inv;
+    }
+    static bool contains(const ColliderAABB& outer, const ColliderAABB& inner) {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+               outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+    }
+    static ColliderAABB combine(const ColliderAABB& a, const ColliderAABB& b) {
+        return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+    }
+    static float surfaceArea(const ColliderAABB& a) {
+        glm::vec3 d = a.max - a.min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+private:
+    struct Node {
+        ColliderAABB aabb;
+        Collider* collider = nullptr;
+        uint32_t layers = 0;        // leaf: collider layers, interior: union of children
+        int32_t parent = kNullNode; // next free node while on the free list
+        int32_t child1 = kNullNode;
+        int32_t child2 = kNullNode;
+        int32_t height = -1;        // 0 for leaves, -1 for free nodes
+        bool isLeaf() const { return child1 == kNullNode; }
+    };
+
+    // Fixed-size stack for traversals so queries never touch the heap for
+    // reasonably balanced trees; spills to a vector for pathological ones.
+    class TraversalStack {
+    public:
+        void push(int32_t v) {
+            if (count < inlineStack.size()) {
+                inlineStack[count++] = v;
+            } else {
+                overflow.push_back(v);
+            }
+        }
+        int32_t pop() {
+            if (!overflow.empty()) {
+                int32_t v = overflow.back();
+                overflow.pop_back();
+                return v;
+            }
+            return inlineStack[--count];
+        }
+        bool empty() const { return count == 0 && overflow.empty(); }
+    private:
+        std::array<int32_t, 128> inlineStack{};
+        size_t count = 0;
+        std::vector<int32_t> overflow;
+    };
+
+    std::vector<Node> nodes;
+    int32_t root = kNullNode;
+    int32_t freeList = kNullNode;
+    int32_t proxyCount = 0;
+
+    int32_t allocateNode();
+    void freeNode(int32_t nodeId);
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    int32_t balance(int32_t nodeId);
+    void refitAncestors(int32_t nodeId);
+};
@@ -10,51 +10,69 @@
 #include <ShaderManager.h>
 #include <Renderer.h>
 #include <Frustrum.h>
+#include <EntityStore.h>
+#include <EntityPool.h>
 #include <cfloat>
 
 class Model;
 
 class Entity {
 public:
-    Entity(std::string name, std::string shader, glm::vec3 position, glm::vec3 rotation, glm::vec3 scale = glm::vec3(1.0f), std::vector<std::string> textures = {}) : name(std::move(name)), shader(std::move(shader)), position(position), rotation(rotation), scale(scale), textures(std::move(textures)) {
+    Entity(std::string name, std::string shader, glm::vec3 position, glm::vec3 rotation, glm::vec3 scale = glm::vec3(1.0f), std::vector<std::string> textures = {}) : name(std::move(name)), shader(std::move(shader)), textures(std::move(textures)) {
+        storeId = EntityStore::getInstance()->create(this, position, rotation, scale, EntityStore::renderPassFor(this->shader));
         loadTextures();
         updateWorldTransform();
     }
-    ~Entity() {
+    virtual ~Entity() {
         destroyUniformBuffers();
         for (auto& child : children) {
             delete child;
         }
         children.clear();
+        EntityStore::getInstance()->destroy(storeId);
     }
     virtual void update(float deltaTime) {}
 
+    // Every entity type lives in EntityPool; the virtual destructor hands delete the real size.
+    static void* operator new(std::size_t size) { return EntityPool::getInstance()->allocate(size); }
+    static void operator delete(void* block, std::size_t size) { EntityPool::getInstance()->deallocate(block, size); }
+
     void addChild(Entity* child);
     void removeChild(Entity* child);
     void moveToParent(Entity* newParent);
 
-    glm::vec3 getPosition() const { return position; }
-    void setPosition(const glm::vec3& pos) { position = pos; }
-    glm::vec3 getRotation() const { return rotation; }
-    void setRotation(const glm::vec3& rot) { rotation = rot; }
-    glm::vec3 getScale() const { return scale; }
-    void setScale(const glm::vec3& s) { scale = s; }
+    glm::vec3 getPosition() const { return EntityStore::getInstance()->positions[storeId]; }
+    void setPosition(const glm::vec3& pos) { setLocal(EntityStore::getInstance()->positions[storeId], pos); }
+    glm::vec3 getRotation() const { return EntityStore::getInstance()->rotations[storeId]; }
+    void setRotation(const glm::vec3& rot) { setLocal(EntityStore::getInstance()->rotations[storeId], rot); }
+    glm::vec3 getScale() const { return EntityStore::getInstance()->scales[storeId]; }
+    void setScale(const glm::vec3& s) { setLocal(EntityStore::getInstance()->scales[storeId], s); }
     std::string getName() const { return name; }
     std::string getShader() const { return shader; }
-    bool isActive() const { return active; }
-    void setActive(bool state) { active = state; }
-    Model* getModel() const { return model; }
-    void setModel(Model* m) { model = m; }
+    bool isActive() const { return EntityStore::getInstance()->active[storeId] != 0; }
+    void setActive(bool state) { EntityStore::getInstance()->active[storeId] = state ? 1 : 0; }
+    Model* getModel() const { return EntityStore::getInstance()->models[storeId]; }
+    void setModel(Model* m) { EntityStore::getInstance()->models[storeId] = m; }
     std::vector<Entity*>& getChildren() { return children; }
     Entity* getChild(const std::string& name);
-    Entity* getParent() const { return parent; }
+    Entity* getParent() const;
+    // This entity's slot in EntityStore; changes when the store sorts.
+    EntityStore::Id getStoreId() const { return storeId; }
+    EntityHandle getHandle() const { return handle; }
 
+    // As of the last updateWorldTransform; rotation and scale are decomposed on each call.
     glm::vec3 getWorldPosition();
     glm::vec3 getWorldRotation();
     glm::vec3 getWorldScale();
     glm::mat4 getWorldTransform();
 
-    void updateWorldTransform();
+    // Recomputes the world transform if this entity or an ancestor moved since
+    // the last update, bringing stale ancestors up to date first.
+    void updateWorldTransform() {
+        if (EntityStore::getInstance()->transformDirty[storeId]) {
+            refreshWorldTransform();
+        }
+    }
 
     void loadTextures();
     const std::vector<VkDescriptorSet>& getDescriptorSets() const { return descriptorSets; }
@@ -62,6 +80,13 @@ public:
 
     AABB getWorldBounds(const glm::mat4& worldTransform) const;
 
+protected:
+    // Called after this entity has been attached to / detached from a parent.
+    virtual void onAttached() {}
+    virtual void onDetached() {}
+    // Called by updateWorldTransform when the world transform actually changed.
+    virtual void onWorldTransformChanged() {}
+
 private:
     std::string name;
     std::string shader = "gbuffer";
@@ -70,17 +95,20 @@ private:
     std::vector<VkBuffer> uniformBuffers;
     std::vector<VkDeviceMemory> uniformBuffersMemory;
     size_t uniformBufferStride = 0;
-    glm::vec3 position = glm::vec3(0.0f);
-    glm::vec3 rotation = glm::vec3(0.0f);
-    glm::vec3 scale = glm::vec3(1.0f);
-    glm::vec3 worldPosition = glm::vec3(0.0f);
-    glm::vec3 worldRotation = glm::vec3(0.0f);
-    glm::vec3 worldScale = glm::vec3(1.0f);
-    glm::mat4 worldTransform = glm::mat4(1.0f);
     std::vector<Entity*> children;
-    Entity* parent = nullptr;
-    Model* model = nullptr;
-    bool active = true;
+    // Transform, hierarchy and render state live in EntityStore under this slot.
+    EntityStore::Id storeId = EntityStore::kNone;
+    EntityHandle handle;
+
+    friend class EntityStore;
+
+    void setLocal(glm::vec3& field, const glm::vec3& value) {
+        if (field == value) return;
+        field = value;
+        markTransformDirty();
+    }
+    void markTransformDirty();
+    void refreshWorldTransform();
 
     void ensureUniformBuffers(Renderer* renderer, int vertexBindings);
 
@@ -1,7 +1,9 @@
 #pragma once
 #include <map>
 #include <string>
+#include <vector>
 #include <Entity.h>
+#include <EntityStore.h>
 
 class EntityManager {
 public:
@@ -14,8 +16,10 @@ public:
 
     void addEntity(const std::string& name, Entity* entity) {
         entities[name] = entity;
+        rootsChanged = true;
     }
 
+    // Name lookups walk the map; look a name up once and keep the handle.
     Entity* getEntity(const std::string& name) {
         if (entities.find(name) != entities.end()) {
             return entities[name];
@@ -23,16 +27,54 @@ public:
         return nullptr;
     }
 
+    EntityHandle findEntity(const std::string& name) {
+        Entity* entity = getEntity(name);
+        return entity ? entity->getHandle() : EntityHandle{};
+    }
+
+    // nullptr once the entity was removed or deleted.
+    Entity* getEntity(EntityHandle handle) const {
+        return EntityStore::getInstance()->resolve(handle);
+    }
+
     void removeEntity(const std::string& name) {
         if (entities.find(name) == entities.end()) return;
         delete entities[name];
         entities.erase(name);
+        rootsChanged = true;
     }
 
+    // The frame's entity pass: brings every entity's world transform up to
+    // date and updates it, parents before children, in sortScene order.
+    // Entities spawned during the pass land past the scanned slots and start
+    // next frame.
     void updateAll(float deltaTime) {
-        for (auto& pair : entities) {
-            pair.second->update(deltaTime);
+        EntityStore* store = EntityStore::getInstance();
+        const size_t count = sortScene();
+        for (size_t slot = 0; slot < count; ++slot) {
+            if (Entity* entity = store->getOwner(slot)) {
+                entity->updateWorldTransform();
+                entity->update(deltaTime);
+            }
+        }
+    }
+
+    // Sorts the scene to the front of EntityStore if anything changed since
+    // the last call and returns how many slots it fills. Slots [0, count) are
+    // then the root entities in name order, each followed by its subtree.
+    size_t sortScene() {
+        EntityStore* store = EntityStore::getInstance();
+        if (!rootsChanged && !store->isSceneDirty()) return sceneCount;
+        std::vector<Entity*> roots;
+        roots.reserve(entities.size());
+        for (auto& [name, entity] : entities) {
+            if (entity->getParent() == nullptr) {
+                roots.push_back(entity);
+            }
         }
+        sceneCount = store->sortScene(roots);
+        rootsChanged = false;
+        return sceneCount;
     }
 
     void shutdown() {
@@ -40,6 +82,7 @@ public:
             delete entity;
         }
         entities.clear();
+        rootsChanged = true;
     }
 
     static EntityManager* getInstance() {
@@ -49,4 +92,6 @@ public:
 
 private:
     std::map<std::string, Entity*> entities;
+    size_t sceneCount = 0;
+    bool rootsChanged = false;
 };
\ No newline at end of file
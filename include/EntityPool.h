@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Memory behind every Entity, collider and prefab part. Entity routes its
+// operator new and delete here, so each concrete type draws fixed-size
+// blocks from its own size class: a class's blocks are carved from shared
+// chunks and recycled through a free list, and spawning or despawning an
+// entity only pushes or pops that list. Types too large for a size class
+// fall back to the global allocator.
+//
+// Chunks are only handed back together, once every block in them is free:
+// SceneManager calls releaseChunks after tearing a scene down. Entities are
+// created and deleted on the main thread only, so nothing here is locked.
+class EntityPool {
+public:
+    static EntityPool* getInstance();
+
+    void* allocate(size_t size);
+    void deallocate(void* block, size_t size);
+
+    // Frees every chunk in one go, if no pooled block is still in use.
+    // Returns whether it did.
+    bool releaseChunks();
+
+    size_t getLiveCount() const { return live; }
+    size_t getChunkCount() const { return chunks.size(); }
+
+private:
+    EntityPool() = default;
+    ~EntityPool() = default;
+    EntityPool(const EntityPool&) = delete;
+    EntityPool& operator=(const EntityPool&) = delete;
+
+    static constexpr size_t kGranularity = 16;
+    static constexpr size_t kMaxPooledSize = 4096;
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::array<FreeBlock*, kMaxPooledSize / kGranularity> freeLists{};
+    std::vector<void*> chunks;
+    size_t live = 0;
+
+    static size_t sizeClass(size_t size) { return (size + kGranularity - 1) / kGranularity - 1; }
+    void refill(size_t index);
+};
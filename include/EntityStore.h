@@ -0,0 +1,100 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Entity;
+class Model;
+
+// Refers to an entity without owning it. A handle stops resolving once its
+// entity is destroyed, even if the index is later reused by a new entity.
+struct EntityHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const EntityHandle&) const = default;
+};
+
+// Dense home of every entity's transform and render state, one array per
+// field, indexed by the slot an Entity keeps. Entity reads and writes its
+// state through here, so per-frame passes scan these arrays front to back
+// instead of walking the entity tree.
+//
+// sortScene moves the current scene to the front in the order the tree walks
+// used to visit it: each root followed by its descendants, depth first. A
+// parent's slot then always comes before its children's, and a subtree is the
+// run of slots up to its subtree end. Slots only move during a sort, so a
+// pass may create or destroy entities: new ones go on the end and dead ones
+// leave a hole until the next sort packs the arrays.
+class EntityStore {
+public:
+    using Id = uint32_t;
+    static constexpr Id kNone = UINT32_MAX;
+
+    // Which of the renderer's geometry passes draws the entity, from its shader.
+    enum class RenderPass : uint8_t { None, GBuffer, Skybox };
+    static RenderPass renderPassFor(const std::string& shader);
+
+    static EntityStore* getInstance();
+
+    Id create(Entity* owner, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale, RenderPass pass);
+    void destroy(Id id);
+    void setParent(Id id, Id parent);
+
+    // The entity handle refers to, or nullptr once it was destroyed.
+    Entity* resolve(EntityHandle handle) const {
+        if (handle.index >= handleOwners.size() || handleGenerations[handle.index] != handle.generation) return nullptr;
+        return handleOwners[handle.index];
+    }
+
+    // Moves roots and their subtrees to the front, packs out holes and
+    // returns how many slots the scene fills.
+    size_t sortScene(const std::vector<Entity*>& roots);
+    // True once an entity was created, destroyed or reparented since the last sort.
+    bool isSceneDirty() const { return sceneDirty; }
+
+    size_t size() const { return owners.size(); }
+    // nullptr for the hole a destroyed entity left.
+    Entity* getOwner(size_t slot) const { return owners[slot]; }
+    Id getParent(size_t slot) const { return parents[slot]; }
+    // One past the last slot of the subtree rooted at slot; valid for scene slots after a sort.
+    size_t getSubtreeEnd(size_t slot) const { return subtreeEnds[slot]; }
+    bool isActive(size_t slot) const { return active[slot] != 0; }
+    Model* getModel(size_t slot) const { return models[slot]; }
+    RenderPass getRenderPass(size_t slot) const { return renderPasses[slot]; }
+    const glm::mat4& getWorldTransform(size_t slot) const { return worldTransforms[slot]; }
+
+private:
+    friend class Entity;
+
+    EntityStore() = default;
+    ~EntityStore() = default;
+    EntityStore(const EntityStore&) = delete;
+    EntityStore& operator=(const EntityStore&) = delete;
+
+    std::vector<Entity*> owners;
+    std::vector<Id> parents;
+    std::vector<Id> subtreeEnds;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<glm::mat4> worldTransforms;
+    // Set when the slot's world transform is stale. A stale entity's
+    // descendants are always stale too, so marking can stop at the first one.
+    std::vector<uint8_t> transformDirty;
+    std::vector<Model*> models;
+    std::vector<uint8_t> active;
+    std::vector<RenderPass> renderPasses;
+    bool sceneDirty = false;
+
+    // Handle index -> owner. Unlike slots, indices never move; a destroyed
+    // entity's index gets a new generation and is handed out again.
+    std::vector<Entity*> handleOwners;
+    std::vector<uint32_t> handleGenerations;
+    std::vector<uint32_t> freeHandles;
+
+    template <typename T>
+    static void permute(std::vector<T>& column, const std::vector<Id>& order);
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// Convex shape in world space, described only by its support mapping so GJK
+// and EPA never need face or edge lists.
+struct ConvexShape {
+    enum class Kind {
+        Box,
+        Points,
+        Sphere,
+        Capsule
+    };
+    Kind kind = Kind::Points;
+    glm::vec3 center{0.0f};
+
+    // Box
+    glm::vec3 axes[3] = { glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+    glm::vec3 halfExtents{0.0f};
+
+    // Points (world-space vertices, translated by offset)
+    const glm::vec3* points = nullptr;
+    size_t pointCount = 0;
+    glm::vec3 offset{0.0f};
+
+    // Sphere around center; a zero radius is a single point
+    float radius = 0.0f;
+
+    // Capsule: the segment center +- axes[1] * halfLength, grown by radius
+    float halfLength = 0.0f;
+
+    glm::vec3 support(const glm::vec3& dir) const;
+    void translate(const glm::vec3& delta) {
+        center += delta;
+        offset += delta;
+    }
+};
+
+struct GJKResult {
+    bool intersecting = false;
+    float distance = 0.0f;      // separation when not intersecting
+    glm::vec3 pointA{0.0f};     // closest (or deepest) point on A
+    glm::vec3 pointB{0.0f};     // closest (or deepest) point on B
+    glm::vec3 normal{0.0f};     // direction that pushes A out of B
+    float penetration = 0.0f;   // depth along normal when intersecting
+};
+
+// Closest points between two convex shapes. Returns true if they overlap, in
+// which case only `intersecting` is meaningful. `hint` is an optional first
+// search direction from b toward a, e.g. a normal from an earlier query.
+bool gjkDistance(const ConvexShape& a, const ConvexShape& b, GJKResult& out, const glm::vec3* hint = nullptr);
+
+// GJK followed by EPA: fills normal/penetration when the shapes overlap.
+bool gjkPenetration(const ConvexShape& a, const ConvexShape& b, GJKResult& out);
+
+struct ShapeCastResult {
+    float distance = 0.0f;      // travel along the cast direction at first contact
+    glm::vec3 point{0.0f};      // contact point on the target
+    glm::vec3 normal{0.0f};     // target surface normal, facing the moving shape
+};
+
+// Whether `axis` (pointing from b toward a) separates the shapes: all of a
+// lies strictly beyond all of b along it. One support query per shape.
+bool separatedAlong(const ConvexShape& a, const ConvexShape& b, const glm::vec3& axis);
+// The same for a moved anywhere up to maxDistance along `direction`.
+bool sweptSeparatedAlong(const ConvexShape& a, const glm::vec3& direction, float maxDistance, const ConvexShape& b, const glm::vec3& axis);
+
+// Sweeps `moving` along the unit `direction` until it touches `target` (GJK
+// ray cast). A shape that starts overlapping hits at distance 0 with the EPA normal.
+// `separatingAxis`, when given, carries the pair's last separating normal
+// between calls: if it still separates the whole sweep the cast ends after
+// two support queries, otherwise it seeds GJK. It is updated on return.
+bool gjkCast(const ConvexShape& moving, const glm::vec3& direction, float maxDistance, const ConvexShape& target, ShapeCastResult& out, glm::vec3* separatingAxis = nullptr);
+
+// Time of impact of two shapes that translate over one step, a by motionA
+// and b by motionB. out.distance is the fraction of the step at first
+// contact, and point is where b is at that time. Conservative advancement
+// on the relative motion, so neither shape can pass through the other
+// however far they move.
+bool timeOfImpact(const ConvexShape& a, const glm::vec3& motionA, const ConvexShape& b, const glm::vec3& motionB, ShapeCastResult& out);
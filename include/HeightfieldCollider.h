@@ -0,0 +1,102 @@
+#pragma once
+#include <Collider.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Static terrain as a regular grid of 16-bit height samples, two bytes per
+// sample against the vertices, triangles, edge flags and BVH a MeshCollider
+// would need for the same surface. The grid lies in the local XZ plane,
+// centred on the collider, with heights along local Y. Every cell is split
+// into two triangles along its (i, j)-(i + 1, j + 1) diagonal.
+//
+// Queries go straight to the cells under a shape's footprint, and the
+// surface height at any point is a single cell lookup. Triangles only push
+// upward, so a shape whose centre has sunk below the surface is lifted back
+// out instead of being pushed through.
+class HeightfieldCollider : public Collider {
+public:
+    HeightfieldCollider(const glm::vec3 position, const glm::vec3 rotation, const std::string& parentName = "")
+        : Collider("collision_" + parentName, "", position, rotation, {1.0f, 1.0f, 1.0f}) {}
+    ColliderType getColliderType() const override { return ColliderType::Heightfield; }
+    bool isConcave() const override { return true; }
+    bool intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
+    void prepareQueries() const override { ensureCacheUpdated(); }
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const override;
+    bool shapeCast(const ConvexShape& shape, const glm::vec3& direction, float maxDistance, RaycastHit& hit, glm::vec3* separatingAxis = nullptr) const override;
+    bool collideShape(const ConvexShape& shape, const ColliderAABB& shapeBounds, CollisionMTV& out, std::vector<MeshContact>* contacts = nullptr) const override;
+
+    // Samples are row-major: `columns` along local X, then `rows` along local
+    // Z, `spacing` apart. Sample s stands at height s * heightScale + heightOffset.
+    void setHeights(uint32_t columns, uint32_t rows, std::vector<uint16_t> samples, const glm::vec2& spacing, float heightScale, float heightOffset = 0.0f);
+    // The same from a grayscale image, one sample per pixel, through
+    // TextureManager::loadHeightmap. Full white is heightRange above heightOffset.
+    bool loadHeightmap(const std::string& path, const glm::vec2& spacing, float heightRange, float heightOffset = 0.0f);
+
+    // Local-space surface height at (x, z), clamped to the grid's edges.
+    float getHeight(float x, float z) const;
+    // Where the surface is straight above or below worldPoint along the
+    // collider's up axis, and its normal there. False off the grid.
+    bool sampleSurface(const glm::vec3& worldPoint, glm::vec3& surfacePoint, glm::vec3& normal) const;
+
+    // Calls callback(triangleIndex) for each triangle of the cells under the
+    // world-space box whose heights reach into it.
+    template<typename Callback>
+    void queryTriangles(const ColliderAABB& worldBox, Callback&& callback) const {
+        if (heights.empty()) return;
+        ensureCacheUpdated();
+        glm::ivec2 first, last;
+        const ColliderAABB box = toLocal(worldBox);
+        if (!cellRange(box, first, last)) return;
+        for (int j = first.y; j <= last.y; ++j) {
+            for (int i = first.x; i <= last.x; ++i) {
+                float low, high;
+                cellHeightRange(i, j, low, high);
+                if (low > box.max.y || high < box.min.y) continue;
+                const uint32_t cell = static_cast<uint32_t>(j) * (columns - 1) + static_cast<uint32_t>(i);
+                callback(cell * 2);
+                callback(cell * 2 + 1);
+            }
+        }
+    }
+
+    void getWorldTriangle(uint32_t triangle, glm::vec3& a, glm::vec3& b, glm::vec3& c) const;
+    size_t getTriangleCount() const { return heights.empty() ? 0 : 2 * static_cast<size_t>(columns - 1) * (rows - 1); }
+    uint32_t getColumns() const { return columns; }
+    uint32_t getRows() const { return rows; }
+
+protected:
+    ColliderAABB computeWorldAABB() const override;
+    // A heightfield has no meaningful support mapping; this is its world bounds.
+    ConvexShape computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
+
+private:
+    // Neighbouring triangles closer than this to coplanar share a "flat" edge.
+    static constexpr float kFlatEdgeCos = 0.98f;
+
+    std::vector<uint16_t> heights;
+    uint32_t columns = 0;
+    uint32_t rows = 0;
+    glm::vec2 spacing{1.0f};
+    float heightScale = 1.0f;
+    float heightOffset = 0.0f;
+    glm::vec2 gridOrigin{0.0f}; // local XZ of sample (0, 0)
+    uint16_t minSample = 0;
+    uint16_t maxSample = 0;
+    mutable glm::mat4 lastWorldTr{0.0f};
+    mutable glm::mat4 inverseWorldTr{1.0f};
+    mutable bool cacheValid{false};
+
+    float sampleHeight(int i, int j) const { return heights[static_cast<size_t>(j) * columns + static_cast<size_t>(i)] * heightScale + heightOffset; }
+    glm::vec3 localVertex(int i, int j) const { return {gridOrigin.x + i * spacing.x, sampleHeight(i, j), gridOrigin.y + j * spacing.y}; }
+    void localTriangle(uint32_t triangle, std::array<glm::vec3, 3>& verts) const;
+    glm::vec3 localNormal(int i, int j, int half) const;
+    uint8_t flatEdges(uint32_t triangle) const;
+    void cellHeightRange(int i, int j, float& low, float& high) const;
+    bool cellRange(const ColliderAABB& localBox, glm::ivec2& first, glm::ivec2& last) const;
+    ColliderAABB localBounds() const;
+    void ensureCacheUpdated() const;
+    ColliderAABB toLocal(const ColliderAABB& worldBox) const;
+};
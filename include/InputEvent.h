@@ -1,3 +1,4 @@
+#pragma once
 struct InputEvent {
     enum class Type {
         KeyPress,
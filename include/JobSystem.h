@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// One thread pool shared by physics, culling, asset loading and anything
+// else that splits work. Every pool thread, plus the main thread, owns a
+// deque: a thread pushes and pops jobs at the back of its own deque, and an
+// idle thread steals from the front of the others'. A thread waiting on a
+// job runs other jobs meanwhile, so jobs may wait on jobs they spawn.
+//
+// Jobs marked MainThread never run on the pool; the main thread runs them
+// while it waits and once a frame from the renderer, so they may call
+// Vulkan. A job can depend on others and only becomes runnable once they
+// have all finished, which is how a continuation is expressed.
+//
+// Every run is timed and totalled under the job's name; see getStats.
+class JobSystem {
+public:
+    enum class Affinity { Any, MainThread };
+
+    struct Job;
+    using JobHandle = std::shared_ptr<Job>;
+
+    struct JobStats {
+        std::string name;
+        size_t runs = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    static JobSystem* getInstance();
+
+    // name must outlive the job; string literals are the usual choice.
+    JobHandle schedule(const char* name, std::function<void()> task, std::initializer_list<JobHandle> dependencies = {}, Affinity affinity = Affinity::Any);
+    bool isDone(const JobHandle& job) const;
+    // Runs other jobs until job has finished.
+    void wait(const JobHandle& job);
+
+    // Calls body(begin, end) on consecutive ranges of at most grain items
+    // covering [0, count), spread over the pool, and returns once all ran.
+    // Work that fits in one grain runs inline with no scheduling at all, so
+    // grain should be about as much work as is worth handing to another thread.
+    void parallelFor(const char* name, size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+    // Runs the MainThread jobs that are ready. Main thread only.
+    void runMainThreadJobs();
+
+    // Replaces the pool with count threads besides the main thread. Call
+    // while no jobs are queued; 0 runs every job on the main thread.
+    void setWorkerCount(size_t count);
+    // Threads that run jobs, counting the main thread.
+    size_t getThreadCount() const { return workers.size() + 1; }
+
+    // Per-name totals since the last reset, longest total first.
+    std::vector<JobStats> getStats() const;
+    // Zeroes the totals but keeps the names seen, so recording them again
+    // does not allocate.
+    void resetStats();
+
+private:
+    JobSystem();
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    struct Timing {
+        size_t runs = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    // Per thread; index 0 is the main thread.
+    struct Queue {
+        mutable std::mutex mutex;
+        std::deque<JobHandle> jobs;
+        std::unordered_map<const char*, Timing> timings;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::mutex mainMutex;
+    std::deque<JobHandle> mainJobs;
+
+    // Jobs sitting in any deque, so idle workers know when to look.
+    std::atomic<size_t> queued{0};
+    std::atomic<bool> running{false};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    void startWorkers(size_t count);
+    void stopWorkers();
+    void workerLoop(size_t index);
+    void enqueue(const JobHandle& job);
+    JobHandle takeJob(size_t index);
+    bool runOne();
+    void run(const JobHandle& job);
+    void record(const char* name, double ms);
+    void finish(const JobHandle& job);
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <Collider.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Static, possibly non-convex triangle soup. Triangles are bucketed into a
+// local-space BVH once when the mesh is set, so queries only touch the
+// triangles under the query bounds.
+class MeshCollider : public Collider {
+public:
+    MeshCollider(const glm::vec3 position, const glm::vec3 rotation, const std::string& parentName = "")
+        : Collider("collision_" + parentName, "", position, rotation, {1.0f, 1.0f, 1.0f}) {}
+    ColliderType getColliderType() const override { return ColliderType::Mesh; }
+    bool isConcave() const override { return true; }
+    bool intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
+    void prepareQueries() const override { ensureCacheUpdated(); }
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const override;
+    // Triangles are too many to cache an axis for; the BVH already rejects
+    // what the sweep cannot reach, so separatingAxis is left alone.
+    bool shapeCast(const ConvexShape& shape, const glm::vec3& direction, float maxDistance, RaycastHit& hit, glm::vec3* separatingAxis = nullptr) const override;
+
+    void setVertices(const std::vector<float>& positions, const std::vector<uint32_t>& indices);
+    void setVerticesInterleaved(const std::vector<float>& interleaved, size_t strideFloats, size_t positionOffsetFloats, const std::vector<uint32_t>& indices);
+
+    bool collideShape(const ConvexShape& shape, const ColliderAABB& shapeBounds, CollisionMTV& out, std::vector<MeshContact>* contacts = nullptr) const override;
+
+    // Calls callback(triangleIndex) for each triangle whose bounds overlap the world-space box.
+    template<typename Callback>
+    void queryTriangles(const ColliderAABB& worldBox, Callback&& callback) const {
+        if (nodes.empty()) return;
+        ensureCacheUpdated();
+        const ColliderAABB box = toLocal(worldBox);
+        std::array<uint32_t, kMaxBVHDepth> stack;
+        size_t count = 0;
+        stack[count++] = 0;
+        while (count > 0) {
+            const uint32_t nodeIndex = stack[--count];
+            const BVHNode& node = nodes[nodeIndex];
+            if (!DynamicAABBTree::overlaps(node.bounds, box)) continue;
+            if (node.count > 0) {
+                for (uint32_t i = node.start; i < node.start + node.count; ++i) {
+                    callback(i);
+                }
+                continue;
+            }
+            stack[count++] = node.start;
+            stack[count++] = nodeIndex + 1;
+        }
+    }
+
+    void getWorldTriangle(uint32_t triangle, glm::vec3& a, glm::vec3& b, glm::vec3& c) const;
+    size_t getTriangleCount() const { return triangles.size(); }
+    size_t getNodeCount() const { return nodes.size(); }
+
+protected:
+    ColliderAABB computeWorldAABB() const override;
+    // A mesh has no meaningful support mapping; this is its world bounds.
+    ConvexShape computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const override;
+
+private:
+    static constexpr size_t kMaxBVHDepth = 64;
+    static constexpr uint32_t kMaxLeafTriangles = 4;
+    // Neighbouring triangles closer than this to coplanar share a "flat" edge.
+    static constexpr float kFlatEdgeCos = 0.98f;
+
+    // Leaves have count > 0 and own triangles [start, start + count). Interior
+    // nodes keep their left child right after themselves and the right child at `start`.
+    struct BVHNode {
+        ColliderAABB bounds;
+        uint32_t start = 0;
+        uint32_t count = 0;
+    };
+
+    std::vector<glm::vec3> localVertices;
+    std::vector<glm::uvec3> triangles;
+    std::vector<uint8_t> flatEdges;   // bit e: edge (e, e+1) is shared with a coplanar neighbour
+    std::vector<BVHNode> nodes;
+    mutable std::vector<glm::vec3> worldVerts;
+    mutable glm::mat4 lastWorldTr{0.0f};
+    mutable glm::mat4 inverseWorldTr{1.0f};
+    mutable bool cacheValid{false};
+
+    void buildBVH();
+    void buildEdgeFlags();
+    uint32_t buildNode(const std::vector<glm::vec3>& centroids, std::vector<uint32_t>& order, uint32_t begin, uint32_t end, uint32_t depth);
+    void ensureCacheUpdated() const;
+    ColliderAABB toLocal(const ColliderAABB& worldBox) const;
+};
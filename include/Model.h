@@ -3,17 +3,22 @@
 #include <vector>
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
+#include <cstddef>
 #include <cstdint>
 
 class Renderer;
 
 class Model {
 public:
+    // Interleaved vertex layout: position (3) + normal (3) + uv (2) + tangent (3).
+    static constexpr std::size_t kFloatsPerVertex = 11;
+
     Model(std::string name)
         : name(std::move(name)) {};
     ~Model() = default;
     void loadFromFile(const std::string& path);
     const std::string& getName() const { return name; }
+    const std::string& getSourcePath() const { return sourcePath; }
     VkBuffer getVertexBuffer() const { return vertexBuffer; }
     VkBuffer getIndexBuffer() const { return indexBuffer; }
     const uint32_t getIndexCount() const { return static_cast<uint32_t>(indices.size()); }
@@ -24,6 +29,7 @@ public:
 private:
     Renderer* renderer = nullptr;
     std::string name;
+    std::string sourcePath;
     std::vector<float> vertices;
     std::vector<uint32_t> indices;
     VkBuffer vertexBuffer = VK_NULL_HANDLE;
@@ -0,0 +1,61 @@
+#pragma once
+#include <InputEvent.h>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Records everything that drives the simulation so a session can be re-run
+// exactly: the scene, the rand() seed, the physics settings and the
+// transform of every entity when the scene started, then per frame the input
+// batches dispatched and the frame's delta. Each frame also stores a hash of
+// every entity's transform, so a replay can tell the first frame it drifted.
+//
+// A replay loads the same scene, then feeds the recorded input and deltas
+// straight into the simulation in a tight loop without drawing, and reports
+// per-frame timings. Replays match bit-for-bit on the same build and thread
+// count; after a physics change the hashes are expected to diverge, and the
+// timings still compare the two builds on an identical input stream.
+class PhysicsRecorder {
+public:
+    static PhysicsRecorder* getInstance();
+
+    // Records every scene started from now on to path, each one replacing
+    // the last, so the file ends up holding the final scene played.
+    void recordTo(const std::string& path);
+    void stopRecording();
+    bool isRecording() const { return !recordPath.empty(); }
+
+    // Makes Renderer::run replay path instead of running interactively.
+    void replayFrom(const std::string& path);
+    bool isReplaying() const { return !replayPath.empty(); }
+    // Runs the replay; false if the file could not be read, the scene no
+    // longer builds the recorded entities, or a frame's hash differed.
+    bool runReplay();
+    bool replayMatched() const { return matched; }
+
+    // SceneManager calls this once a scene has been built.
+    void onSceneStarted(int sceneId);
+    // InputManager calls this with each batch it dispatches from the window.
+    void recordInput(const std::vector<InputEvent>& events, bool cursorLocked);
+    // The renderer calls this after simulating a frame of frameDelta seconds.
+    void recordFrame(float frameDelta);
+
+private:
+    PhysicsRecorder() = default;
+    ~PhysicsRecorder() = default;
+    PhysicsRecorder(const PhysicsRecorder&) = delete;
+    PhysicsRecorder& operator=(const PhysicsRecorder&) = delete;
+
+    struct InputBatch {
+        bool cursorLocked = false;
+        std::vector<InputEvent> events;
+    };
+
+    std::string recordPath;
+    std::string replayPath;
+    std::ofstream out;
+    // Batches dispatched since the last recorded frame.
+    std::vector<InputBatch> pending;
+    bool matched = true;
+};
@@ -0,0 +1,138 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <Collider.h>
+#include <RigidBodySolver.h>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Entity;
+class CharacterEntity;
+class Projectile;
+struct QueryFilter;
+
+// Steps every simulated body at a fixed rate, independent of the render
+// frame rate. Leftover frame time stays in an accumulator and is exposed as
+// an interpolation factor so rendering can blend the last two physics states.
+//
+// Each step groups bodies that could touch into islands. Islands resolve on
+// worker threads; the broadphase is synced afterwards in body order, so the
+// result does not depend on how islands were scheduled. Characters then
+// push the rigid bodies they walked into, projectiles move one at a time in
+// launch order, and last the rigid-body solver steps the props.
+//
+// Sleeping bodies are left out of islands, so a step costs as much as its
+// awake bodies. A sleeper wakes when an awake body could reach it during the
+// step, when it is teleported, when something enters or leaves a trigger
+// with it, or when a projectile hits it. Gameplay that hits a body with a
+// CollisionWorld cast wakes it with wake(). Rigid bodies sleep the same way,
+// by island, inside their solver.
+class PhysicsWorld {
+public:
+    static PhysicsWorld* getInstance();
+
+    static constexpr float kDefaultTimestep = 1.0f / 120.0f;
+    static constexpr int kDefaultMaxStepsPerFrame = 8;
+    // Below this many bodies a step runs on the calling thread.
+    static constexpr size_t kMinParallelBodies = 16;
+
+    void addBody(CharacterEntity* body);
+    void removeBody(CharacterEntity* body);
+    void addProjectile(Projectile* projectile);
+    void removeProjectile(Projectile* projectile);
+    RigidBodySolver& getRigidBodies() { return rigidBodies; }
+    const RigidBodySolver& getRigidBodies() const { return rigidBodies; }
+
+    // Runs as many fixed steps as fit in the accumulated time and returns how
+    // many were taken. Time beyond maxStepsPerFrame is dropped so a slow frame
+    // cannot snowball into ever longer ones.
+    int update(float frameDelta);
+
+    // A longer step runs the simulation at a lower rate than rendering, e.g. 1/60 on weak machines.
+    void setTimestep(float seconds);
+    float getTimestep() const { return timestep; }
+    void setMaxStepsPerFrame(int steps);
+    int getMaxStepsPerFrame() const { return maxStepsPerFrame; }
+    // Time carried over to the next update; recordings save it so a replay
+    // starts at the same point within a step.
+    float getAccumulator() const { return accumulator; }
+    void setAccumulator(float seconds);
+
+    // 0 renders the previous physics state, 1 the latest one.
+    float getInterpolationAlpha() const { return alpha; }
+    uint64_t getTick() const { return tick; }
+    size_t getBodyCount() const { return bodies.size(); }
+    size_t getProjectileCount() const { return flights.size(); }
+    size_t getIslandCount() const { return islandRanges.size(); }
+    // Bodies simulated in the last step.
+    size_t getAwakeBodyCount() const { return activeBodies.size(); }
+    bool isBody(const Entity* entity) const { return entity && bodyIndex.count(entity) != 0; }
+    bool isProjectile(const Entity* entity) const { return entity && flightIndex.count(entity) != 0; }
+    bool isRigidBody(const Entity* entity) const { return rigidBodies.isRigidBody(entity); }
+    // Wakes entity if it is a sleeping body or rigid body; anything else is ignored.
+    void wake(const Entity* entity);
+    // Wakes every body whose collider overlaps region, e.g. after moving or
+    // removing level geometry.
+    void wakeBodies(const ColliderAABB& region);
+
+    // Continuous sweep of shape by motion, reported like CollisionWorld's
+    // casts with distance measured along motion. Bodies are hit at their time
+    // of impact against the motion they made in the current step, so fast
+    // movers on either side cannot pass through each other; everything else
+    // is taken where it is. A sphere of radius 0 sweeps as a ray.
+    bool sweep(const ConvexShape& shape, const glm::vec3& motion, RaycastHit& hit, const QueryFilter& filter) const;
+
+    // World transform blended between the last two physics states of the
+    // nearest simulated body at or above entity. Only position is blended:
+    // rotation follows input every frame and would lag if interpolated.
+    glm::mat4 getRenderTransform(Entity* entity) const;
+
+private:
+    PhysicsWorld() = default;
+    ~PhysicsWorld() = default;
+    PhysicsWorld(const PhysicsWorld&) = delete;
+    PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+    struct Body {
+        CharacterEntity* entity = nullptr;
+        glm::vec3 previousPosition{0.0f};
+        glm::vec3 renderOffset{0.0f};   // world-space shift from the latest state to the blended one
+    };
+    struct Flight {
+        Projectile* projectile = nullptr;
+        glm::vec3 previousPosition{0.0f};
+        glm::vec3 renderOffset{0.0f};
+    };
+
+    std::vector<Body> bodies;
+    std::unordered_map<const Entity*, size_t> bodyIndex;
+    std::vector<Flight> flights;
+    std::unordered_map<const Entity*, size_t> flightIndex;
+    RigidBodySolver rigidBodies;
+    // World-space motion of each body during the current step; empty between steps.
+    std::vector<glm::vec3> bodyMotion;
+    float maxBodyTravel = 0.0f;
+    float timestep = kDefaultTimestep;
+    int maxStepsPerFrame = kDefaultMaxStepsPerFrame;
+    float accumulator = 0.0f;
+    float alpha = 1.0f;
+    uint64_t tick = 0;
+
+    // Islands of the current step: islandBodies[islandRanges[i].first, .second)
+    std::vector<CharacterEntity*> islandBodies;
+    std::vector<std::pair<uint32_t, uint32_t>> islandRanges;
+    std::vector<uint32_t> islandParent;
+    std::vector<ColliderAABB> reachBounds;
+    std::vector<Collider*> bodyColliders;
+    std::vector<uint32_t> sweepOrder;
+    // Indices of the bodies simulated this step, ascending.
+    std::vector<uint32_t> activeBodies;
+
+    void step();
+    void buildIslands();
+    uint32_t findIsland(uint32_t body);
+    void recordBodyMotion();
+    void updateRenderOffsets();
+    const glm::vec3* findRenderOffset(const Entity* entity) const;
+};
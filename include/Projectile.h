@@ -0,0 +1,68 @@
+#pragma once
+#include <Entity.h>
+#include <Collider.h>
+#include <PhysicsWorld.h>
+#include <glm/glm.hpp>
+
+// A fast mover such as a bullet or a thrown object. Each physics step it
+// advances by a single swept query instead of discrete overlap tests, so it
+// cannot tunnel through thin geometry at any speed. The swept shape is the
+// first collider attached to it (OBB, convex or capsule, at its current
+// orientation) or else a sphere of `radius` around its position; a radius of
+// 0 makes it a ray. Projectiles are expected at the top level of the scene.
+//
+// Characters moved earlier in the same step are hit at their time of impact
+// against that motion, so a projectile and a character crossing each other
+// within one step still meet.
+class Projectile : public Entity {
+public:
+    Projectile(
+        const std::string& name,
+        const std::string& shader,
+        const glm::vec3& position,
+        const glm::vec3& velocity,
+        float radius = 0.0f
+    ) : Entity(name, shader, position, {0.0f, 0.0f, 0.0f}), velocity(velocity), radius(radius) {
+        PhysicsWorld::getInstance()->addProjectile(this);
+    }
+    ~Projectile() override {
+        PhysicsWorld::getInstance()->removeProjectile(this);
+    }
+    // One fixed physics step, driven by PhysicsWorld.
+    void simulate(float timestep);
+
+    glm::vec3 getVelocity() const { return velocity; }
+    void setVelocity(const glm::vec3& v) { velocity = v; }
+    // 0 flies straight, 1 falls like a character.
+    void setGravityScale(float scale) { gravityScale = scale; }
+    float getGravityScale() const { return gravityScale; }
+    // Colliders of the owner are never hit, e.g. the shooter's own body.
+    void setOwner(const Entity* entity) { owner = entity; }
+    const Entity* getOwner() const { return owner; }
+    // Casts as a collider on CollisionLayer::Projectile looking for these layers.
+    void setHitMask(uint32_t mask) { hitMask = mask; }
+    uint32_t getHitMask() const { return hitMask; }
+
+    // A projectile stops at its first hit and stays there until it is removed
+    // or relaunched with a new velocity.
+    bool hasHit() const { return stopped; }
+    const RaycastHit& getHit() const { return lastHit; }
+    void launch(const glm::vec3& v) { velocity = v; stopped = false; }
+
+protected:
+    // Runs during the physics step once the projectile has been moved to the
+    // hit. It must not delete the projectile; remove it from update() instead.
+    virtual void onHit(const RaycastHit& /*hit*/) {}
+
+private:
+    friend class PhysicsWorld;
+    glm::vec3 velocity;
+    float radius;
+    float gravityScale = 0.0f;
+    const Entity* owner = nullptr;
+    uint32_t hitMask = CollisionLayer::All;
+    bool stopped = false;
+    RaycastHit lastHit;
+
+    Collider* getShapeCollider();
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
 #include <string>
 #include <vector>
 #include <optional>
@@ -71,6 +72,11 @@ public:
     ShaderManager* getShaderManager() const;
     uint32_t getFramesInFlight() const { return kMaxFramesInFlight; }
     bool isCursorLocked() const { return cursorLocked; }
+    // Locks the cursor for mouse look, or frees it for the UI.
+    void setCursorLocked(bool locked);
+    // Gameplay and physics for one frame: entity updates, broadphase refit,
+    // then the fixed physics steps. Replays drive the simulation through here.
+    void simulateFrame(float frameDelta);
     bool isUIMode() const { return uiMode; }
 
 private:
@@ -219,4 +225,8 @@ private:
     float deltaTime = 0.0f;
     float currentTime = 0.0f;
     Camera* activeCamera = nullptr;
+    // Per-frame culling scratch, kept to reuse the allocations.
+    std::vector<uint32_t> drawSlots;
+    std::vector<glm::mat4> drawTransforms;
+    std::vector<uint8_t> drawVisible;
 };
@@ -0,0 +1,61 @@
+#pragma once
+#include <Entity.h>
+#include <Collider.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// A prop moved by the rigid-body solver: it falls, tumbles, stacks, and is
+// pushed by characters walking into it. Its shape is the first solid
+// collider attached to it. Boxes collide exactly; capsules and hulls take
+// the inertia of their bounding box, and a mesh collider acts as its
+// bounds. Mass is centred on the entity's origin. Rigid bodies are expected
+// at the top level of the scene, at unit scale.
+//
+// The solver owns a body's state: velocities live in its arrays, and the
+// entity's position and rotation are written back after every step.
+// Setting either from gameplay teleports the body.
+class RigidBody : public Entity {
+public:
+    RigidBody(
+        const std::string& name,
+        const std::string& shader,
+        const glm::vec3& position,
+        const glm::vec3& rotation,
+        float mass = 1.0f,
+        std::vector<std::string> textures = {}
+    );
+    ~RigidBody() override;
+
+    float getMass() const;
+    void setMass(float mass);
+    // Combined per contact as the geometric mean of both sides.
+    float getFriction() const;
+    void setFriction(float friction);
+    // 0 stops dead, 1 bounces back at full speed; a contact uses the bouncier side.
+    float getRestitution() const;
+    void setRestitution(float restitution);
+    float getGravityScale() const;
+    void setGravityScale(float scale);
+
+    glm::vec3 getLinearVelocity() const;
+    void setLinearVelocity(const glm::vec3& velocity);
+    // World space, in radians per second.
+    glm::vec3 getAngularVelocity() const;
+    void setAngularVelocity(const glm::vec3& velocity);
+    // Instant change of momentum at a world-space point.
+    void applyImpulse(const glm::vec3& impulse, const glm::vec3& point);
+    void applyImpulse(const glm::vec3& impulse) { applyImpulse(impulse, getPosition()); }
+
+    // Bodies at rest together fall asleep together and cost nothing until
+    // something awake comes close, pushes or hits them.
+    bool isSleeping() const;
+    void wake();
+
+private:
+    friend class RigidBodySolver;
+    uint32_t slot = 0;
+
+    Collider* getShapeCollider();
+};
@@ -0,0 +1,208 @@
+#pragma once
+#include <ContactManifold.h>
+#include <DynamicAABBTree.h>
+#include <GJK.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Collider;
+class Entity;
+class RigidBody;
+
+// Sequential-impulse contact solver for RigidBody props, stepped by
+// PhysicsWorld after characters and projectiles.
+//
+// Body state and the contact constraints of a step live in parallel arrays,
+// one per field. Slot 0 stands for everything the solver does not move:
+// level geometry and characters, which act as immovable and are only
+// pushed aside by their own controller. For solving, each island's contacts
+// are coloured into batches of kLaneWidth that move no body twice, stored
+// lane by lane, so a batch is one pass of SIMD-width loops.
+//
+// Each step, every awake body finds what it could touch in the collision
+// world's tree. Boxes get a full manifold from clipping; other pairs get
+// one point per step, or one per triangle against a mesh, and keep up to
+// four (eight against a mesh) that still hold from earlier steps. Points
+// carry their accumulated impulses from step to step (warm starting), so
+// stacks settle in a few iterations. Bodies linked by contacts form
+// islands, solved in parallel and put to sleep together once every body in
+// them has been still for a while.
+class RigidBodySolver {
+public:
+    static constexpr int kDefaultIterations = 8;
+    // Below this many contacts a step solves islands on the calling thread.
+    static constexpr size_t kMinParallelContacts = 256;
+    // Pairs handed to a pool thread at a time by the narrowphase.
+    static constexpr size_t kPairGrain = 16;
+    // Contacts solved side by side: four floats fill an SSE or NEON register.
+    static constexpr size_t kLaneWidth = 4;
+    // Batches of an island searched for a free lane before opening a new one.
+    static constexpr size_t kMaxBatchSearch = 32;
+
+    void add(RigidBody* body, float mass);
+    void remove(RigidBody* body);
+    void step(float timestep);
+
+    // A character moving at speed along direction ran into collider at point.
+    // The body takes the impulse of an inelastic hit from a pusher of
+    // pusherMass, so light props are shoved along and heavy ones barely move.
+    void push(const Collider* collider, const glm::vec3& point, const glm::vec3& direction, float speed, float pusherMass);
+    void applyImpulse(uint32_t slot, const glm::vec3& impulse, const glm::vec3& point);
+    void setMass(uint32_t slot, float mass);
+    void wake(uint32_t slot);
+    // Wakes entity if it is a sleeping rigid body; anything else is ignored.
+    void wake(const Entity* entity);
+
+    void setIterations(int count);
+    int getIterations() const { return iterations; }
+    size_t getBodyCount() const { return bodyCount - 1; }
+    size_t getAwakeBodyCount() const { return awakeBodies.size(); }
+    size_t getContactCount() const { return contactCount; }
+    size_t getIslandCount() const { return islandRanges.size(); }
+    bool isRigidBody(const Entity* entity) const { return entity && slotOf.count(entity) != 0; }
+
+private:
+    friend class RigidBody;
+    friend class PhysicsWorld;
+
+    // Anchors are in each body's frame, or world space for slot 0, so a
+    // point can be checked again after both bodies have moved.
+    struct ManifoldPoint {
+        glm::vec3 localA{0.0f};
+        glm::vec3 localB{0.0f};
+        glm::vec3 normal{0.0f};
+        float separation = 0.0f;
+        uint32_t id = 0;
+        float normalImpulse = 0.0f;
+        float tangentImpulse[2] = {0.0f, 0.0f};
+    };
+    // Mesh pairs can touch several faces at once, so they keep more points.
+    static constexpr size_t kMaxPairPoints = 2 * kMaxManifoldPoints;
+    struct Manifold {
+        const RigidBody* bodyA = nullptr;
+        const RigidBody* bodyB = nullptr;    // nullptr for slot 0
+        ManifoldPoint points[kMaxPairPoints];
+        uint32_t pointCount = 0;
+        uint64_t lastStep = 0;
+    };
+    using PairKey = std::pair<const Collider*, const Collider*>;
+    struct PairHash {
+        size_t operator()(const PairKey& key) const {
+            const size_t a = std::hash<const void*>{}(key.first);
+            return a ^ (std::hash<const void*>{}(key.second) + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2));
+        }
+    };
+    struct Pair {
+        uint32_t a = 0;
+        uint32_t b = 0;
+        Collider* other = nullptr;
+    };
+    struct PendingContact {
+        uint32_t a = 0;
+        uint32_t b = 0;
+        ManifoldPoint* point = nullptr;
+        glm::vec3 position{0.0f};
+    };
+    // Up to kLaneWidth contacts, field by field across lanes. Rows are the
+    // normal, then the two tangents; their angular terms are kept with the
+    // inverse inertia already applied, so iterations read only velocities.
+    // Unused lanes have bodyA 0 and every term zero.
+    struct ContactBatch {
+        uint32_t lanes = 0;
+        uint32_t bodyA[kLaneWidth] = {};
+        uint32_t bodyB[kLaneWidth] = {};
+        uint32_t contact[kLaneWidth] = {};
+        float inverseMassA[kLaneWidth] = {};
+        float inverseMassB[kLaneWidth] = {};
+        float friction[kLaneWidth] = {};
+        float targetVelocity[kLaneWidth] = {};
+        float axis[3][3][kLaneWidth] = {};
+        float armCrossA[3][3][kLaneWidth] = {};
+        float armCrossB[3][3][kLaneWidth] = {};
+        float angularA[3][3][kLaneWidth] = {};
+        float angularB[3][3][kLaneWidth] = {};
+        float mass[3][kLaneWidth] = {};
+        float impulse[3][kLaneWidth] = {};
+    };
+
+    // Bodies, by slot. Slots past bodyCount are reset and unused.
+    size_t bodyCount = 1;
+    std::vector<RigidBody*> owners;
+    std::vector<Collider*> shapes;
+    std::vector<ConvexShape> worldShapes;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> orientations;
+    std::vector<glm::vec3> linearVelocities;
+    std::vector<glm::vec3> angularVelocities;
+    std::vector<float> masses;
+    std::vector<float> inverseMasses;
+    std::vector<glm::mat3> inverseInertiaLocal;
+    std::vector<glm::mat3> inverseInertiaWorld;
+    std::vector<float> frictions;
+    std::vector<float> restitutions;
+    std::vector<float> gravityScales;
+    std::vector<float> sleepTimers;
+    std::vector<uint8_t> awake;
+    // What the last step wrote into the entity, to spot gameplay teleports.
+    std::vector<glm::vec3> writtenPositions;
+    std::vector<glm::vec3> writtenRotations;
+    std::vector<glm::vec3> previousPositions;
+    std::vector<glm::vec3> renderOffsets;
+    std::unordered_map<const Entity*, uint32_t> slotOf;
+
+    // Contact constraints of the current step, grouped by island.
+    size_t contactCount = 0;
+    std::vector<uint32_t> contactBodyA;
+    std::vector<uint32_t> contactBodyB;
+    std::vector<glm::vec3> contactNormals;
+    std::vector<glm::vec3> contactArmsA;
+    std::vector<glm::vec3> contactArmsB;
+    std::vector<float> normalImpulses;
+    std::vector<float> tangentImpulses[2];
+    std::vector<ManifoldPoint*> contactSources;
+    std::vector<ContactBatch> contactBatches;
+
+    std::unordered_map<PairKey, Manifold, PairHash> manifolds;
+    uint64_t stepCount = 0;
+    int iterations = kDefaultIterations;
+
+    // Scratch, kept between steps to avoid reallocating.
+    std::vector<uint32_t> awakeBodies;
+    std::vector<uint8_t> visited;
+    std::vector<Pair> pairs;
+    std::vector<ContactPoint> pairPoints;
+    std::vector<uint32_t> pairPointCounts;
+    std::vector<PendingContact> pending;
+    std::vector<uint32_t> islandParent;
+    std::vector<uint32_t> islandOf;
+    std::vector<std::pair<uint32_t, uint32_t>> islandRanges;
+    std::vector<std::pair<uint32_t, uint32_t>> islandBatchRanges;
+    std::vector<uint32_t> islandBodies;
+    std::vector<std::pair<uint32_t, uint32_t>> islandBodyRanges;
+
+    void resizeBodies(size_t count);
+    void moveBody(size_t from, size_t to);
+    void resetBody(size_t slot);
+    void resizeContacts(size_t count);
+    void updateMassProperties(uint32_t slot);
+
+    void syncFromEntities();
+    void findPairs(float timestep);
+    void collidePairs(float timestep);
+    void mergeManifolds();
+    void buildIslands();
+    uint32_t findIsland(uint32_t slot);
+    void batchContacts();
+    void prepareContacts(size_t begin, size_t end, float timestep);
+    void solveIsland(size_t begin, size_t end);
+    void integrate(float timestep);
+    void updateSleep(float timestep);
+    void writeToEntities();
+    void applyImpulseAt(uint32_t slot, const glm::vec3& impulse, const glm::vec3& arm);
+};
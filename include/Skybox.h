@@ -27,9 +27,12 @@ public:
         this->setModel(ModelManager::getInstance()->getModel("cube"));
     }
     void update(float deltaTime) override;
+    // Builds the cubemap the first time; scenes that will show a sky can
+    // call it early so creating their Skybox does not stall.
+    static std::vector<std::string> ensureCubemapTexture();
 
 private:
-    static std::vector<std::string> ensureCubemapTexture();
     static bool createCubemapTexture();
-    Entity* camera = EntityManager::getInstance()->getEntity("camera");
+    // The player's camera, found through the player once one exists.
+    EntityHandle camera;
 };
\ No newline at end of file
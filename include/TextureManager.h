@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -22,6 +23,11 @@ public:
     struct ImageData { unsigned char* pixels; int width; int height; };
     void prepareTextureAtlas();
 
+    // Reads a single-channel image at 16 bits per sample (8-bit files are
+    // widened), first row first, for data such as terrain heights. Needs no
+    // renderer.
+    static bool loadHeightmap(const std::string& path, std::vector<uint16_t>& samples, int& width, int& height);
+
     Image* getTexture(const std::string& name);
     void registerTexture(const std::string& name, const Image& texture);
     void shutdown();
@@ -3,13 +3,31 @@
 #include <cmath>
 #include <Entity.h>
 #include <Collider.h>
+#include <CollisionWorld.h>
 #include <glm/gtc/matrix_transform.hpp>
 
-void CharacterEntity::update(float deltaTime) {
-    // Clamp deltaTime to avoid giant steps (e.g., when resizing window)
-    const float MAX_DELTA_TIME = 0.05f; // 50 ms
-    deltaTime = std::min(deltaTime, MAX_DELTA_TIME);
+namespace {
+    constexpr float kGravity = 9.81f;
+    // Sweeps stop this far short of what they hit, so the next sweep starts clear of it.
+    constexpr float kContactOffset = 0.005f;
+    constexpr float kMinMove = 1e-5f;
+    constexpr int kMaxSlideIterations = 2;
+    // Swept queries one step may spend, including the lift and the drop.
+    constexpr int kMaxSweepsPerStep = 4;
+    // A body resting slower than this for kTimeToSleep falls asleep.
+    constexpr float kSleepSpeed = 0.05f;
+    constexpr float kTimeToSleep = 0.5f;
+}
 
+// Collide-and-slide. On the ground the body is lifted by the step height,
+// slides along the desired motion and drops back down, which lands, snaps to
+// the ground and finishes climbing a step in the same pass: three swept
+// queries on open ground and never more than kMaxSweepsPerStep. Airborne
+// bodies slide along their velocity in up to two. A step also runs at most
+// one overlap query, when a sweep starts inside something.
+void CharacterEntity::simulate(float deltaTime) {
+    const glm::vec3 startPosition = getPosition();
+    depenetrated = false;
     glm::vec3 desiredVel(0.0f);
     if (glm::length(pressed) > 0.001f) {
         glm::mat4 yawRotation = glm::rotate(glm::mat4(1.0f), glm::radians(getRotation().y), glm::vec3(0.0f, 1.0f, 0.0f));
@@ -23,105 +41,66 @@ void CharacterEntity::update(float deltaTime) {
     }
     velocity.x = desiredVel.x;
     velocity.z = desiredVel.z;
-    
+
     if (!grounded || velocity.y > 0.0f) {
-        velocity.y -= 9.81f * deltaTime;
-    }
-
-    // Substep integration to prevent tunneling through thin objects
-    const float MAX_STEP_DIST = 0.25f;
-    const float totalMoveLen = glm::length(velocity * deltaTime);
-    int steps = totalMoveLen > 0.0f ? static_cast<int>(std::ceil(totalMoveLen / MAX_STEP_DIST)) : 1;
-    steps = std::clamp(steps, 1, 8);
-    const float subDt = deltaTime / static_cast<float>(steps);
-
-    bool touchedGroundThisFrame = false;
-    glm::vec3 groundNormalAccum(0.0f);
-    constexpr float kSkin = 0.002f; // small separation to avoid re-colliding due to numerical error
-    constexpr float kMinVerticalVel = 1e-4f; // threshold for considering velocity.y as zero
-    
-    for (int i = 0; i < steps; ++i) {
-        glm::vec3 vStep(0.0f, velocity.y * subDt, 0.0f);
-        
-        if (std::abs(vStep.y) < kMinVerticalVel && !touchedGroundThisFrame) {
-            const float kGroundProbe = 0.02f;
-            collision gcol = willCollide(glm::vec3(0.0f, -kGroundProbe, 0.0f));
-            if (gcol.other) {
-                float glen = glm::length(gcol.mtv);
-                if (glen > 1e-5f) {
-                    glm::vec3 gn = gcol.mtv / glen;
-                    if (gn.y > groundedNormalThreshold) {
-                        touchedGroundThisFrame = true;
-                        groundNormalAccum += gn;
-                        if (velocity.y < 0.0f) velocity.y = 0.0f;
-                    }
-                }
-            }
-        }
-        
-        if (std::abs(vStep.y) >= kMinVerticalVel) {
-            collision vcol = willCollide(vStep);
-            if (!vcol.other) {
-                setPosition(getPosition() + vStep);
-            } else {
-                setPosition(getPosition() + vStep + vcol.mtv);
-                float len = glm::length(vcol.mtv);
-                if (len > 1e-5f) {
-                    glm::vec3 n = vcol.mtv / len;
-                    float vn = glm::dot(velocity, n);
-                    if (vn < 0.0f) velocity -= vn * n;
-                    setPosition(getPosition() + n * kSkin);
-                    if (n.y > groundedNormalThreshold && velocity.y <= 0.0f) {
-                        velocity.y = 0.0f;
-                        touchedGroundThisFrame = true;
-                        groundNormalAccum += n;
-                    }
-                }
+        velocity.y -= kGravity * deltaTime;
+    }
+
+    bool touchedGround = false;
+    if (grounded && velocity.y <= 0.0f) {
+        const glm::vec3 horizontal(velocity.x * deltaTime, 0.0f, velocity.z * deltaTime);
+        // The drop always gets a sweep; the lift and the slides share the rest.
+        int sweepsLeft = kMaxSweepsPerStep - 1;
+        float lifted = 0.0f;
+        if (glm::length(horizontal) > kMinMove) {
+            // A step still owing height from the last one skips the lift; see below.
+            if (pendingDrop <= 0.0f) {
+                lifted = sweep(glm::vec3(0.0f, stepHeight, 0.0f));
+                --sweepsLeft;
             }
+            slide(horizontal, true, kMaxSlideIterations, sweepsLeft);
         }
-        
-        glm::vec3 hStep(velocity.x * subDt, 0.0f, velocity.z * subDt);
-        if (hStep.x != 0.0f || hStep.z != 0.0f) {
-            if (touchedGroundThisFrame) {
-                glm::vec3 gN = glm::length(groundNormalAccum) > 0.0f ? glm::normalize(groundNormalAccum) : glm::vec3(0.0f, 1.0f, 0.0f);
-                hStep = hStep - glm::dot(hStep, gN) * gN;
+        // Undo the lift, fall as far as gravity says, and snap onto ground up
+        // to stepHeight further down. Steep surfaces are not snapped onto.
+        const float fall = lifted + pendingDrop - velocity.y * deltaTime;
+        pendingDrop = 0.0f;
+        RaycastHit ground;
+        if (castBody(glm::vec3(0.0f, -1.0f, 0.0f), fall + stepHeight, ground)) {
+            if (ground.distance <= 0.0f) {
+                depenetrate();
             }
-            collision hcol = willCollide(hStep);
-            if (!hcol.other) {
-                setPosition(getPosition() + hStep);
+            const float travel = std::max(ground.distance - kContactOffset, 0.0f);
+            if (ground.normal.y > groundedNormalThreshold) {
+                displace(glm::vec3(0.0f, -travel, 0.0f));
+                touchedGround = true;
+            } else if (travel >= fall) {
+                displace(glm::vec3(0.0f, -fall, 0.0f));
             } else {
-                glm::vec3 mtv = hcol.mtv;
-                if (!touchedGroundThisFrame && mtv.y > 0.0f) {
-                    mtv.y = 0.0f;
-                }
-                setPosition(getPosition() + hStep + mtv);
-                float len = glm::length(hcol.mtv);
-                if (len > 1e-5f) {
-                    glm::vec3 n = hcol.mtv / len;
-                    float vn = glm::dot(velocity, n);
-                    if (vn < 0.0f) velocity -= vn * n;
-                    setPosition(getPosition() + n * kSkin);
-                }
-            }
-        }
-        collision post = willCollide(glm::vec3(0.0f));
-        if (post.other) {
-            setPosition(getPosition() + post.mtv);
-            float len = glm::length(post.mtv);
-            if (len > 1e-5f) {
-                glm::vec3 fix = post.mtv;
-                if (!touchedGroundThisFrame && fix.y > 0.0f) {
-                    fix.y = 0.0f;
-                    setPosition(getPosition() - post.mtv + fix);
+                // Dropped onto an edge too steep to stand on, usually a ledge
+                // the lift carried a rounded bottom over. Slide down it far
+                // enough to lose the rest of the height, or the next lift
+                // would ratchet the body up the ledge. If sliding along a wall
+                // used up the sweeps, the next step loses the height instead
+                // of lifting.
+                displace(glm::vec3(0.0f, -travel, 0.0f));
+                if (sweepsLeft > 0) {
+                    const glm::vec3 down = glm::vec3(0.0f, -1.0f, 0.0f) + ground.normal.y * ground.normal;
+                    touchedGround = slide(down * ((fall - travel) / -down.y), false, 1, sweepsLeft);
+                } else {
+                    pendingDrop = fall - travel;
                 }
-                glm::vec3 n = (len > 0.0f) ? (post.mtv / len) : glm::vec3(0.0f,1.0f,0.0f);
-                float vn = glm::dot(velocity, n);
-                if (vn < 0.0f) velocity -= vn * n;
-                setPosition(getPosition() + n * kSkin);
             }
+        } else {
+            displace(glm::vec3(0.0f, -fall, 0.0f));
         }
+    } else {
+        const bool falling = velocity.y <= 0.0f;
+        int sweepsLeft = kMaxSweepsPerStep;
+        pendingDrop = 0.0f;
+        touchedGround = slide(velocity * deltaTime, false, kMaxSlideIterations, sweepsLeft) && falling;
     }
-    if (touchedGroundThisFrame) {
+
+    if (touchedGround) {
         grounded = true;
         groundedTimer = 0.0f;
         if (velocity.y < 0.0f) {
@@ -134,9 +113,100 @@ void CharacterEntity::update(float deltaTime) {
     if (glm::length(velocity) < 1e-4f) {
         resetVelocity();
     }
+    contacts.endStep();
+
+    const bool resting = touchedGround && glm::length(pressed) <= 0.001f && glm::length(velocity) < kSleepSpeed &&
+                         glm::length(getPosition() - startPosition) < kSleepSpeed * deltaTime;
+    idleTime = resting ? idleTime + deltaTime : 0.0f;
+    sleeping = idleTime >= kTimeToSleep;
+}
+
+float CharacterEntity::sweep(const glm::vec3& displacement) {
+    const float length = glm::length(displacement);
+    if (length < kMinMove) return 0.0f;
+    RaycastHit hit;
+    float travel = length;
+    if (castBody(displacement, length, hit)) {
+        if (hit.distance <= 0.0f) {
+            depenetrate();
+        }
+        travel = std::max(hit.distance - kContactOffset, 0.0f);
+    }
+    displace(displacement * (travel / length));
+    return travel;
+}
+
+bool CharacterEntity::slide(glm::vec3 displacement, bool flattenWalls, int maxSweeps, int& sweepsLeft) {
+    bool hitWalkable = false;
+    glm::vec3 previousNormal(0.0f);
+    for (int i = 0; i < maxSweeps && sweepsLeft > 0; ++i) {
+        const float length = glm::length(displacement);
+        if (length < kMinMove) break;
+        const glm::vec3 dir = displacement / length;
+        RaycastHit hit;
+        --sweepsLeft;
+        if (!castBody(dir, length, hit)) {
+            displace(displacement);
+            break;
+        }
+        if (hit.distance <= 0.0f) {
+            depenetrate();
+        }
+        const float travel = std::max(hit.distance - kContactOffset, 0.0f);
+        displace(dir * travel);
+
+        glm::vec3 n = hit.normal;
+        const bool walkable = n.y > groundedNormalThreshold;
+        hitWalkable = hitWalkable || walkable;
+        if (flattenWalls && !walkable) {
+            // Walls stop a walking character; they must not lift it or push it down.
+            const glm::vec3 flat(n.x, 0.0f, n.z);
+            const float flatLen = glm::length(flat);
+            if (flatLen > 1e-4f) n = flat / flatLen;
+        }
+        const float into = -glm::dot(velocity, n);
+        if (!walkable && into > 0.0f && PhysicsWorld::getInstance()->isRigidBody(hit.collider->getParent())) {
+            pushes.push_back(Push{hit.collider, hit.point, -n, into});
+        }
+        displacement = dir * (length - travel);
+        displacement -= glm::dot(displacement, n) * n;
+        // Wedged between two planes: follow the crease they form.
+        if (i > 0 && glm::dot(displacement, previousNormal) < 0.0f) {
+            glm::vec3 crease = glm::cross(previousNormal, n);
+            const float creaseLen = glm::length(crease);
+            displacement = creaseLen > 1e-4f ? crease * (glm::dot(displacement, crease) / (creaseLen * creaseLen)) : glm::vec3(0.0f);
+        }
+        previousNormal = n;
+
+        // Input sets the horizontal velocity afresh every step and only the
+        // vertical part carries over, so each is clipped against the surface
+        // on its own. Clipping them together would turn the forward speed a
+        // rounded bottom carries into a ledge or seam into a hop.
+        glm::vec3 walk(velocity.x, 0.0f, velocity.z);
+        const float walkInto = glm::dot(walk, n);
+        if (walkInto < 0.0f) walk -= walkInto * n;
+        const float fallInto = velocity.y * n.y;
+        if (fallInto < 0.0f) velocity.y -= fallInto * n.y;
+        velocity.x = walk.x;
+        velocity.z = walk.z;
+    }
+    return hitWalkable;
 }
+
+void CharacterEntity::depenetrate() {
+    if (depenetrated) return;
+    depenetrated = true;
+    collision overlap = willCollide(glm::vec3(0.0f));
+    if (!overlap.other) return;
+    const float len = glm::length(overlap.mtv);
+    if (len > 1e-6f) {
+        displace(overlap.mtv + overlap.mtv * (kContactOffset / len));
+    }
+}
+
 void CharacterEntity::move(const glm::vec3& delta) {
     pressed += delta;
+    wake();
 
     // Debug logging for movement tracking
     glm::vec3 pos = getPosition();
@@ -148,6 +218,7 @@ void CharacterEntity::move(const glm::vec3& delta) {
 }
 void CharacterEntity::stopMove(const glm::vec3& delta) {
     pressed -= delta;
+    wake();
 
     // Debug logging for movement tracking
     glm::vec3 pos = getPosition();
@@ -165,6 +236,7 @@ void CharacterEntity::jump() {
     if (grounded || groundedTimer <= coyoteTime) {
         velocity.y = jumpSpeed;
         grounded = false;
+        wake();
     }
 }
 void CharacterEntity::resetVelocity() {
@@ -172,10 +244,14 @@ void CharacterEntity::resetVelocity() {
 }
 void CharacterEntity::rotate(const glm::vec3& delta) {
     if (delta.y != 0.0f) {
+        wake();
         glm::vec3 bodyRot = getRotation();
         bodyRot.y = std::fmod(bodyRot.y + delta.y, 360.0f);
         if (bodyRot.y < 0.0f) bodyRot.y += 360.0f;
-        collision rotCol = willCollide(glm::vec3(0.0f), bodyRot - getRotation());
+        // An upright capsule looks the same from every yaw, so turning cannot collide.
+        const Collider* body = getBodyCollider();
+        const bool yawInvariant = body && body->getColliderType() == ColliderType::Capsule && static_cast<const CapsuleCollider*>(body)->isYawInvariant();
+        collision rotCol = yawInvariant ? collision{} : willCollide(glm::vec3(0.0f), bodyRot - getRotation());
         const float kYawPenetrationEps = 2.0e-2f;
         if (!rotCol.other) {
             setRotation(bodyRot);
@@ -205,44 +281,105 @@ void CharacterEntity::rotate(const glm::vec3& delta) {
     }
 }
 
-collision CharacterEntity::willCollide(const glm::vec3& deltaPos, const glm::vec3& deltaRot) {
-    OBBCollider* myBox = nullptr;
+Collider* CharacterEntity::getBodyCollider() {
     for (auto& child : this->getChildren()) {
-        myBox = dynamic_cast<OBBCollider*>(child);
-        if (myBox) break;
+        Collider* collider = dynamic_cast<Collider*>(child);
+        if (collider && !collider->isTrigger()) {
+            return collider;
+        }
+    }
+    return nullptr;
+}
+
+void CharacterEntity::displace(const glm::vec3& delta) {
+    setPosition(getPosition() + delta);
+    // Keep the body collider in step with the entity so later substeps and
+    // island mates query against where we actually are. The broadphase tree
+    // is only synced after the step, since islands may be resolving in parallel.
+    if (Collider* body = getBodyCollider()) {
+        body->updateWorldTransform();
     }
-    if (!myBox) {
+}
+
+collision CharacterEntity::willCollide(const glm::vec3& deltaPos, const glm::vec3& deltaRot) {
+    Collider* myBody = getBodyCollider();
+    if (!myBody) {
         return {nullptr, glm::vec3(0.0f)};
     }
-    ColliderAABB myAABB = myBox->getWorldAABB();
+    ColliderAABB myAABB = myBody->getWorldAABB();
     if (deltaPos.x != 0.0f || deltaPos.y != 0.0f || deltaPos.z != 0.0f) {
         myAABB.min += deltaPos;
         myAABB.max += deltaPos;
     }
 
-    CollisionMTV mtv{};
+    const float broadphaseMargin = (glm::length(deltaRot) > 0.0f) ? 0.0f : 0.005f;
+    ColliderAABB queryBox{myAABB.min - glm::vec3(broadphaseMargin), myAABB.max + glm::vec3(broadphaseMargin)};
+    broadphaseHits.clear();
+    CollisionWorld::getInstance()->queryAABB(queryBox, broadphaseHits, myBody->getCollisionMask());
+    const bool stepping = !islandMates.empty();
+    const PhysicsWorld* physics = PhysicsWorld::getInstance();
+    collision hit{};
+    for (Collider* otherCollider : broadphaseHits) {
+        if (otherCollider->getParent() == this || otherCollider->isTrigger() || !myBody->canCollideWith(*otherCollider)) continue;
+        // Mid-step the tree holds other bodies where the step started; the
+        // ones we can reach are in our island and are tested directly below.
+        if (stepping && physics->isBody(otherCollider->getParent())) continue;
+        if (testCollider(myBody, myAABB, otherCollider, broadphaseMargin, deltaPos, deltaRot, hit)) {
+            return hit;
+        }
+    }
+    for (CharacterEntity* mate : islandMates) {
+        if (mate == this) continue;
+        Collider* mateBody = mate->getBodyCollider();
+        if (mateBody && myBody->canCollideWith(*mateBody) && testCollider(myBody, myAABB, mateBody, broadphaseMargin, deltaPos, deltaRot, hit)) {
+            return hit;
+        }
+    }
+    return {nullptr, glm::vec3(0.0f)};
+}
+
+bool CharacterEntity::castBody(const glm::vec3& direction, float distance, RaycastHit& hit) {
+    Collider* myBody = getBodyCollider();
+    const float len = glm::length(direction);
+    if (!myBody || len < 1e-6f) return false;
+    const glm::vec3 dir = direction / len;
+    const ConvexShape body = myBody->getSupportShape();
+
+    QueryFilter filter;
+    filter.ignore = this;
+    filter.layer = myBody->getCollisionLayer();
+    filter.mask = myBody->getCollisionMask();
+    filter.contacts = &contacts;
+    const bool stepping = !islandMates.empty();
+    if (stepping) {
+        // Same reasoning as willCollide: other bodies are only tested through our island.
+        filter.accept = [](const Collider* collider) { return !PhysicsWorld::getInstance()->isBody(collider->getParent()); };
+    }
+    bool found = CollisionWorld::getInstance()->shapeCast(body, dir, distance, hit, filter);
+    for (CharacterEntity* mate : islandMates) {
+        if (mate == this) continue;
+        Collider* mateBody = mate->getBodyCollider();
+        RaycastHit mateHit;
+        if (mateBody && myBody->canCollideWith(*mateBody) && mateBody->shapeCast(body, dir, found ? hit.distance : distance, mateHit, &contacts.at(this, mateBody).axis)) {
+            hit = mateHit;
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool CharacterEntity::testCollider(const Collider* myBody, const ColliderAABB& myAABB, const Collider* other, float margin, const glm::vec3& deltaPos, const glm::vec3& deltaRot, collision& out) const {
     constexpr float kMTV_MIN_LEN = 1e-3f;
     constexpr float kPENETRATION_MIN = 1e-4f;
-    EntityManager* entityMgr = EntityManager::getInstance();
-    for (const auto& [otherName, otherEntity] : entityMgr->getAllEntities()) {
-        if (otherEntity == this) continue;
-        Collider* otherCollider = nullptr;
-        for (auto& child : otherEntity->getChildren()) {
-            otherCollider = dynamic_cast<Collider*>(child);
-            if (otherCollider) break;
-        }
-        if (!otherCollider) continue;
-        ColliderAABB otherAABB = otherCollider->getWorldAABB();
-        float broadphaseMargin = (glm::length(deltaRot) > 0.0f) ? 0.0f : 0.005f;
-        bool aabbOverlaps = aabbIntersects(myAABB, otherAABB, broadphaseMargin);
-        if (!aabbOverlaps) continue;
-        
-        mtv = CollisionMTV{};
-        if (myBox->intersectsMTV(*otherCollider, mtv, deltaPos, deltaRot)) {
-            if (mtv.penetration > kPENETRATION_MIN && glm::length(mtv.mtv) > kMTV_MIN_LEN) {
-                return {otherCollider, mtv.mtv};
-            }
+    ColliderAABB otherAABB = other->getWorldAABB();
+    if (!aabbIntersects(myAABB, otherAABB, margin)) return false;
+
+    CollisionMTV mtv{};
+    if (myBody->intersectsMTV(*other, mtv, deltaPos, deltaRot)) {
+        if (mtv.penetration > kPENETRATION_MIN && glm::length(mtv.mtv) > kMTV_MIN_LEN) {
+            out = {const_cast<Collider*>(other), mtv.mtv};
+            return true;
         }
     }
-    return {nullptr, glm::vec3(0.0f)};
-}
\ No newline at end of file
+    return false;
+}
@@ -0,0 +1,249 @@
+#include <ClosestPoints.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr float kParallelEps = 1e-12f;
+    // Segments closer than this to the other shape are treated as touching its core.
+    constexpr float kCoreContact = 1e-5f;
+}
+
+float closestPointsSegmentSegment(const glm::vec3& p1, const glm::vec3& q1, const glm::vec3& p2, const glm::vec3& q2, glm::vec3& onFirst, glm::vec3& onSecond) {
+    const glm::vec3 d1 = q1 - p1;
+    const glm::vec3 d2 = q2 - p2;
+    const glm::vec3 r = p1 - p2;
+    const float a = glm::dot(d1, d1);
+    const float e = glm::dot(d2, d2);
+    const float f = glm::dot(d2, r);
+    float s = 0.0f;
+    float t = 0.0f;
+    if (a <= kParallelEps && e <= kParallelEps) {
+        // Both segments are points.
+    } else if (a <= kParallelEps) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    } else {
+        const float c = glm::dot(d1, r);
+        if (e <= kParallelEps) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        } else {
+            const float b = glm::dot(d1, d2);
+            const float denom = a * e - b * b;
+            // Parallel segments have a whole range of closest pairs; any one will do.
+            s = denom > kParallelEps ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = std::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    onFirst = p1 + d1 * s;
+    onSecond = p2 + d2 * t;
+    const glm::vec3 gap = onFirst - onSecond;
+    return glm::dot(gap, gap);
+}
+
+// In box space each axis contributes (x - clamp(x))^2, which is quadratic in
+// t between the points where the segment crosses a face plane. Minimising
+// every piece and keeping the best gives the exact closest pair.
+float closestPointsSegmentBox(const glm::vec3& p, const glm::vec3& q, const ConvexShape& box, glm::vec3& onSegment, glm::vec3& onBox) {
+    const glm::vec3 rel = p - box.center;
+    const glm::vec3 dir = q - p;
+    float o[3], v[3], h[3];
+    float breaks[8];
+    int breakCount = 0;
+    breaks[breakCount++] = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        o[i] = glm::dot(rel, box.axes[i]);
+        v[i] = glm::dot(dir, box.axes[i]);
+        h[i] = box.halfExtents[i];
+        if (std::abs(v[i]) <= kParallelEps) continue;
+        for (float plane : {-h[i], h[i]}) {
+            const float t = (plane - o[i]) / v[i];
+            if (t > 0.0f && t < 1.0f) breaks[breakCount++] = t;
+        }
+    }
+    breaks[breakCount++] = 1.0f;
+    std::sort(breaks, breaks + breakCount);
+
+    auto distanceAt = [&](float t) {
+        float d2 = 0.0f;
+        for (int i = 0; i < 3; ++i) {
+            const float x = o[i] + v[i] * t;
+            const float outside = x - std::clamp(x, -h[i], h[i]);
+            d2 += outside * outside;
+        }
+        return d2;
+    };
+
+    float bestT = 0.0f;
+    float best = std::numeric_limits<float>::max();
+    for (int k = 0; k + 1 < breakCount; ++k) {
+        const float t0 = breaks[k];
+        const float t1 = breaks[k + 1];
+        const float mid = 0.5f * (t0 + t1);
+        float num = 0.0f;
+        float den = 0.0f;
+        for (int i = 0; i < 3; ++i) {
+            const float x = o[i] + v[i] * mid;
+            if (x > h[i]) {
+                num += (o[i] - h[i]) * v[i];
+            } else if (x < -h[i]) {
+                num += (o[i] + h[i]) * v[i];
+            } else {
+                continue;
+            }
+            den += v[i] * v[i];
+        }
+        const float t = den > kParallelEps ? std::clamp(-num / den, t0, t1) : t0;
+        const float d2 = distanceAt(t);
+        if (d2 < best) {
+            best = d2;
+            bestT = t;
+        }
+    }
+
+    onSegment = p + dir * bestT;
+    onBox = box.center;
+    for (int i = 0; i < 3; ++i) {
+        onBox += box.axes[i] * std::clamp(o[i] + v[i] * bestT, -h[i], h[i]);
+    }
+    return best;
+}
+
+glm::vec3 closestPointOnTriangle(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    const glm::vec3 ab = b - a;
+    const glm::vec3 ac = c - a;
+    const glm::vec3 ap = point - a;
+    const float d1 = glm::dot(ab, ap);
+    const float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    const glm::vec3 bp = point - b;
+    const float d3 = glm::dot(ab, bp);
+    const float d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    const glm::vec3 cp = point - c;
+    const float d5 = glm::dot(ab, cp);
+    const float d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    const float denom = va + vb + vc;
+    if (std::abs(denom) <= kParallelEps) return a;
+    return a + ab * (vb / denom) + ac * (vc / denom);
+}
+
+// Either the segment pierces the triangle, or the closest pair involves a
+// segment endpoint or one of the triangle's edges.
+float closestPointsSegmentTriangle(const glm::vec3& p, const glm::vec3& q, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, glm::vec3& onSegment, glm::vec3& onTriangle) {
+    const glm::vec3 n = glm::cross(b - a, c - a);
+    const float dp = glm::dot(n, p - a);
+    const float dq = glm::dot(n, q - a);
+    if ((dp <= 0.0f) != (dq <= 0.0f) || dp == 0.0f || dq == 0.0f) {
+        const float denom = dp - dq;
+        if (std::abs(denom) > kParallelEps) {
+            const glm::vec3 x = p + (q - p) * (dp / denom);
+            if (glm::dot(glm::cross(b - a, x - a), n) >= 0.0f &&
+                glm::dot(glm::cross(c - b, x - b), n) >= 0.0f &&
+                glm::dot(glm::cross(a - c, x - c), n) >= 0.0f) {
+                onSegment = onTriangle = x;
+                return 0.0f;
+            }
+        }
+    }
+
+    float best = std::numeric_limits<float>::max();
+    auto consider = [&](const glm::vec3& s, const glm::vec3& t) {
+        const glm::vec3 gap = s - t;
+        const float d2 = glm::dot(gap, gap);
+        if (d2 < best) {
+            best = d2;
+            onSegment = s;
+            onTriangle = t;
+        }
+    };
+    consider(p, closestPointOnTriangle(p, a, b, c));
+    consider(q, closestPointOnTriangle(q, a, b, c));
+    const glm::vec3* corners[3] = {&a, &b, &c};
+    for (int e = 0; e < 3; ++e) {
+        glm::vec3 s, t;
+        closestPointsSegmentSegment(p, q, *corners[e], *corners[(e + 1) % 3], s, t);
+        consider(s, t);
+    }
+    return best;
+}
+
+bool capsulePenetration(const ConvexShape& capsule, const ConvexShape& other, GJKResult& out) {
+    out = GJKResult{};
+    const glm::vec3 p = capsule.center - capsule.axes[1] * capsule.halfLength;
+    const glm::vec3 q = capsule.center + capsule.axes[1] * capsule.halfLength;
+    glm::vec3 onSegment(0.0f);
+    glm::vec3 onOther(0.0f);
+    float otherRadius = 0.0f;
+    float d2 = 0.0f;
+    switch (other.kind) {
+        case ConvexShape::Kind::Box:
+            d2 = closestPointsSegmentBox(p, q, other, onSegment, onOther);
+            break;
+        case ConvexShape::Kind::Sphere:
+            d2 = closestPointsSegmentSegment(p, q, other.center, other.center, onSegment, onOther);
+            otherRadius = other.radius;
+            break;
+        case ConvexShape::Kind::Capsule: {
+            const glm::vec3 axis = other.axes[1] * other.halfLength;
+            d2 = closestPointsSegmentSegment(p, q, other.center - axis, other.center + axis, onSegment, onOther);
+            otherRadius = other.radius;
+            break;
+        }
+        case ConvexShape::Kind::Points:
+            if (other.pointCount == 3) {
+                d2 = closestPointsSegmentTriangle(p, q, other.points[0] + other.offset, other.points[1] + other.offset, other.points[2] + other.offset, onSegment, onOther);
+            } else {
+                ConvexShape core = capsule;
+                core.radius = 0.0f;
+                GJKResult r;
+                if (gjkDistance(core, other, r)) return gjkPenetration(capsule, other, out);
+                onSegment = r.pointA;
+                onOther = r.pointB;
+                d2 = r.distance * r.distance;
+            }
+            break;
+    }
+
+    if (d2 <= kCoreContact * kCoreContact) {
+        return gjkPenetration(capsule, other, out);
+    }
+    const float distance = std::sqrt(d2);
+    const glm::vec3 normal = (onSegment - onOther) / distance;
+    const float reach = capsule.radius + otherRadius;
+    out.pointA = onSegment - normal * capsule.radius;
+    out.pointB = onOther + normal * otherRadius;
+    if (distance >= reach) {
+        out.distance = distance - reach;
+        return false;
+    }
+    out.intersecting = true;
+    out.normal = normal;
+    out.penetration = reach - distance;
+    return true;
+}
@@ -1,7 +1,71 @@
 #include <Collider.h>
+#include <ClosestPoints.h>
+#include <CollisionWorld.h>
+#include <JobSystem.h>
 
+#include <cstdlib>
 #include <iostream>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#define COLLIDER_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define COLLIDER_TARGET_AVX
+#else
+#define COLLIDER_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace {
+    // Vertex transforms shorter than this run on the calling thread; below
+    // it, handing work to the pool costs more than it saves.
+    constexpr size_t kVertexGrain = 4096;
+}
+
+Collider::~Collider() {
+    CollisionWorld::getInstance()->removeCollider(this);
+}
+
+void Collider::onAttached() {
+    if (!getParent()) return;
+    CollisionWorld::getInstance()->addCollider(this);
+}
+
+void Collider::onDetached() {
+    CollisionWorld::getInstance()->removeCollider(this);
+}
+
+void Collider::setCollisionLayer(uint32_t layer) {
+    collisionLayer = layer;
+    CollisionWorld::getInstance()->updateFilter(this);
+}
+
+void Collider::setStatic(bool isStatic) {
+    if (staticHint == isStatic) return;
+    staticHint = isStatic;
+    if (!isStatic) {
+        baked = false;
+        return;
+    }
+    CollisionWorld::getInstance()->updateCollider(this);
+}
+
+void Collider::bake() {
+    baked = false;
+    // Subclass caches stop checking the transform once baked, so bring them up to date first.
+    prepareQueries();
+    bakedBounds = computeWorldAABB();
+    bakedShape = computeSupportShape(glm::vec3(0.0f), glm::vec3(0.0f));
+    baked = true;
+}
+
+void Collider::setTrigger(bool isTrigger) {
+    if (trigger == isTrigger) return;
+    trigger = isTrigger;
+    CollisionWorld::getInstance()->updateFilter(this);
+}
+
 std::array<glm::vec3, 8> Collider::buildOBBCorners(const glm::mat4& transform, const glm::vec3& half) {
     std::array<glm::vec3, 8> corners{};
     static const glm::vec3 offsets[8] = {
@@ -88,25 +152,12 @@ void Collider::addAxisUnique(std::vector<glm::vec3>& axes, const glm::vec3& axis
 
 void Collider::projectVertsOntoAxis(const std::vector<glm::vec3>& verts, const glm::vec3& axis, float& mn, float& mx, const glm::vec3& offset) {
     if (verts.empty()) { mn = mx = 0.0f; return; }
-#if defined(USE_OPENMP)
-    float mnLocal = std::numeric_limits<float>::infinity();
-    float mxLocal = -std::numeric_limits<float>::infinity();
-    #pragma omp parallel for reduction(min:mnLocal) reduction(max:mxLocal)
-    for (int i = 0; i < static_cast<int>(verts.size()); ++i) {
-        float p = glm::dot(verts[static_cast<size_t>(i)] + offset, axis);
-        if (p < mnLocal) mnLocal = p;
-        if (p > mxLocal) mxLocal = p;
-    }
-    mn = mnLocal;
-    mx = mxLocal;
-#else
     mn = mx = glm::dot(verts[0] + offset, axis);
     for (size_t i=1; i<verts.size(); ++i) {
         float p = glm::dot(verts[i] + offset, axis);
         if (p < mn) mn = p;
         if (p > mx) mx = p;
     }
-#endif
 }
 
 bool Collider::satMTV(const std::vector<glm::vec3>& vertsA, const std::vector<glm::vec3>& faceAxesA, const std::vector<glm::vec3>& edgeDirsA, const std::vector<glm::vec3>& vertsB, const std::vector<glm::vec3>& faceAxesB, const std::vector<glm::vec3>& edgeDirsB, const glm::vec3& centerDelta, CollisionMTV& out, const glm::vec3& offsetA, const glm::vec3& offsetB) {
@@ -128,39 +179,6 @@ bool Collider::satMTV(const std::vector<glm::vec3>& vertsA, const std::vector<gl
     float minOverlap = std::numeric_limits<float>::max();
     glm::vec3 bestAxis(0.0f);
 
-#if defined(USE_OPENMP)
-    const int m = static_cast<int>(axes.size());
-    if (m == 0) return false;
-    std::vector<float> overlaps(static_cast<size_t>(m));
-    #pragma omp parallel for
-    for (int i = 0; i < m; ++i) {
-        float aMin, aMax, bMin, bMax;
-        const glm::vec3& axis = axes[static_cast<size_t>(i)];
-        projectVertsOntoAxis(vertsA, axis, aMin, aMax, offsetA);
-        projectVertsOntoAxis(vertsB, axis, bMin, bMax, offsetB);
-        overlaps[static_cast<size_t>(i)] = std::min(aMax, bMax) - std::max(aMin, bMin);
-    }
-    for (int i = 0; i < m; ++i) {
-        if (overlaps[static_cast<size_t>(i)] <= kEps) return false;
-    }
-    int bestIdx = -1;
-    #pragma omp parallel
-    {
-        float localMin = std::numeric_limits<float>::max();
-        int localIdx = -1;
-        #pragma omp for nowait
-        for (int i = 0; i < m; ++i) {
-            float ov = overlaps[static_cast<size_t>(i)];
-            if (ov < localMin) { localMin = ov; localIdx = i; }
-        }
-        #pragma omp critical
-        {
-            if (localMin < minOverlap) { minOverlap = localMin; bestIdx = localIdx; }
-        }
-    }
-    if (minOverlap <= kEps || bestIdx < 0) return false;
-    bestAxis = axes[static_cast<size_t>(bestIdx)];
-#else
     int axisIdx = 0;
     for (const auto& axis : axes) {
         float aMin, aMax, bMin, bMax;
@@ -177,21 +195,459 @@ bool Collider::satMTV(const std::vector<glm::vec3>& vertsA, const std::vector<gl
         axisIdx++;
     }
     if (minOverlap <= kEps) return false;
-#endif
     if (glm::dot(bestAxis, centerDelta) < 0.0f) bestAxis = -bestAxis;
     out.normal = bestAxis; out.penetration = minOverlap; out.mtv = bestAxis * minOverlap; 
     return true;
 }
 
+glm::mat4 Collider::applyDelta(const glm::mat4& transform, const glm::vec3& deltaPos, const glm::vec3& deltaRot) {
+    glm::mat4 result = transform;
+    result[3] += glm::vec4(deltaPos, 0.0f);
+    if (glm::length(deltaRot) > 0.0f) {
+        glm::mat4 r(1.0f);
+        r = glm::rotate(r, glm::radians(deltaRot.x), glm::vec3(1,0,0));
+        r = glm::rotate(r, glm::radians(deltaRot.y), glm::vec3(0,1,0));
+        r = glm::rotate(r, glm::radians(deltaRot.z), glm::vec3(0,0,1));
+        result *= r;
+    }
+    return result;
+}
+
+bool Collider::gjkMTV(const ConvexShape& a, const ConvexShape& b, CollisionMTV& out) {
+    constexpr float kEps = 1e-6f;
+    GJKResult result;
+    if (!gjkPenetration(a, b, result) || result.penetration <= kEps) return false;
+    out.normal = result.normal; out.penetration = result.penetration; out.mtv = result.normal * result.penetration;
+    return true;
+}
+
+bool Collider::capsuleMTV(const ConvexShape& a, const ConvexShape& b, CollisionMTV& out) {
+    constexpr float kEps = 1e-6f;
+    const bool flip = a.kind != ConvexShape::Kind::Capsule;
+    GJKResult result;
+    if (!(flip ? capsulePenetration(b, a, result) : capsulePenetration(a, b, result)) || result.penetration <= kEps) return false;
+    out.normal = flip ? -result.normal : result.normal;
+    out.penetration = result.penetration;
+    out.mtv = out.normal * out.penetration;
+    return true;
+}
+
+static ConvexShape boxShape(const glm::mat4& transform, const glm::vec3& half) {
+    ConvexShape shape;
+    shape.kind = ConvexShape::Kind::Box;
+    shape.center = glm::vec3(transform[3]);
+    for (int i = 0; i < 3; ++i) {
+        glm::vec3 column(transform[i]);
+        float scale = glm::length(column);
+        shape.axes[i] = scale > 1e-6f ? column / scale : glm::vec3(0.0f);
+        shape.halfExtents[i] = half[i] * scale;
+    }
+    return shape;
+}
+
+static ConvexShape aabbShape(const ColliderAABB& box) {
+    ConvexShape shape;
+    shape.kind = ConvexShape::Kind::Box;
+    shape.center = 0.5f * (box.min + box.max);
+    shape.halfExtents = 0.5f * (box.max - box.min);
+    return shape;
+}
+
+static ColliderAABB boxBounds(const ConvexShape& box) {
+    glm::vec3 extent(0.0f);
+    for (int i = 0; i < 3; ++i) {
+        extent += glm::abs(box.axes[i]) * box.halfExtents[i];
+    }
+    return {box.center - extent, box.center + extent};
+}
+
+ColliderAABB Collider::shapeBounds(const ConvexShape& shape) {
+    if (shape.kind == ConvexShape::Kind::Box) {
+        return boxBounds(shape);
+    }
+    ColliderAABB bounds;
+    for (int i = 0; i < 3; ++i) {
+        glm::vec3 axis(0.0f);
+        axis[i] = 1.0f;
+        bounds.max[i] = shape.support(axis)[i];
+        bounds.min[i] = shape.support(-axis)[i];
+    }
+    return bounds;
+}
+
+// Slab test against a (possibly rotated) box. The normal is the face the ray enters through.
+bool Collider::rayBox(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const ConvexShape& box, float& distance, glm::vec3& normal) {
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+    int enterAxis = -1;
+    float enterSign = 0.0f;
+    const glm::vec3 rel = origin - box.center;
+    for (int i = 0; i < 3; ++i) {
+        const float o = glm::dot(rel, box.axes[i]);
+        const float d = glm::dot(direction, box.axes[i]);
+        const float h = box.halfExtents[i];
+        if (std::abs(d) < 1e-8f) {
+            if (o < -h || o > h) return false;
+            continue;
+        }
+        float t0 = (-h - o) / d;
+        float t1 = (h - o) / d;
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > tMin) {
+            tMin = t0;
+            enterAxis = i;
+            enterSign = d > 0.0f ? -1.0f : 1.0f;
+        }
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax) return false;
+    }
+    distance = tMin;
+    // Starting inside reports a hit at the origin facing back along the ray.
+    normal = enterAxis >= 0 ? box.axes[enterAxis] * enterSign : -direction;
+    return true;
+}
+
+// Two-sided Moller-Trumbore; the normal is flipped to face the ray.
+bool Collider::rayTriangle(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, float& distance, glm::vec3& normal) {
+    constexpr float kParallelEps = 1e-10f;
+    const glm::vec3 e1 = b - a;
+    const glm::vec3 e2 = c - a;
+    const glm::vec3 p = glm::cross(direction, e2);
+    const float det = glm::dot(e1, p);
+    if (std::abs(det) < kParallelEps) return false;
+    const float invDet = 1.0f / det;
+    const glm::vec3 s = origin - a;
+    const float u = glm::dot(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f) return false;
+    const glm::vec3 q = glm::cross(s, e1);
+    const float v = glm::dot(direction, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f) return false;
+    const float t = glm::dot(e2, q) * invDet;
+    if (t < 0.0f || t > maxDistance) return false;
+    distance = t;
+    normal = glm::normalize(glm::cross(e1, e2));
+    if (glm::dot(normal, direction) > 0.0f) normal = -normal;
+    return true;
+}
+
+static glm::vec3 barycentric(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    const glm::vec3 v0 = b - a, v1 = c - a, v2 = p - a;
+    float d00 = glm::dot(v0, v0), d01 = glm::dot(v0, v1), d11 = glm::dot(v1, v1);
+    float d20 = glm::dot(v2, v0), d21 = glm::dot(v2, v1);
+    float denom = d00 * d11 - d01 * d01;
+    if (std::abs(denom) < 1e-12f) return glm::vec3(1.0f, 0.0f, 0.0f);
+    float v = (d11 * d20 - d01 * d21) / denom;
+    float w = (d00 * d21 - d01 * d20) / denom;
+    return glm::vec3(1.0f - v - w, v, w);
+}
+
+bool Collider::triangleContact(const ConvexShape& shape, const std::array<glm::vec3, 3>& verts, uint8_t flatEdges, bool oneSided, MeshContact& out) {
+    constexpr float kEps = 1e-6f;
+    constexpr float kEdgeBary = 1e-3f;
+
+    ConvexShape triShape;
+    triShape.kind = ConvexShape::Kind::Points;
+    triShape.points = verts.data();
+    triShape.pointCount = verts.size();
+    triShape.center = (verts[0] + verts[1] + verts[2]) / 3.0f;
+
+    GJKResult result;
+    const bool hit = shape.kind == ConvexShape::Kind::Capsule ? capsulePenetration(shape, triShape, result) : gjkPenetration(shape, triShape, result);
+    if (!hit || result.penetration <= kEps) return false;
+
+    out.point = result.pointB;
+    out.normal = result.normal;
+    out.penetration = result.penetration;
+
+    glm::vec3 faceNormal = glm::cross(verts[1] - verts[0], verts[2] - verts[0]);
+    float faceLen = glm::length(faceNormal);
+    if (faceLen <= 1e-8f) return true;
+    faceNormal /= faceLen;
+    const bool behind = glm::dot(faceNormal, shape.center - verts[0]) < 0.0f;
+    if (behind && !oneSided) faceNormal = -faceNormal;
+    // Which edges does the contact lie on? Edge e is opposite vertex e+2.
+    glm::vec3 bary = barycentric(result.pointB, verts[0], verts[1], verts[2]);
+    uint8_t touching = 0;
+    for (int e = 0; e < 3; ++e) {
+        if (bary[(e + 2) % 3] < kEdgeBary) touching |= static_cast<uint8_t>(1u << e);
+    }
+    if ((touching & ~flatEdges) == 0 || (oneSided && behind)) {
+        float faceDepth = glm::dot(faceNormal, verts[0]) - glm::dot(faceNormal, shape.support(-faceNormal));
+        if (faceDepth <= kEps) return false;
+        out.normal = faceNormal;
+        out.penetration = faceDepth;
+    }
+    return true;
+}
+
+bool Collider::combineContacts(const std::vector<MeshContact>& contacts, size_t first, CollisionMTV& out) {
+    constexpr float kEps = 1e-6f;
+    if (contacts.size() <= first) return false;
+    std::vector<size_t> order;
+    order.reserve(contacts.size() - first);
+    for (size_t i = first; i < contacts.size(); ++i) order.push_back(i);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return contacts[a].penetration > contacts[b].penetration; });
+    glm::vec3 mtv(0.0f);
+    for (size_t i : order) {
+        const MeshContact& c = contacts[i];
+        float remaining = c.penetration - glm::dot(mtv, c.normal);
+        if (remaining > kEps) mtv += c.normal * remaining;
+    }
+    float len = glm::length(mtv);
+    if (len <= kEps) return false;
+    out.mtv = mtv;
+    out.normal = mtv / len;
+    out.penetration = len;
+    return true;
+}
+
+bool Collider::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const {
+    ConvexShape ray;
+    ray.kind = ConvexShape::Kind::Sphere;
+    ray.center = origin;
+    if (!shapeCast(ray, direction, maxDistance, hit)) return false;
+    hit.point = origin + direction * hit.distance;
+    if (hit.distance == 0.0f) hit.normal = -direction;
+    return true;
+}
+
+bool Collider::shapeCast(const ConvexShape& shape, const glm::vec3& direction, float maxDistance, RaycastHit& hit, glm::vec3* separatingAxis) const {
+    ShapeCastResult result;
+    if (!gjkCast(shape, direction, maxDistance, getSupportShape(), result, separatingAxis)) return false;
+    hit.collider = const_cast<Collider*>(this);
+    hit.point = result.point;
+    hit.normal = result.normal;
+    hit.distance = result.distance;
+    return true;
+}
+
+// Box vs convex hull through the general SAT, used when a pair is forced to SAT.
+bool Collider::boxConvexSAT(const glm::mat4& transform, const glm::vec3& half, const ConvexCollider& other, CollisionMTV& out) {
+    if (!other.getPolyhedron().empty()) {
+        std::array<glm::vec3, 8> boxVerts;
+        std::array<glm::vec4, 6> boxPlanes;
+        return Collider::polyhedronMTV(Collider::boxPolyhedron(transform, half, boxVerts, boxPlanes), other.getPolyhedronView(), out);
+    }
+    auto corners = Collider::buildOBBCorners(transform, half);
+    std::vector<glm::vec3> vertsA(corners.begin(), corners.end());
+    std::vector<glm::vec3> faceAxesA = { Collider::normalizeOrZero(glm::vec3(transform[0])), Collider::normalizeOrZero(glm::vec3(transform[1])), Collider::normalizeOrZero(glm::vec3(transform[2])) };
+    glm::vec3 centerA = glm::vec3(transform[3]);
+    const auto& vertsB = other.getWorldVerts();
+    if (vertsB.empty()) {
+        ColliderAABB b = other.getWorldAABB();
+        auto cornersB = Collider::cornersFromAABB(b);
+        std::vector<glm::vec3> boxVerts(cornersB.begin(), cornersB.end());
+        std::vector<glm::vec3> boxAxes = { glm::vec3(1,0,0), glm::vec3(0,1,0), glm::vec3(0,0,1) };
+        return Collider::satMTV(vertsA, faceAxesA, faceAxesA, boxVerts, boxAxes, boxAxes, centerA - 0.5f * (b.min + b.max), out);
+    }
+    return Collider::satMTV(vertsA, faceAxesA, faceAxesA, vertsB, other.getFaceAxes(), other.getEdgeDirs(), centerA - other.getWorldCenter(), out);
+}
+
+bool Collider::polyhedronMTV(const PolyhedronView& a, const PolyhedronView& b, CollisionMTV& out) {
+    constexpr float kEps = 1e-6f;
+    glm::vec3 axis(0.0f);
+    const float separation = polyhedronSeparation(a, b, axis);
+    if (separation >= -kEps) return false;
+    out.normal = -axis; out.penetration = -separation; out.mtv = out.normal * out.penetration;
+    return true;
+}
+
+PolyhedronView Collider::boxPolyhedron(const glm::mat4& transform, const glm::vec3& half, std::array<glm::vec3, 8>& vertices, std::array<glm::vec4, 6>& planes) {
+    static const ConvexPolyhedron unitBox = [] {
+        ConvexPolyhedron box;
+        std::vector<glm::vec3> corners;
+        for (int i = 0; i < 8; ++i) corners.emplace_back((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+        box.build(corners);
+        return box;
+    }();
+    unitBox.transform(glm::scale(transform, half), vertices.data(), planes.data());
+    PolyhedronView view;
+    view.shape = &unitBox;
+    view.vertices = vertices.data();
+    view.planes = planes.data();
+    view.center = glm::vec3(transform[3]);
+    return view;
+}
+
+// OBB-OBB SAT over the 15 candidate axes (3 + 3 face normals, 9 edge
+// crosses), laid out as structure-of-arrays so all axes are projected in
+// SIMD lanes. Axis 15 is padding.
+namespace {
+
+constexpr int kOBBAxisLanes = 16;
+constexpr float kMinAxisLength2 = 1e-10f;
+
+struct OBBPairLanes {
+    alignas(32) float lx[kOBBAxisLanes];
+    alignas(32) float ly[kOBBAxisLanes];
+    alignas(32) float lz[kOBBAxisLanes];
+    float a[3][3];   // A axes scaled by A half extents
+    float b[3][3];   // B axes scaled by B half extents
+    float t[3];      // centerA - centerB
+};
+
+using OBBOverlapKernel = void (*)(const OBBPairLanes&, float*);
+
+// Interval overlap along each lane's axis, normalised by the axis length. Lanes
+// with a degenerate axis (parallel edges, padding) report +max so they never win.
+void obbOverlapsScalar(const OBBPairLanes& p, float* out) {
+    for (int i = 0; i < kOBBAxisLanes; ++i) {
+        const float x = p.lx[i], y = p.ly[i], z = p.lz[i];
+        const float len2 = x * x + y * y + z * z;
+        if (len2 <= kMinAxisLength2) {
+            out[i] = std::numeric_limits<float>::max();
+            continue;
+        }
+        float rA = 0.0f, rB = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            rA += std::abs(x * p.a[k][0] + y * p.a[k][1] + z * p.a[k][2]);
+            rB += std::abs(x * p.b[k][0] + y * p.b[k][1] + z * p.b[k][2]);
+        }
+        const float d = x * p.t[0] + y * p.t[1] + z * p.t[2];
+        const float overlap = std::min(d + rA, rB) - std::max(d - rA, -rB);
+        out[i] = overlap / std::sqrt(len2);
+    }
+}
+
+#if defined(COLLIDER_X86_SIMD)
+static inline __m128 dot3SSE(__m128 x, __m128 y, __m128 z, const float* v) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(v[0])), _mm_mul_ps(y, _mm_set1_ps(v[1]))), _mm_mul_ps(z, _mm_set1_ps(v[2])));
+}
+
+void obbOverlapsSSE(const OBBPairLanes& p, float* out) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 minLen2 = _mm_set1_ps(kMinAxisLength2);
+    const __m128 invalid = _mm_set1_ps(std::numeric_limits<float>::max());
+    for (int i = 0; i < kOBBAxisLanes; i += 4) {
+        const __m128 x = _mm_load_ps(p.lx + i);
+        const __m128 y = _mm_load_ps(p.ly + i);
+        const __m128 z = _mm_load_ps(p.lz + i);
+        __m128 rA = _mm_setzero_ps();
+        __m128 rB = _mm_setzero_ps();
+        for (int k = 0; k < 3; ++k) {
+            rA = _mm_add_ps(rA, _mm_and_ps(dot3SSE(x, y, z, p.a[k]), absMask));
+            rB = _mm_add_ps(rB, _mm_and_ps(dot3SSE(x, y, z, p.b[k]), absMask));
+        }
+        const __m128 d = dot3SSE(x, y, z, p.t);
+        const __m128 overlap = _mm_sub_ps(_mm_min_ps(_mm_add_ps(d, rA), rB), _mm_max_ps(_mm_sub_ps(d, rA), _mm_sub_ps(_mm_setzero_ps(), rB)));
+        const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        const __m128 valid = _mm_cmpgt_ps(len2, minLen2);
+        const __m128 scaled = _mm_div_ps(overlap, _mm_sqrt_ps(_mm_max_ps(len2, minLen2)));
+        _mm_storeu_ps(out + i, _mm_or_ps(_mm_and_ps(valid, scaled), _mm_andnot_ps(valid, invalid)));
+    }
+}
+
+COLLIDER_TARGET_AVX static inline __m256 dot3AVX(__m256 x, __m256 y, __m256 z, const float* v) {
+    return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(v[0])), _mm256_mul_ps(y, _mm256_set1_ps(v[1]))), _mm256_mul_ps(z, _mm256_set1_ps(v[2])));
+}
+
+COLLIDER_TARGET_AVX void obbOverlapsAVX(const OBBPairLanes& p, float* out) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 minLen2 = _mm256_set1_ps(kMinAxisLength2);
+    const __m256 invalid = _mm256_set1_ps(std::numeric_limits<float>::max());
+    for (int i = 0; i < kOBBAxisLanes; i += 8) {
+        const __m256 x = _mm256_load_ps(p.lx + i);
+        const __m256 y = _mm256_load_ps(p.ly + i);
+        const __m256 z = _mm256_load_ps(p.lz + i);
+        __m256 rA = _mm256_setzero_ps();
+        __m256 rB = _mm256_setzero_ps();
+        for (int k = 0; k < 3; ++k) {
+            rA = _mm256_add_ps(rA, _mm256_and_ps(dot3AVX(x, y, z, p.a[k]), absMask));
+            rB = _mm256_add_ps(rB, _mm256_and_ps(dot3AVX(x, y, z, p.b[k]), absMask));
+        }
+        const __m256 d = dot3AVX(x, y, z, p.t);
+        const __m256 overlap = _mm256_sub_ps(_mm256_min_ps(_mm256_add_ps(d, rA), rB), _mm256_max_ps(_mm256_sub_ps(d, rA), _mm256_sub_ps(_mm256_setzero_ps(), rB)));
+        const __m256 len2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+        const __m256 valid = _mm256_cmp_ps(len2, minLen2, _CMP_GT_OQ);
+        const __m256 scaled = _mm256_div_ps(overlap, _mm256_sqrt_ps(_mm256_max_ps(len2, minLen2)));
+        _mm256_storeu_ps(out + i, _mm256_blendv_ps(invalid, scaled, valid));
+    }
+}
+
+bool cpuSupportsAVX() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    // The OS must also save the YMM registers on context switch.
+    return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+    return __builtin_cpu_supports("avx");
+#endif
+}
+#endif
+
+OBBOverlapKernel selectOBBKernel() {
+#if defined(COLLIDER_X86_SIMD)
+    if (std::getenv("PARTICLEFRONT_NO_SIMD")) return obbOverlapsScalar;
+    return cpuSupportsAVX() ? obbOverlapsAVX : obbOverlapsSSE;
+#else
+    return obbOverlapsScalar;
+#endif
+}
+
+} // namespace
+
+bool Collider::obbOverlapMTV(const ConvexShape& a, const ConvexShape& b, CollisionMTV& out) {
+    constexpr float kEps = 1e-6f;
+    static const OBBOverlapKernel kernel = selectOBBKernel();
+
+    OBBPairLanes lanes;
+    glm::vec3 axes[kOBBAxisLanes];
+    for (int i = 0; i < 3; ++i) {
+        axes[i] = a.axes[i];
+        axes[3 + i] = b.axes[i];
+        for (int j = 0; j < 3; ++j) {
+            axes[6 + i * 3 + j] = glm::cross(a.axes[i], b.axes[j]);
+        }
+    }
+    axes[15] = glm::vec3(0.0f);
+    for (int i = 0; i < kOBBAxisLanes; ++i) {
+        lanes.lx[i] = axes[i].x;
+        lanes.ly[i] = axes[i].y;
+        lanes.lz[i] = axes[i].z;
+    }
+    for (int k = 0; k < 3; ++k) {
+        glm::vec3 ea = a.axes[k] * a.halfExtents[k];
+        glm::vec3 eb = b.axes[k] * b.halfExtents[k];
+        for (int c = 0; c < 3; ++c) {
+            lanes.a[k][c] = ea[c];
+            lanes.b[k][c] = eb[c];
+        }
+    }
+    const glm::vec3 centerDelta = a.center - b.center;
+    lanes.t[0] = centerDelta.x;
+    lanes.t[1] = centerDelta.y;
+    lanes.t[2] = centerDelta.z;
+
+    alignas(32) float overlaps[kOBBAxisLanes];
+    kernel(lanes, overlaps);
+
+    int best = -1;
+    float minOverlap = std::numeric_limits<float>::max();
+    for (int i = 0; i < kOBBAxisLanes; ++i) {
+        if (overlaps[i] <= kEps) return false;
+        if (overlaps[i] < minOverlap) {
+            minOverlap = overlaps[i];
+            best = i;
+        }
+    }
+    if (best < 0) return false;
+    glm::vec3 bestAxis = axes[best] / glm::length(axes[best]);
+    if (glm::dot(bestAxis, centerDelta) < 0.0f) bestAxis = -bestAxis;
+    out.normal = bestAxis; out.penetration = minOverlap; out.mtv = bestAxis * minOverlap;
+    return true;
+}
+
 void Collider::buildConvexData(const std::vector<glm::vec3>& localVerts, const std::vector<glm::ivec3>& tris, const glm::mat4& worldTr, std::vector<glm::vec3>& outVerts, std::vector<glm::vec3>& outFaceAxes, std::vector<glm::vec3>& outEdgeDirs, glm::vec3& outCenter) {
     outVerts.clear(); outFaceAxes.clear(); outEdgeDirs.clear(); outCenter = glm::vec3(0.0f);
     outVerts.resize(localVerts.size());
-#if defined(USE_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i < static_cast<int>(localVerts.size()); ++i) {
-        outVerts[i] = (glm::vec3(worldTr * glm::vec4(localVerts[i], 1.0f)));
-    }
+    JobSystem::getInstance()->parallelFor("Collider::buildConvexData", localVerts.size(), kVertexGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            outVerts[i] = (glm::vec3(worldTr * glm::vec4(localVerts[i], 1.0f)));
+        }
+    });
     if (outVerts.empty()) return;
     for (auto& t : tris) {
         if (static_cast<size_t>(t.x) >= outVerts.size() || 
@@ -216,9 +672,6 @@ void Collider::buildConvexData(const std::vector<glm::vec3>& localVerts, const s
     }
     if (outEdgeDirs.empty()) outEdgeDirs = outFaceAxes;
     float centerX = 0.0f, centerY = 0.0f, centerZ = 0.0f;
-#if defined(USE_OPENMP)
-    #pragma omp parallel for reduction(+:centerX, centerY, centerZ)
-#endif
     for (int i = 0; i < static_cast<int>(outVerts.size()); ++i) {
         const auto& v = outVerts[i];
         centerX += v.x; centerY += v.y; centerZ += v.z;
@@ -226,7 +679,7 @@ void Collider::buildConvexData(const std::vector<glm::vec3>& localVerts, const s
     outCenter = glm::vec3(centerX, centerY, centerZ) / static_cast<float>(outVerts.size());
 }
 
-ColliderAABB ConvexCollider::getWorldAABB() const {
+ColliderAABB ConvexCollider::computeWorldAABB() const {
     ensureCacheUpdated();
     if (worldVerts.empty()) {
         glm::vec3 p = glm::vec3(const_cast<ConvexCollider*>(this)->getWorldTransform()[3]);
@@ -238,14 +691,6 @@ ColliderAABB ConvexCollider::getWorldAABB() const {
     float maxX = -std::numeric_limits<float>::max();
     float maxY = -std::numeric_limits<float>::max();
     float maxZ = -std::numeric_limits<float>::max();
-#if defined(USE_OPENMP)
-    #pragma omp parallel for reduction(min:minX, minY, minZ) reduction(max:maxX, maxY, maxZ)
-    for (int i = 0; i < static_cast<int>(worldVerts.size()); ++i) {
-        const glm::vec3& w = worldVerts[static_cast<size_t>(i)];
-        if (w.x < minX) minX = w.x; if (w.y < minY) minY = w.y; if (w.z < minZ) minZ = w.z;
-        if (w.x > maxX) maxX = w.x; if (w.y > maxY) maxY = w.y; if (w.z > maxZ) maxZ = w.z;
-    }
-#else
     for (const auto& w : worldVerts) {
         minX = glm::min(minX, w.x);
         maxX = glm::max(maxX, w.x);
@@ -254,7 +699,6 @@ ColliderAABB ConvexCollider::getWorldAABB() const {
         minZ = glm::min(minZ, w.z);
         maxZ = glm::max(maxZ, w.z);
     }
-#endif
     return ColliderAABB{ glm::vec3(minX, minY, minZ), glm::vec3(maxX, maxY, maxZ) };
 }
 
@@ -267,7 +711,32 @@ bool ConvexCollider::intersectsMTV(const Collider& other, CollisionMTV& out, con
     }
     ColliderAABB aabbOther = other.getWorldAABB();
     if (!Collider::aabbIntersects(aabbThis, aabbOther, 0.001f)) return false;
+    if (other.isConcave()) {
+        return other.collideShape(getSupportShape(deltaPos, deltaRot), aabbThis, out);
+    }
+    if (other.getColliderType() == ColliderType::Capsule) {
+        return Collider::capsuleMTV(getSupportShape(deltaPos, deltaRot), other.getSupportShape(), out);
+    }
     ensureCacheUpdated();
+    if (CollisionWorld::getInstance()->getNarrowphase(*this, other) == Narrowphase::GJK) {
+        return Collider::gjkMTV(getSupportShape(deltaPos, deltaRot), other.getSupportShape(), out);
+    }
+    if (!polyhedron.empty()) {
+        std::array<glm::vec3, 8> boxVerts;
+        std::array<glm::vec4, 6> boxPlanes;
+        const glm::mat4 otherTr = const_cast<Collider*>(&other)->getWorldTransform();
+        if (other.getColliderType() == ColliderType::OBB) {
+            return Collider::polyhedronMTV(getPolyhedronView(deltaPos), Collider::boxPolyhedron(otherTr, static_cast<const OBBCollider&>(other).getHalfSize(), boxVerts, boxPlanes), out);
+        }
+        if (other.getColliderType() == ColliderType::AABB) {
+            const ColliderAABB b = other.getWorldAABB();
+            return Collider::polyhedronMTV(getPolyhedronView(deltaPos), Collider::boxPolyhedron(glm::translate(glm::mat4(1.0f), 0.5f * (b.min + b.max)), 0.5f * (b.max - b.min), boxVerts, boxPlanes), out);
+        }
+        const auto& cvx = static_cast<const ConvexCollider&>(other);
+        if (!cvx.getPolyhedron().empty()) {
+            return Collider::polyhedronMTV(getPolyhedronView(deltaPos), cvx.getPolyhedronView(), out);
+        }
+    }
     const std::vector<glm::vec3>& vertsA = worldVerts;
     const std::vector<glm::vec3>& faceAxesA = faceAxesCached;
     const std::vector<glm::vec3>& edgesA = edgeDirsCached;
@@ -302,6 +771,35 @@ bool ConvexCollider::intersectsMTV(const Collider& other, CollisionMTV& out, con
     return Collider::satMTV(vertsA, faceAxesA, edgesA, vertsB, faceAxesB, edgesB, centerA - centerB, out, deltaPos);
 }
 
+PolyhedronView ConvexCollider::getPolyhedronView(const glm::vec3& offset) const {
+    ensureCacheUpdated();
+    PolyhedronView view;
+    view.shape = &polyhedron;
+    view.vertices = hullVerts.data();
+    view.planes = hullPlanes.data();
+    view.center = worldCenter;
+    view.offset = offset;
+    return view;
+}
+
+ConvexShape ConvexCollider::computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
+    (void)deltaRot;
+    ensureCacheUpdated();
+    if (worldVerts.empty()) {
+        ColliderAABB box = computeWorldAABB();
+        box.min += deltaPos;
+        box.max += deltaPos;
+        return aabbShape(box);
+    }
+    ConvexShape shape;
+    shape.kind = ConvexShape::Kind::Points;
+    shape.points = worldVerts.data();
+    shape.pointCount = worldVerts.size();
+    shape.offset = deltaPos;
+    shape.center = worldCenter + deltaPos;
+    return shape;
+}
+
 void ConvexCollider::setVertices(const std::vector<float>& positions, const std::vector<uint32_t>& indices, const glm::vec3& rotationDegrees) {
     localVertices.clear();
     const size_t vcount = positions.size() / 3;
@@ -313,24 +811,20 @@ void ConvexCollider::setVertices(const std::vector<float>& positions, const std:
         rotMat = glm::rotate(rotMat, glm::radians(rotationDegrees.z), glm::vec3(0.0f, 0.0f, 1.0f));
     }
 
-#if defined(USE_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i < static_cast<int>(vcount); ++i) {
-        glm::vec3 v(positions[i*3 + 0], positions[i*3 + 1], positions[i*3 + 2]);
-        if (glm::length(rotationDegrees) > 0.001f) {
-            v = glm::vec3(rotMat * glm::vec4(v, 1.0f));
+    JobSystem::getInstance()->parallelFor("ConvexCollider::setVertices", vcount, kVertexGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 v(positions[i*3 + 0], positions[i*3 + 1], positions[i*3 + 2]);
+            if (glm::length(rotationDegrees) > 0.001f) {
+                v = glm::vec3(rotMat * glm::vec4(v, 1.0f));
+            }
+            localVertices[i] = v;
         }
-        localVertices[i] = v;
-    }
+    });
 
     triangles.clear();
     const size_t tcount = indices.size() / 3;
     triangles.resize(tcount);
-#if defined(USE_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int t = 0; t < static_cast<int>(tcount); ++t) {
+    for (size_t t = 0; t < tcount; ++t) {
         uint32_t i0 = indices[t*3 + 0];
         uint32_t i1 = indices[t*3 + 1];
         uint32_t i2 = indices[t*3 + 2];
@@ -338,7 +832,9 @@ void ConvexCollider::setVertices(const std::vector<float>& positions, const std:
             triangles[t] = glm::ivec3(static_cast<int>(i0), static_cast<int>(i1), static_cast<int>(i2));
         }
     }
+    polyhedron.build(localVertices);
     cacheValid = false;
+    CollisionWorld::getInstance()->updateCollider(this);
 }
 
 void ConvexCollider::setVerticesInterleaved(const std::vector<float>& interleaved, size_t strideFloats, size_t positionOffsetFloats, const std::vector<uint32_t>& indices, const glm::vec3& rotationDegrees) {
@@ -375,10 +871,13 @@ void ConvexCollider::setVerticesInterleaved(const std::vector<float>& interleave
             triangles.emplace_back(static_cast<int>(i0), static_cast<int>(i1), static_cast<int>(i2));
         }
     }
+    polyhedron.build(localVertices);
     cacheValid = false;
+    CollisionWorld::getInstance()->updateCollider(this);
 }
 
 void ConvexCollider::ensureCacheUpdated() const {
+    if (cacheValid && isBaked()) return;
     glm::mat4 tr = const_cast<ConvexCollider*>(this)->getWorldTransform();
     bool same = cacheValid;
     if (same) {
@@ -394,31 +893,44 @@ void ConvexCollider::ensureCacheUpdated() const {
     if (!same) {
         worldVerts.clear(); faceAxesCached.clear(); edgeDirsCached.clear(); worldCenter = glm::vec3(0.0f);
         worldVerts.resize(localVertices.size());
-#if defined(USE_OPENMP)
-        #pragma omp parallel for
-#endif
-        for (int i = 0; i < static_cast<int>(localVertices.size()); ++i) {
-            worldVerts[i] = glm::vec3(tr * glm::vec4(localVertices[i], 1.0f));
-        }
+        JobSystem::getInstance()->parallelFor("ConvexCollider::ensureCacheUpdated", localVertices.size(), kVertexGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                worldVerts[i] = glm::vec3(tr * glm::vec4(localVertices[i], 1.0f));
+            }
+        });
         
         if (!worldVerts.empty()) {
-            for (const auto& t : triangles) {
-                if (static_cast<size_t>(t.x) >= worldVerts.size() || 
-                    static_cast<size_t>(t.y) >= worldVerts.size() || 
-                    static_cast<size_t>(t.z) >= worldVerts.size()) {
-                    continue;
+            if (!polyhedron.empty()) {
+                // The hull's merged faces and creases are already unique.
+                hullVerts.resize(polyhedron.vertices.size());
+                hullPlanes.resize(polyhedron.planes.size());
+                polyhedron.transform(tr, hullVerts.data(), hullPlanes.data());
+                for (const auto& plane : hullPlanes) {
+                    Collider::addAxisUnique(faceAxesCached, glm::vec3(plane));
+                }
+                const auto& edges = polyhedron.edges;
+                for (size_t e = 0; e < edges.size(); e += 2) {
+                    Collider::addAxisUnique(edgeDirsCached, hullVerts[edges[e + 1].origin] - hullVerts[edges[e].origin]);
                 }
-                glm::vec3 a = worldVerts[static_cast<size_t>(t.x)];
-                glm::vec3 b = worldVerts[static_cast<size_t>(t.y)];
-                glm::vec3 c = worldVerts[static_cast<size_t>(t.z)];
-                glm::vec3 normal = glm::cross(b - a, c - a);
-                float len = glm::length(normal);
-                if (len > 1e-6f) {
-                    Collider::addAxisUnique(faceAxesCached, normal / len);
+            } else {
+                for (const auto& t : triangles) {
+                    if (static_cast<size_t>(t.x) >= worldVerts.size() || 
+                        static_cast<size_t>(t.y) >= worldVerts.size() || 
+                        static_cast<size_t>(t.z) >= worldVerts.size()) {
+                        continue;
+                    }
+                    glm::vec3 a = worldVerts[static_cast<size_t>(t.x)];
+                    glm::vec3 b = worldVerts[static_cast<size_t>(t.y)];
+                    glm::vec3 c = worldVerts[static_cast<size_t>(t.z)];
+                    glm::vec3 normal = glm::cross(b - a, c - a);
+                    float len = glm::length(normal);
+                    if (len > 1e-6f) {
+                        Collider::addAxisUnique(faceAxesCached, normal / len);
+                    }
+                    Collider::addAxisUnique(edgeDirsCached, Collider::normalizeOrZero(b-a));
+                    Collider::addAxisUnique(edgeDirsCached, Collider::normalizeOrZero(c-b));
+                    Collider::addAxisUnique(edgeDirsCached, Collider::normalizeOrZero(a-c));
                 }
-                Collider::addAxisUnique(edgeDirsCached, Collider::normalizeOrZero(b-a));
-                Collider::addAxisUnique(edgeDirsCached, Collider::normalizeOrZero(c-b));
-                Collider::addAxisUnique(edgeDirsCached, Collider::normalizeOrZero(a-c));
             }
             if (faceAxesCached.empty()) {
                 faceAxesCached = { glm::vec3(1,0,0), glm::vec3(0,1,0), glm::vec3(0,0,1) };
@@ -426,9 +938,6 @@ void ConvexCollider::ensureCacheUpdated() const {
             if (edgeDirsCached.empty()) edgeDirsCached = faceAxesCached;
             
             float centerX = 0.0f, centerY = 0.0f, centerZ = 0.0f;
-#if defined(USE_OPENMP)
-            #pragma omp parallel for reduction(+:centerX, centerY, centerZ)
-#endif
             for (int i = 0; i < static_cast<int>(worldVerts.size()); ++i) {
                 const auto& v = worldVerts[static_cast<size_t>(i)];
                 centerX += v.x; centerY += v.y; centerZ += v.z;
@@ -441,103 +950,113 @@ void ConvexCollider::ensureCacheUpdated() const {
 }
 
 bool OBBCollider::intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
-    glm::mat4 baseThis = const_cast<OBBCollider*>(this)->getWorldTransform();
-    glm::mat4 thisTransform = baseThis;
-    thisTransform[3] += glm::vec4(deltaPos, 0.0f);
-    if (glm::length(deltaRot) > 0.0f) {
-        glm::mat4 r(1.0f);
-        r = glm::rotate(r, glm::radians(deltaRot.x), glm::vec3(1,0,0));
-        r = glm::rotate(r, glm::radians(deltaRot.y), glm::vec3(0,1,0));
-        r = glm::rotate(r, glm::radians(deltaRot.z), glm::vec3(0,0,1));
-        thisTransform *= r;
-    }
-
-    auto cornersA = Collider::buildOBBCorners(thisTransform, halfSize);
-    ColliderAABB aabbA = Collider::aabbFromCorners(cornersA);
+    ConvexShape boxA = getSupportShape(deltaPos, deltaRot);
+    ColliderAABB aabbA = boxBounds(boxA);
     ColliderAABB aabbB = other.getWorldAABB();
     if (!Collider::aabbIntersects(aabbA, aabbB, 0.001f)) return false;
-    std::vector<glm::vec3> vertsA(cornersA.begin(), cornersA.end());
-    std::vector<glm::vec3> faceAxesA = { Collider::normalizeOrZero(glm::vec3(thisTransform[0])), Collider::normalizeOrZero(glm::vec3(thisTransform[1])), Collider::normalizeOrZero(glm::vec3(thisTransform[2])) };
-    std::vector<glm::vec3> edgesA = faceAxesA;
-    glm::vec3 centerA = glm::vec3(thisTransform[3]);
-
-    glm::mat4 otherTr = const_cast<Collider*>(&other)->getWorldTransform();
-    std::vector<glm::vec3> vertsB; std::vector<glm::vec3> faceAxesB; std::vector<glm::vec3> edgesB; glm::vec3 centerB(0.0f);
+    if (other.isConcave()) {
+        return other.collideShape(boxA, aabbA, out);
+    }
+    if (other.getColliderType() == ColliderType::Capsule) {
+        return Collider::capsuleMTV(boxA, other.getSupportShape(), out);
+    }
+    if (CollisionWorld::getInstance()->getNarrowphase(*this, other) == Narrowphase::GJK) {
+        return Collider::gjkMTV(boxA, other.getSupportShape(), out);
+    }
     if (other.getColliderType() == ColliderType::OBB) {
-        auto cornersB = Collider::buildOBBCorners(otherTr, static_cast<const OBBCollider&>(other).getHalfSize());
-        vertsB.assign(cornersB.begin(), cornersB.end());
-        faceAxesB = { Collider::normalizeOrZero(glm::vec3(otherTr[0])), Collider::normalizeOrZero(glm::vec3(otherTr[1])), Collider::normalizeOrZero(glm::vec3(otherTr[2])) };
-        edgesB = faceAxesB;
-        centerB = glm::vec3(otherTr[3]);
-    } else if (other.getColliderType() == ColliderType::AABB) {
-        ColliderAABB box = other.getWorldAABB();
-        auto corners = Collider::cornersFromAABB(box);
-        vertsB.assign(corners.begin(), corners.end());
-        faceAxesB = { glm::vec3(1,0,0), glm::vec3(0,1,0), glm::vec3(0,0,1) };
-        edgesB = faceAxesB;
-        centerB = 0.5f * (box.min + box.max);
-    } else {
-        const auto& cvx = static_cast<const ConvexCollider&>(other);
-        const auto& oVerts = cvx.getWorldVerts();
-        if (!oVerts.empty()) {
-            vertsB = oVerts;
-            faceAxesB = cvx.getFaceAxes();
-            edgesB = cvx.getEdgeDirs();
-            centerB = cvx.getWorldCenter();
-        } else {
-            ColliderAABB box = other.getWorldAABB();
-            auto corners = Collider::cornersFromAABB(box);
-            vertsB.assign(corners.begin(), corners.end());
-            faceAxesB = { glm::vec3(1,0,0), glm::vec3(0,1,0), glm::vec3(0,0,1) };
-            edgesB = faceAxesB;
-            centerB = 0.5f * (box.min + box.max);
-        }
+        return Collider::obbOverlapMTV(boxA, other.getSupportShape(), out);
+    }
+    if (other.getColliderType() == ColliderType::AABB) {
+        return Collider::obbOverlapMTV(boxA, aabbShape(aabbB), out);
     }
-    return Collider::satMTV(vertsA, faceAxesA, edgesA, vertsB, faceAxesB, edgesB, centerA - centerB, out);
+    const glm::mat4 thisTransform = Collider::applyDelta(const_cast<OBBCollider*>(this)->getWorldTransform(), deltaPos, deltaRot);
+    return Collider::boxConvexSAT(thisTransform, halfSize, static_cast<const ConvexCollider&>(other), out);
+}
+
+ColliderAABB OBBCollider::computeWorldAABB() const {
+    return boxBounds(computeSupportShape(glm::vec3(0.0f), glm::vec3(0.0f)));
+}
+
+ConvexShape OBBCollider::computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
+    return boxShape(Collider::applyDelta(const_cast<OBBCollider*>(this)->getWorldTransform(), deltaPos, deltaRot), halfSize);
+}
+
+bool OBBCollider::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const {
+    float distance = 0.0f;
+    glm::vec3 normal(0.0f);
+    if (!rayBox(origin, direction, maxDistance, getSupportShape(), distance, normal)) return false;
+    hit = {const_cast<OBBCollider*>(this), origin + direction * distance, normal, distance};
+    return true;
 }
 
 bool AABBCollider::intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
     (void)deltaRot;
-    glm::mat4 tr = const_cast<AABBCollider*>(this)->getWorldTransform();
-    tr[3] += glm::vec4(deltaPos, 0.0f);
+    ConvexShape boxA = getSupportShape(deltaPos, glm::vec3(0.0f));
+    ColliderAABB aabbA = boxBounds(boxA);
+    ColliderAABB aabbB = other.getWorldAABB();
     if (other.getColliderType() == ColliderType::AABB) {
-        ColliderAABB a = Collider::aabbFromCorners(Collider::buildOBBCorners(tr, half));
-        ColliderAABB b = other.getWorldAABB();
-        return Collider::aabbOverlapMTV(a,b,out);
+        return Collider::aabbOverlapMTV(aabbA, aabbB, out);
     }
-    auto cornersA = Collider::buildOBBCorners(tr, half);
-    ColliderAABB aabbA = Collider::aabbFromCorners(cornersA);
-    ColliderAABB aabbB = other.getWorldAABB();
     if (!Collider::aabbIntersects(aabbA, aabbB, 0.001f)) return false;
+    if (other.isConcave()) {
+        return other.collideShape(boxA, aabbA, out);
+    }
+    if (other.getColliderType() == ColliderType::Capsule) {
+        return Collider::capsuleMTV(boxA, other.getSupportShape(), out);
+    }
+    if (CollisionWorld::getInstance()->getNarrowphase(*this, other) == Narrowphase::GJK) {
+        return Collider::gjkMTV(boxA, other.getSupportShape(), out);
+    }
+    if (other.getColliderType() == ColliderType::OBB) {
+        return Collider::obbOverlapMTV(boxA, other.getSupportShape(), out);
+    }
+    glm::mat4 tr = const_cast<AABBCollider*>(this)->getWorldTransform();
+    tr[3] += glm::vec4(deltaPos, 0.0f);
+    return Collider::boxConvexSAT(tr, half, static_cast<const ConvexCollider&>(other), out);
+}
 
-    std::vector<glm::vec3> vertsA(cornersA.begin(), cornersA.end());
-    std::vector<glm::vec3> faceAxesA = { Collider::normalizeOrZero(glm::vec3(tr[0])), Collider::normalizeOrZero(glm::vec3(tr[1])), Collider::normalizeOrZero(glm::vec3(tr[2])) };
-    std::vector<glm::vec3> edgesA = faceAxesA;
-    glm::vec3 centerA = glm::vec3(tr[3]);
+ColliderAABB AABBCollider::computeWorldAABB() const {
+    return boxBounds(computeSupportShape(glm::vec3(0.0f), glm::vec3(0.0f)));
+}
 
-    glm::mat4 otherTr = const_cast<Collider*>(&other)->getWorldTransform();
-    std::vector<glm::vec3> vertsB; std::vector<glm::vec3> faceAxesB; std::vector<glm::vec3> edgesB; glm::vec3 centerB(0.0f);
-    if (other.getColliderType() == ColliderType::OBB) {
-        auto cornersB = Collider::buildOBBCorners(otherTr, static_cast<const OBBCollider&>(other).getHalfSize());
-        vertsB.assign(cornersB.begin(), cornersB.end());
-        faceAxesB = { Collider::normalizeOrZero(glm::vec3(otherTr[0])), Collider::normalizeOrZero(glm::vec3(otherTr[1])), Collider::normalizeOrZero(glm::vec3(otherTr[2])) };
-        edgesB = faceAxesB;
-        centerB = glm::vec3(otherTr[3]);
-    } else { // Convex
-        const auto& cvx = static_cast<const ConvexCollider&>(other);
-        const auto& oVerts = cvx.getWorldVerts();
-        if (!oVerts.empty()) {
-            vertsB = oVerts;
-            faceAxesB = cvx.getFaceAxes();
-            edgesB = cvx.getEdgeDirs();
-            centerB = cvx.getWorldCenter();
-        } else {
-            ColliderAABB b = other.getWorldAABB();
-            auto corners = Collider::cornersFromAABB(b);
-            vertsB.assign(corners.begin(), corners.end());
-            faceAxesB = { glm::vec3(1,0,0), glm::vec3(0,1,0), glm::vec3(0,0,1) };
-            edgesB = faceAxesB; centerB = 0.5f * (b.min + b.max);
-        }
+ConvexShape AABBCollider::computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
+    (void)deltaRot;
+    glm::mat4 tr = const_cast<AABBCollider*>(this)->getWorldTransform();
+    tr[3] += glm::vec4(deltaPos, 0.0f);
+    return boxShape(tr, half);
+}
+
+bool AABBCollider::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const {
+    float distance = 0.0f;
+    glm::vec3 normal(0.0f);
+    if (!rayBox(origin, direction, maxDistance, aabbShape(getWorldAABB()), distance, normal)) return false;
+    hit = {const_cast<AABBCollider*>(this), origin + direction * distance, normal, distance};
+    return true;
+}
+
+bool CapsuleCollider::intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
+    const ConvexShape capsule = getSupportShape(deltaPos, deltaRot);
+    const ColliderAABB bounds = shapeBounds(capsule);
+    const ColliderAABB otherBounds = other.getWorldAABB();
+    if (!Collider::aabbIntersects(bounds, otherBounds, 0.001f)) return false;
+    if (other.isConcave()) {
+        return other.collideShape(capsule, bounds, out);
     }
-    return Collider::satMTV(vertsA, faceAxesA, edgesA, vertsB, faceAxesB, edgesB, centerA - centerB, out);
+    if (other.getColliderType() == ColliderType::AABB) {
+        return Collider::capsuleMTV(capsule, aabbShape(otherBounds), out);
+    }
+    return Collider::capsuleMTV(capsule, other.getSupportShape(), out);
+}
+
+ConvexShape CapsuleCollider::computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
+    const glm::mat4 tr = Collider::applyDelta(const_cast<CapsuleCollider*>(this)->getWorldTransform(), deltaPos, deltaRot);
+    const glm::vec3 up(tr[1]);
+    const float scaleY = glm::length(up);
+    ConvexShape shape;
+    shape.kind = ConvexShape::Kind::Capsule;
+    shape.center = glm::vec3(tr[3]);
+    shape.axes[1] = scaleY > 1e-6f ? up / scaleY : glm::vec3(0.0f, 1.0f, 0.0f);
+    shape.radius = radius * std::max(glm::length(glm::vec3(tr[0])), glm::length(glm::vec3(tr[2])));
+    shape.halfLength = std::max(halfHeight * scaleY - shape.radius, 0.0f);
+    return shape;
 }
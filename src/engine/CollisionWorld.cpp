@@ -0,0 +1,347 @@
+#include <CollisionWorld.h>
+#include <Collider.h>
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+    // A cached trigger overlap is trusted while the pair drifts by less than
+    // this share of its depth, which leaves room for EPA's tolerance.
+    constexpr float kReuseFraction = 0.5f;
+    // Colliders whose transform stayed put for this many refits are baked.
+    constexpr uint32_t kIdleRefitsBeforeBake = 30;
+
+    bool sameOrientation(const glm::mat4& a, const glm::mat4& b) {
+        return glm::vec3(a[0]) == glm::vec3(b[0]) && glm::vec3(a[1]) == glm::vec3(b[1]) && glm::vec3(a[2]) == glm::vec3(b[2]);
+    }
+}
+
+CollisionWorld* CollisionWorld::getInstance() {
+    static CollisionWorld instance;
+    return &instance;
+}
+
+void CollisionWorld::addCollider(Collider* collider) {
+    if (!collider || collider->proxyId != DynamicAABBTree::kNullNode) return;
+    collider->baked = false;
+    collider->idleRefits = 0;
+    collider->updateWorldTransform();
+    ColliderAABB aabb = collider->getWorldAABB();
+    collider->proxyId = tree.createProxy(aabb, collider, collider->collisionLayer);
+    collider->proxyTransform = collider->getWorldTransform();
+    collider->proxyCenter = 0.5f * (aabb.min + aabb.max);
+    collider->worldIndex = colliders.size();
+    colliders.push_back(collider);
+    if (collider->trigger) {
+        triggers.push_back(collider);
+    }
+    if (collider->staticHint) {
+        collider->bake();
+    }
+}
+
+void CollisionWorld::removeCollider(Collider* collider) {
+    if (!collider || collider->proxyId == DynamicAABBTree::kNullNode) return;
+    tree.destroyProxy(collider->proxyId);
+    collider->proxyId = DynamicAABBTree::kNullNode;
+    if (!narrowphaseOverrides.empty()) {
+        for (auto it = narrowphaseOverrides.begin(); it != narrowphaseOverrides.end();) {
+            if (it->first.first == collider || it->first.second == collider) {
+                it = narrowphaseOverrides.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    const size_t index = collider->worldIndex;
+    if (index < colliders.size() && colliders[index] == collider) {
+        colliders[index] = colliders.back();
+        colliders[index]->worldIndex = index;
+        colliders.pop_back();
+    }
+    if (collider->trigger) {
+        triggers.erase(std::remove(triggers.begin(), triggers.end(), collider), triggers.end());
+    }
+    triggerContacts.forget(collider);
+    dropTriggerPairs(collider);
+}
+
+void CollisionWorld::updateFilter(Collider* collider) {
+    if (!collider || collider->proxyId == DynamicAABBTree::kNullNode) return;
+    tree.setProxyLayers(collider->proxyId, collider->collisionLayer);
+    auto it = std::find(triggers.begin(), triggers.end(), collider);
+    if (collider->trigger && it == triggers.end()) {
+        triggers.push_back(collider);
+    } else if (!collider->trigger && it != triggers.end()) {
+        triggers.erase(it);
+        dropTriggerPairs(collider);
+    }
+}
+
+void CollisionWorld::dropTriggerPairs(Collider* collider) {
+    for (auto& [pair, event] : pendingEvents) {
+        if (pair.first == collider || pair.second == collider) {
+            pair = {nullptr, nullptr};
+        }
+    }
+    std::vector<TriggerPair> ended;
+    for (auto it = triggerPairs.begin(); it != triggerPairs.end();) {
+        if (it->first == collider || it->second == collider) {
+            ended.push_back(*it);
+            it = triggerPairs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    // Only whoever is left behind hears about it; the collider itself may be mid-destruction.
+    for (const TriggerPair& pair : ended) {
+        raise(pair.first == collider ? pair.second : pair.first, collider, TriggerEvent::Exit);
+    }
+}
+
+void CollisionWorld::updateTriggers() {
+    currentPairs.clear();
+    for (Collider* trigger : triggers) {
+        const ColliderAABB bounds = trigger->getWorldAABB();
+        tree.query(bounds, trigger->collisionMask, [&](int32_t proxyId) {
+            Collider* other = tree.getCollider(proxyId);
+            if (other->trigger || other->getParent() == trigger->getParent() || !trigger->canCollideWith(*other)) return true;
+            if (!DynamicAABBTree::overlaps(bounds, other->getWorldAABB())) return true;
+            if (triggerOverlaps(trigger, other)) {
+                currentPairs.emplace_back(trigger, other);
+            }
+            return true;
+        });
+    }
+    triggerContacts.endStep();
+
+    // Events go out in discovery order: exits first, then enters and stays.
+    pendingEvents.clear();
+    sortedPairs.assign(currentPairs.begin(), currentPairs.end());
+    std::sort(sortedPairs.begin(), sortedPairs.end());
+    for (const TriggerPair& pair : triggerPairs) {
+        if (!std::binary_search(sortedPairs.begin(), sortedPairs.end(), pair)) {
+            pendingEvents.emplace_back(pair, TriggerEvent::Exit);
+        }
+    }
+    sortedPairs.assign(triggerPairs.begin(), triggerPairs.end());
+    std::sort(sortedPairs.begin(), sortedPairs.end());
+    for (const TriggerPair& pair : currentPairs) {
+        const bool wasInside = std::binary_search(sortedPairs.begin(), sortedPairs.end(), pair);
+        pendingEvents.emplace_back(pair, wasInside ? TriggerEvent::Stay : TriggerEvent::Enter);
+    }
+    triggerPairs.swap(currentPairs);
+}
+
+// Most trigger pairs are either well apart or well inside each other and
+// barely move between steps, so the previous answer is checked before the
+// narrowphase runs: a cached axis that still separates the support shapes
+// proves they are apart, and a pair that kept its orientations and moved by
+// less than its penetration depth must still overlap.
+bool CollisionWorld::triggerOverlaps(Collider* trigger, Collider* other) {
+    ContactCache::Entry& cached = triggerContacts.at(trigger, other);
+    const glm::mat4 transformA = trigger->getWorldTransform();
+    const glm::mat4 transformB = other->getWorldTransform();
+    if (cached.depth > 0.0f) {
+        const bool rotated = !sameOrientation(transformA, cached.transformA) || !sameOrientation(transformB, cached.transformB);
+        const glm::vec3 drift = (glm::vec3(transformA[3]) - glm::vec3(cached.transformA[3])) - (glm::vec3(transformB[3]) - glm::vec3(cached.transformB[3]));
+        if (!rotated && glm::dot(drift, drift) < cached.depth * cached.depth * kReuseFraction * kReuseFraction) return true;
+    }
+    const ConvexShape shapeA = trigger->getSupportShape();
+    const ConvexShape shapeB = other->getSupportShape();
+    if (cached.axis != glm::vec3(0.0f) && separatedAlong(shapeA, shapeB, cached.axis)) return false;
+
+    CollisionMTV mtv{};
+    if (trigger->intersectsMTV(*other, mtv)) {
+        // A mesh is hollow, so its depth says nothing about how far it can move.
+        const bool solid = !trigger->isConcave() && !other->isConcave();
+        cached.depth = solid ? mtv.penetration : 0.0f;
+        cached.transformA = transformA;
+        cached.transformB = transformB;
+        cached.axis = glm::vec3(0.0f);
+        return true;
+    }
+    cached.depth = 0.0f;
+    GJKResult separation;
+    cached.axis = gjkDistance(shapeA, shapeB, separation, cached.axis != glm::vec3(0.0f) ? &cached.axis : nullptr) ? glm::vec3(0.0f) : separation.normal;
+    return false;
+}
+
+void CollisionWorld::dispatchTriggerEvents() {
+    // Callbacks may remove colliders, which clears their pending events, so
+    // re-check the pair before each side is called.
+    for (size_t i = 0; i < pendingEvents.size(); ++i) {
+        if (!pendingEvents[i].first.first) continue;
+        const auto [pair, event] = pendingEvents[i];
+        raise(pair.first, pair.second, event);
+        if (pendingEvents[i].first.first) {
+            raise(pair.second, pair.first, event);
+        }
+    }
+    pendingEvents.clear();
+}
+
+void CollisionWorld::raise(Collider* self, Collider* other, TriggerEvent event) {
+    switch (event) {
+        case TriggerEvent::Enter: self->onTriggerEnter(other); break;
+        case TriggerEvent::Stay: self->onTriggerStay(other); break;
+        case TriggerEvent::Exit: self->onTriggerExit(other); break;
+    }
+}
+
+void CollisionWorld::updateCollider(Collider* collider) {
+    if (!collider || collider->proxyId == DynamicAABBTree::kNullNode) return;
+    // An explicit update may follow a change baking cannot see, like new vertices.
+    collider->baked = false;
+    if (collider->staticHint) {
+        collider->bake();
+    }
+    ColliderAABB aabb = collider->getWorldAABB();
+    glm::vec3 center = 0.5f * (aabb.min + aabb.max);
+    tree.moveProxy(collider->proxyId, aabb, center - collider->proxyCenter);
+    collider->proxyTransform = collider->getWorldTransform();
+    collider->proxyCenter = center;
+}
+
+// A baked collider has not moved since it was baked, so it is skipped
+// without even comparing transforms.
+void CollisionWorld::refit() {
+    for (Collider* collider : colliders) {
+        if (collider->baked) continue;
+        if (collider->getWorldTransform() != collider->proxyTransform) {
+            updateCollider(collider);
+            collider->idleRefits = 0;
+        } else if (++collider->idleRefits >= kIdleRefitsBeforeBake || collider->staticHint) {
+            collider->bake();
+        }
+    }
+}
+
+void CollisionWorld::prepareQueries() const {
+    for (const Collider* collider : colliders) {
+        collider->prepareQueries();
+    }
+}
+
+void CollisionWorld::queryAABB(const ColliderAABB& aabb, std::vector<Collider*>& out, uint32_t layerMask) const {
+    tree.query(aabb, layerMask, [&](int32_t proxyId) {
+        out.push_back(tree.getCollider(proxyId));
+        return true;
+    });
+}
+
+size_t CollisionWorld::cast(const ConvexShape* shape, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const QueryFilter& filter, RaycastHit* closest, std::vector<RaycastHit>* all) const {
+    const float len = glm::length(direction);
+    if (len < 1e-8f || maxDistance < 0.0f) return 0;
+    const glm::vec3 dir = direction / len;
+
+    // Shapes are cast through the tree as their bounds' centre against boxes
+    // grown by the bounds' half size.
+    glm::vec3 treeOrigin = origin;
+    glm::vec3 extent(0.0f);
+    if (shape) {
+        const ColliderAABB bounds = Collider::shapeBounds(*shape);
+        treeOrigin = 0.5f * (bounds.min + bounds.max);
+        extent = 0.5f * (bounds.max - bounds.min);
+    }
+
+    const size_t firstHit = all ? all->size() : 0;
+    size_t count = 0;
+    tree.rayCast(treeOrigin, dir, maxDistance, extent, filter.mask, [&](int32_t proxyId, float maxSoFar) {
+        const Collider* collider = tree.getCollider(proxyId);
+        if (!filter.passes(collider)) return maxSoFar;
+        RaycastHit hit;
+        glm::vec3* axis = filter.contacts && shape ? &filter.contacts->at(filter.ignore, collider).axis : nullptr;
+        const bool didHit = shape ? collider->shapeCast(*shape, dir, maxSoFar, hit, axis) : collider->raycast(origin, dir, maxSoFar, hit);
+        if (!didHit) return maxSoFar;
+        ++count;
+        if (all) {
+            all->push_back(hit);
+            return maxSoFar;
+        }
+        *closest = hit;
+        return hit.distance;
+    });
+    if (all) {
+        std::sort(all->begin() + static_cast<std::ptrdiff_t>(firstHit), all->end(), [](const RaycastHit& a, const RaycastHit& b) {
+            return a.distance < b.distance;
+        });
+    }
+    return count;
+}
+
+ConvexShape CollisionWorld::boxCastShape(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec3& rotation) {
+    glm::mat4 r(1.0f);
+    r = glm::rotate(r, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    r = glm::rotate(r, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    r = glm::rotate(r, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    ConvexShape shape;
+    shape.kind = ConvexShape::Kind::Box;
+    shape.center = center;
+    for (int i = 0; i < 3; ++i) {
+        shape.axes[i] = glm::vec3(r[i]);
+    }
+    shape.halfExtents = halfExtents;
+    return shape;
+}
+
+bool CollisionWorld::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit, const QueryFilter& filter) const {
+    return cast(nullptr, origin, direction, maxDistance, filter, &hit, nullptr) > 0;
+}
+
+size_t CollisionWorld::raycastAll(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<RaycastHit>& hits, const QueryFilter& filter) const {
+    return cast(nullptr, origin, direction, maxDistance, filter, nullptr, &hits);
+}
+
+bool CollisionWorld::sphereCast(const glm::vec3& origin, float radius, const glm::vec3& direction, float maxDistance, RaycastHit& hit, const QueryFilter& filter) const {
+    ConvexShape sphere;
+    sphere.kind = ConvexShape::Kind::Sphere;
+    sphere.center = origin;
+    sphere.radius = radius;
+    return cast(&sphere, origin, direction, maxDistance, filter, &hit, nullptr) > 0;
+}
+
+size_t CollisionWorld::sphereCastAll(const glm::vec3& origin, float radius, const glm::vec3& direction, float maxDistance, std::vector<RaycastHit>& hits, const QueryFilter& filter) const {
+    ConvexShape sphere;
+    sphere.kind = ConvexShape::Kind::Sphere;
+    sphere.center = origin;
+    sphere.radius = radius;
+    return cast(&sphere, origin, direction, maxDistance, filter, nullptr, &hits);
+}
+
+bool CollisionWorld::boxCast(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec3& rotation, const glm::vec3& direction, float maxDistance, RaycastHit& hit, const QueryFilter& filter) const {
+    const ConvexShape box = boxCastShape(center, halfExtents, rotation);
+    return cast(&box, center, direction, maxDistance, filter, &hit, nullptr) > 0;
+}
+
+size_t CollisionWorld::boxCastAll(const glm::vec3& center, const glm::vec3& halfExtents, const glm::vec3& rotation, const glm::vec3& direction, float maxDistance, std::vector<RaycastHit>& hits, const QueryFilter& filter) const {
+    const ConvexShape box = boxCastShape(center, halfExtents, rotation);
+    return cast(&box, center, direction, maxDistance, filter, nullptr, &hits);
+}
+
+bool CollisionWorld::shapeCast(const ConvexShape& shape, const glm::vec3& direction, float maxDistance, RaycastHit& hit, const QueryFilter& filter) const {
+    return cast(&shape, shape.center, direction, maxDistance, filter, &hit, nullptr) > 0;
+}
+
+size_t CollisionWorld::shapeCastAll(const ConvexShape& shape, const glm::vec3& direction, float maxDistance, std::vector<RaycastHit>& hits, const QueryFilter& filter) const {
+    return cast(&shape, shape.center, direction, maxDistance, filter, nullptr, &hits);
+}
+
+void CollisionWorld::setNarrowphase(const Collider* a, const Collider* b, Narrowphase mode) {
+    if (!a || !b) return;
+    if (mode == Narrowphase::Auto) {
+        narrowphaseOverrides.erase(pairKey(a, b));
+    } else {
+        narrowphaseOverrides[pairKey(a, b)] = mode;
+    }
+}
+
+Narrowphase CollisionWorld::getNarrowphase(const Collider& a, const Collider& b) const {
+    if (!narrowphaseOverrides.empty()) {
+        auto it = narrowphaseOverrides.find(pairKey(&a, &b));
+        if (it != narrowphaseOverrides.end()) return it->second;
+    }
+    if (a.getColliderType() == ColliderType::Convex || b.getColliderType() == ColliderType::Convex) {
+        return Narrowphase::GJK;
+    }
+    return Narrowphase::SAT;
+}
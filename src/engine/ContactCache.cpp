@@ -0,0 +1,28 @@
+#include <ContactCache.h>
+
+ContactCache::Entry& ContactCache::at(const void* a, const void* b) {
+    Entry& entry = entries[{a, b}];
+    entry.lastUsed = step;
+    return entry;
+}
+
+void ContactCache::endStep() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.lastUsed < step) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    ++step;
+}
+
+void ContactCache::forget(const void* key) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->first.first == key || it->first.second == key) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
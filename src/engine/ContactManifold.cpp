@@ -0,0 +1,299 @@
+#include <ContactManifold.h>
+#include <ClosestPoints.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+namespace {
+    // Of two nearly equally good axes, keep the face of a over the face of b
+    // and any face over an edge, so a resting pair keeps the same features
+    // from step to step.
+    constexpr float kRelativeTolerance = 0.95f;
+    constexpr float kAbsoluteTolerance = 0.01f;
+    constexpr float kParallelEps = 1e-5f;
+    // Edge pairs closer than this to parallel give axes too noisy to trust.
+    constexpr float kParallelEdges = 1e-3f;
+    // A quad clipped by four planes gains at most one vertex per plane.
+    constexpr size_t kMaxClipVertices = 8;
+
+    struct ClipVertex {
+        glm::vec3 position{0.0f};
+        uint32_t id = 0;
+    };
+
+    uint32_t combineIds(uint32_t a, uint32_t b) {
+        return (a * 0x9e3779b1u) ^ (b + 0x7f4a7c15u + (a << 6) + (a >> 2));
+    }
+
+    // Sutherland-Hodgman: keeps the part of the polygon with dot(normal, p) <= offset.
+    // Each vertex is measured once, so it lands on the same side for both of
+    // its edges; measuring it per edge let fast-math builds round the two
+    // apart and emit more vertices than out holds. Near-degenerate input that
+    // would still overflow is cut off at kMaxClipVertices.
+    size_t clipPolygon(const ClipVertex* in, size_t count, const glm::vec3& normal, float offset, uint32_t plane, ClipVertex* out) {
+        float distances[kMaxClipVertices];
+        for (size_t i = 0; i < count; ++i) {
+            distances[i] = glm::dot(normal, in[i].position) - offset;
+        }
+        size_t written = 0;
+        for (size_t i = 0; i < count && written < kMaxClipVertices; ++i) {
+            const ClipVertex& a = in[i];
+            const ClipVertex& b = in[(i + 1) % count];
+            const float da = distances[i];
+            const float db = distances[(i + 1) % count];
+            if (da <= 0.0f) {
+                out[written++] = a;
+            }
+            if ((da <= 0.0f) != (db <= 0.0f) && written < kMaxClipVertices) {
+                const float t = da / (da - db);
+                out[written++] = {a.position + (b.position - a.position) * t, combineIds(combineIds(a.id, b.id), plane + 1)};
+            }
+        }
+        return written;
+    }
+
+    // Face ref against the most anti-parallel face of inc. refIsB says which
+    // of the original pair ref is, so the normal still points from b toward a.
+    size_t faceContacts(const ConvexShape& ref, int face, const ConvexShape& inc, bool refIsB, float margin, ContactPoint* out) {
+        glm::vec3 n = ref.axes[face];
+        uint32_t header = (refIsB ? 0x80u : 0u) | (static_cast<uint32_t>(face) << 4);
+        if (glm::dot(inc.center - ref.center, n) < 0.0f) {
+            n = -n;
+            header |= 0x08u;
+        }
+
+        int incFace = 0;
+        float best = -1.0f;
+        for (int j = 0; j < 3; ++j) {
+            const float alignment = std::abs(glm::dot(inc.axes[j], n));
+            if (alignment > best) {
+                best = alignment;
+                incFace = j;
+            }
+        }
+        glm::vec3 incNormal = inc.axes[incFace];
+        header |= static_cast<uint32_t>(incFace) << 1;
+        if (glm::dot(incNormal, n) > 0.0f) {
+            incNormal = -incNormal;
+            header |= 0x01u;
+        }
+        const int uAxis = (incFace + 1) % 3;
+        const int vAxis = (incFace + 2) % 3;
+        const glm::vec3 center = inc.center + incNormal * inc.halfExtents[incFace];
+        const glm::vec3 u = inc.axes[uAxis] * inc.halfExtents[uAxis];
+        const glm::vec3 v = inc.axes[vAxis] * inc.halfExtents[vAxis];
+
+        ClipVertex polygon[kMaxClipVertices] = {
+            {center + u + v, 0}, {center - u + v, 1}, {center - u - v, 2}, {center + u - v, 3}
+        };
+        ClipVertex clipped[kMaxClipVertices];
+        size_t count = 4;
+        uint32_t plane = 0;
+        for (int side : {(face + 1) % 3, (face + 2) % 3}) {
+            for (float sign : {1.0f, -1.0f}) {
+                const glm::vec3 sideNormal = ref.axes[side] * sign;
+                const float offset = glm::dot(sideNormal, ref.center) + ref.halfExtents[side];
+                count = clipPolygon(polygon, count, sideNormal, offset, plane++, clipped);
+                if (count == 0) return 0;
+                std::copy(clipped, clipped + count, polygon);
+            }
+        }
+
+        const float refOffset = glm::dot(n, ref.center) + ref.halfExtents[face];
+        ContactPoint points[kMaxClipVertices];
+        size_t found = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const float separation = glm::dot(n, polygon[i].position) - refOffset;
+            if (separation > margin) continue;
+            ContactPoint& point = points[found++];
+            point.position = polygon[i].position - n * (separation * 0.5f);
+            point.normal = refIsB ? n : -n;
+            point.separation = separation;
+            point.id = combineIds(header, polygon[i].id) | 1u;
+        }
+        found = reduceContacts(points, found);
+        std::copy(points, points + found, out);
+        return found;
+    }
+
+    // Edge i of a against edge j of b, with axis pointing from a toward b.
+    size_t edgeContact(const ConvexShape& a, int i, const ConvexShape& b, int j, const glm::vec3& axis, float margin, ContactPoint* out) {
+        glm::vec3 onA = a.center;
+        glm::vec3 onB = b.center;
+        for (int k = 0; k < 3; ++k) {
+            if (k != i) onA += a.axes[k] * (glm::dot(a.axes[k], axis) >= 0.0f ? a.halfExtents[k] : -a.halfExtents[k]);
+            if (k != j) onB -= b.axes[k] * (glm::dot(b.axes[k], axis) >= 0.0f ? b.halfExtents[k] : -b.halfExtents[k]);
+        }
+        const glm::vec3 edgeA = a.axes[i] * a.halfExtents[i];
+        const glm::vec3 edgeB = b.axes[j] * b.halfExtents[j];
+        glm::vec3 closestA, closestB;
+        closestPointsSegmentSegment(onA - edgeA, onA + edgeA, onB - edgeB, onB + edgeB, closestA, closestB);
+        const float separation = glm::dot(closestB - closestA, axis);
+        if (separation > margin) return 0;
+        out[0].position = (closestA + closestB) * 0.5f;
+        out[0].normal = -axis;
+        out[0].separation = separation;
+        out[0].id = 0x80000000u | (static_cast<uint32_t>(i * 3 + j) << 1) | 1u;
+        return 1;
+    }
+}
+
+size_t collideBoxes(const ConvexShape& a, const ConvexShape& b, float margin, ContactPoint* out) {
+    const glm::vec3 d = b.center - a.center;
+    float absDot[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            absDot[i][j] = std::abs(glm::dot(a.axes[i], b.axes[j])) + kParallelEps;
+        }
+    }
+
+    float faceA = -FLT_MAX;
+    int bestA = 0;
+    for (int i = 0; i < 3; ++i) {
+        const float reach = a.halfExtents[i] + b.halfExtents[0] * absDot[i][0] + b.halfExtents[1] * absDot[i][1] + b.halfExtents[2] * absDot[i][2];
+        const float separation = std::abs(glm::dot(d, a.axes[i])) - reach;
+        if (separation > margin) return 0;
+        if (separation > faceA) {
+            faceA = separation;
+            bestA = i;
+        }
+    }
+    float faceB = -FLT_MAX;
+    int bestB = 0;
+    for (int j = 0; j < 3; ++j) {
+        const float reach = b.halfExtents[j] + a.halfExtents[0] * absDot[0][j] + a.halfExtents[1] * absDot[1][j] + a.halfExtents[2] * absDot[2][j];
+        const float separation = std::abs(glm::dot(d, b.axes[j])) - reach;
+        if (separation > margin) return 0;
+        if (separation > faceB) {
+            faceB = separation;
+            bestB = j;
+        }
+    }
+    float edge = -FLT_MAX;
+    int edgeA = 0;
+    int edgeB = 0;
+    glm::vec3 edgeAxis(0.0f);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            glm::vec3 axis = glm::cross(a.axes[i], b.axes[j]);
+            const float length = glm::length(axis);
+            // Parallel edges add nothing the face axes have not covered.
+            if (length < kParallelEdges) continue;
+            axis /= length;
+            float reach = 0.0f;
+            for (int k = 0; k < 3; ++k) {
+                reach += a.halfExtents[k] * std::abs(glm::dot(a.axes[k], axis)) + b.halfExtents[k] * std::abs(glm::dot(b.axes[k], axis));
+            }
+            const float along = glm::dot(d, axis);
+            const float separation = std::abs(along) - reach;
+            if (separation > margin) return 0;
+            if (separation > edge) {
+                edge = separation;
+                edgeA = i;
+                edgeB = j;
+                edgeAxis = along < 0.0f ? -axis : axis;
+            }
+        }
+    }
+
+    const float face = std::max(faceA, faceB);
+    if (edge * kRelativeTolerance > face + kAbsoluteTolerance) {
+        return edgeContact(a, edgeA, b, edgeB, edgeAxis, margin, out);
+    }
+    if (faceB * kRelativeTolerance > faceA + kAbsoluteTolerance) {
+        return faceContacts(b, bestB, a, true, margin, out);
+    }
+    return faceContacts(a, bestA, b, false, margin, out);
+}
+
+bool collideConvex(const ConvexShape& a, const ConvexShape& b, float margin, ContactPoint& out) {
+    GJKResult result;
+    bool overlapping = false;
+    if (a.kind == ConvexShape::Kind::Capsule || b.kind == ConvexShape::Kind::Capsule) {
+        // capsulePenetration answers for the capsule; flip the answer back if it was b.
+        const bool swapped = a.kind != ConvexShape::Kind::Capsule;
+        overlapping = swapped ? capsulePenetration(b, a, result) : capsulePenetration(a, b, result);
+        if (swapped) {
+            std::swap(result.pointA, result.pointB);
+            result.normal = -result.normal;
+        }
+    } else if (gjkDistance(a, b, result)) {
+        overlapping = gjkPenetration(a, b, result);
+        if (!overlapping) return false;
+    }
+
+    if (overlapping) {
+        out.normal = result.normal;
+        out.separation = -result.penetration;
+    } else {
+        const glm::vec3 gap = result.pointA - result.pointB;
+        const float distance = glm::length(gap);
+        if (distance > margin || distance < 1e-6f) return false;
+        out.normal = gap / distance;
+        out.separation = distance;
+    }
+    out.position = (result.pointA + result.pointB) * 0.5f;
+    out.id = 0;
+    return true;
+}
+
+size_t reduceContacts(ContactPoint* points, size_t count) {
+    if (count <= kMaxManifoldPoints) return count;
+    auto take = [&](size_t slot, size_t index) {
+        std::swap(points[slot], points[index]);
+    };
+
+    size_t deepest = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (points[i].separation < points[deepest].separation) deepest = i;
+    }
+    take(0, deepest);
+
+    const glm::vec3 p0 = points[0].position;
+    size_t farthest = 1;
+    float bestDistance = -1.0f;
+    for (size_t i = 1; i < count; ++i) {
+        const glm::vec3 offset = points[i].position - p0;
+        const float distance = glm::dot(offset, offset);
+        if (distance > bestDistance) {
+            bestDistance = distance;
+            farthest = i;
+        }
+    }
+    take(1, farthest);
+
+    const glm::vec3 p1 = points[1].position;
+    size_t widest = 2;
+    float bestArea = -1.0f;
+    for (size_t i = 2; i < count; ++i) {
+        const glm::vec3 normal = glm::cross(p1 - p0, points[i].position - p0);
+        const float area = glm::dot(normal, normal);
+        if (area > bestArea) {
+            bestArea = area;
+            widest = i;
+        }
+    }
+    take(2, widest);
+
+    // The last point adds the most area outside the triangle so far.
+    const glm::vec3 p2 = points[2].position;
+    const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+    const glm::vec3 corners[3] = {p0, p1, p2};
+    size_t outermost = 3;
+    float bestGain = -FLT_MAX;
+    for (size_t i = 3; i < count; ++i) {
+        float gain = -FLT_MAX;
+        for (int e = 0; e < 3; ++e) {
+            const glm::vec3& from = corners[e];
+            const glm::vec3& to = corners[(e + 1) % 3];
+            gain = std::max(gain, glm::dot(glm::cross(to - from, normal), points[i].position - from));
+        }
+        if (gain > bestGain) {
+            bestGain = gain;
+            outermost = i;
+        }
+    }
+    take(3, outermost);
+    return kMaxManifoldPoints;
+}
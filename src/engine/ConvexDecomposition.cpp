@@ -0,0 +1,499 @@
+#include <ConvexDecomposition.h>
+#include <Collider.h>
+#include <Model.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+namespace {
+    constexpr uint32_t kCacheMagic = 0x4c484650u;   // "PFHL"
+    constexpr uint32_t kCacheVersion = 2;
+    // Hull and weld tolerances, as shares of the input's bounding diagonal.
+    constexpr float kHullEpsilon = 1e-5f;
+    constexpr float kWeldEpsilon = 1e-6f;
+
+    struct Part {
+        std::vector<glm::vec3> corners;     // three per triangle
+        ConvexHull hull;
+        float concavity = 0.0f;     // deepest point
+        float gap = 0.0f;           // roughly the volume between surface and hull
+        bool settled = false;
+    };
+
+    glm::vec3 unitOrZero(const glm::vec3& v) {
+        const float length = glm::length(v);
+        return length > 1e-12f ? v / length : glm::vec3(0.0f);
+    }
+
+    float diagonal(const std::vector<glm::vec3>& points) {
+        if (points.empty()) return 0.0f;
+        glm::vec3 low = points[0];
+        glm::vec3 high = points[0];
+        for (const glm::vec3& p : points) {
+            low = glm::min(low, p);
+            high = glm::max(high, p);
+        }
+        return glm::length(high - low);
+    }
+
+    // Drops points that land in the same cell of a fine grid.
+    void weld(std::vector<glm::vec3>& points) {
+        const float cell = std::max(kWeldEpsilon * diagonal(points), 1e-7f);
+        std::vector<std::pair<glm::ivec3, size_t>> keyed(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            keyed[i] = {glm::ivec3(glm::round(points[i] / cell)), i};
+        }
+        auto less = [](const glm::ivec3& a, const glm::ivec3& b) {
+            if (a.x != b.x) return a.x < b.x;
+            if (a.y != b.y) return a.y < b.y;
+            return a.z < b.z;
+        };
+        std::sort(keyed.begin(), keyed.end(), [&](const auto& l, const auto& r) { return less(l.first, r.first); });
+        std::vector<glm::vec3> unique;
+        unique.reserve(points.size());
+        for (size_t i = 0; i < keyed.size(); ++i) {
+            if (i > 0 && keyed[i].first == keyed[i - 1].first) continue;
+            unique.push_back(points[keyed[i].second]);
+        }
+        points.swap(unique);
+    }
+
+    std::vector<glm::vec3> hullInput(const std::vector<glm::vec3>& corners, float thickness) {
+        std::vector<glm::vec3> points;
+        points.reserve(corners.size() * 2);
+        for (size_t t = 0; t + 2 < corners.size(); t += 3) {
+            const glm::vec3 back = -thickness * unitOrZero(glm::cross(corners[t + 1] - corners[t], corners[t + 2] - corners[t]));
+            for (size_t k = 0; k < 3; ++k) {
+                points.push_back(corners[t + k]);
+                if (thickness > 0.0f) points.push_back(corners[t + k] + back);
+            }
+        }
+        weld(points);
+        return points;
+    }
+
+    // How far corners and centroids sit inside the hull, measured along their
+    // face normal, or outside a hull that ran out of vertices. Fills in the
+    // deepest of them and the depth summed over each triangle's area.
+    void measureConcavity(Part& part) {
+        const std::vector<glm::vec3>& corners = part.corners;
+        const ConvexHull& hull = part.hull;
+        part.concavity = 0.0f;
+        part.gap = 0.0f;
+        if (hull.indices.empty()) return;
+        std::vector<glm::vec4> planes;
+        planes.reserve(hull.indices.size() / 3);
+        for (size_t i = 0; i + 2 < hull.indices.size(); i += 3) {
+            const glm::vec3& a = hull.vertices[hull.indices[i]];
+            const glm::vec3 n = unitOrZero(glm::cross(hull.vertices[hull.indices[i + 1]] - a, hull.vertices[hull.indices[i + 2]] - a));
+            if (n != glm::vec3(0.0f)) planes.emplace_back(n, glm::dot(n, a));
+        }
+        auto depth = [&](const glm::vec3& p, const glm::vec3& normal) {
+            float outside = -FLT_MAX;
+            float exit = FLT_MAX;
+            for (const glm::vec4& plane : planes) {
+                const glm::vec3 n(plane);
+                const float distance = glm::dot(n, p) - plane.w;
+                outside = std::max(outside, distance);
+                const float along = glm::dot(n, normal);
+                if (along > 1e-6f) exit = std::min(exit, -distance / along);
+            }
+            if (outside > 0.0f) return outside;
+            return exit < FLT_MAX ? exit : 0.0f;
+        };
+        for (size_t t = 0; t + 2 < corners.size(); t += 3) {
+            const glm::vec3 cross = glm::cross(corners[t + 1] - corners[t], corners[t + 2] - corners[t]);
+            const glm::vec3 normal = unitOrZero(cross);
+            if (normal == glm::vec3(0.0f)) continue;
+            const float depths[4] = {
+                depth(corners[t], normal),
+                depth(corners[t + 1], normal),
+                depth(corners[t + 2], normal),
+                depth((corners[t] + corners[t + 1] + corners[t + 2]) / 3.0f, normal)
+            };
+            part.concavity = std::max({part.concavity, depths[0], depths[1], depths[2], depths[3]});
+            part.gap += 0.5f * glm::length(cross) * (depths[0] + depths[1] + depths[2] + depths[3]) * 0.25f;
+        }
+    }
+
+    // Keeps the part of a triangle with sign * d <= 0, fanned back into triangles.
+    void clipTriangle(const glm::vec3* triangle, const float* d, float sign, std::vector<glm::vec3>& out) {
+        glm::vec3 polygon[4];
+        size_t count = 0;
+        for (int i = 0; i < 3; ++i) {
+            const int j = (i + 1) % 3;
+            const float da = d[i] * sign;
+            const float db = d[j] * sign;
+            if (da <= 0.0f) polygon[count++] = triangle[i];
+            if ((da < 0.0f && db > 0.0f) || (da > 0.0f && db < 0.0f)) {
+                polygon[count++] = triangle[i] + (triangle[j] - triangle[i]) * (da / (da - db));
+            }
+        }
+        for (size_t k = 1; k + 1 < count; ++k) {
+            out.push_back(polygon[0]);
+            out.push_back(polygon[k]);
+            out.push_back(polygon[k + 1]);
+        }
+    }
+
+    void splitCorners(const std::vector<glm::vec3>& corners, int axis, float position, std::vector<glm::vec3>& below, std::vector<glm::vec3>& above) {
+        for (size_t t = 0; t + 2 < corners.size(); t += 3) {
+            const float d[3] = {corners[t][axis] - position, corners[t + 1][axis] - position, corners[t + 2][axis] - position};
+            if (d[0] <= 0.0f && d[1] <= 0.0f && d[2] <= 0.0f) {
+                below.insert(below.end(), corners.begin() + t, corners.begin() + t + 3);
+            } else if (d[0] >= 0.0f && d[1] >= 0.0f && d[2] >= 0.0f) {
+                above.insert(above.end(), corners.begin() + t, corners.begin() + t + 3);
+            } else {
+                clipTriangle(&corners[t], d, 1.0f, below);
+                clipTriangle(&corners[t], d, -1.0f, above);
+            }
+        }
+    }
+
+    Part makePart(std::vector<glm::vec3> corners, const DecompositionSettings& settings) {
+        Part part;
+        part.corners = std::move(corners);
+        part.hull = buildConvexHull(hullInput(part.corners, settings.thickness), settings.maxHullVertices);
+        measureConcavity(part);
+        return part;
+    }
+
+    void hashBytes(uint64_t& hash, const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+
+    uint64_t hashInput(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const DecompositionSettings& settings) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        hashBytes(hash, &kCacheVersion, sizeof(kCacheVersion));
+        hashBytes(hash, vertices.data(), vertices.size() * sizeof(glm::vec3));
+        hashBytes(hash, indices.data(), indices.size() * sizeof(uint32_t));
+        hashBytes(hash, &settings.maxHulls, sizeof(settings.maxHulls));
+        hashBytes(hash, &settings.maxHullVertices, sizeof(settings.maxHullVertices));
+        hashBytes(hash, &settings.maxConcavity, sizeof(settings.maxConcavity));
+        hashBytes(hash, &settings.planesPerAxis, sizeof(settings.planesPerAxis));
+        hashBytes(hash, &settings.thickness, sizeof(settings.thickness));
+        return hash;
+    }
+
+    template<typename T>
+    bool readValue(std::ifstream& in, T& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    template<typename T>
+    void writeValue(std::ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    bool readCache(const std::string& path, uint64_t hash, std::vector<ConvexHull>& hulls) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        uint32_t magic = 0, version = 0, count = 0;
+        uint64_t storedHash = 0;
+        if (!readValue(in, magic) || !readValue(in, version) || !readValue(in, storedHash) || !readValue(in, count)) return false;
+        if (magic != kCacheMagic || version != kCacheVersion || storedHash != hash) return false;
+        hulls.assign(count, {});
+        for (ConvexHull& hull : hulls) {
+            uint32_t vertexCount = 0, indexCount = 0;
+            if (!readValue(in, vertexCount) || !readValue(in, indexCount)) return false;
+            hull.vertices.resize(vertexCount);
+            hull.indices.resize(indexCount);
+            in.read(reinterpret_cast<char*>(hull.vertices.data()), static_cast<std::streamsize>(vertexCount * sizeof(glm::vec3)));
+            in.read(reinterpret_cast<char*>(hull.indices.data()), static_cast<std::streamsize>(indexCount * sizeof(uint32_t)));
+            if (!in) return false;
+            for (uint32_t index : hull.indices) {
+                if (index >= vertexCount) return false;
+            }
+        }
+        return true;
+    }
+
+    void writeCache(const std::string& path, uint64_t hash, const std::vector<ConvexHull>& hulls) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "loadConvexDecomposition - could not write " << path << "\n";
+            return;
+        }
+        writeValue(out, kCacheMagic);
+        writeValue(out, kCacheVersion);
+        writeValue(out, hash);
+        writeValue(out, static_cast<uint32_t>(hulls.size()));
+        for (const ConvexHull& hull : hulls) {
+            writeValue(out, static_cast<uint32_t>(hull.vertices.size()));
+            writeValue(out, static_cast<uint32_t>(hull.indices.size()));
+            out.write(reinterpret_cast<const char*>(hull.vertices.data()), static_cast<std::streamsize>(hull.vertices.size() * sizeof(glm::vec3)));
+            out.write(reinterpret_cast<const char*>(hull.indices.data()), static_cast<std::streamsize>(hull.indices.size() * sizeof(uint32_t)));
+        }
+    }
+}
+
+ConvexHull buildConvexHull(const std::vector<glm::vec3>& points, uint32_t maxVertices) {
+    ConvexHull hull;
+    if (points.size() < 4 || maxVertices < 4) return hull;
+    const float eps = std::max(kHullEpsilon * diagonal(points), 1e-7f);
+
+    // Seed tetrahedron: extreme point, the point farthest from it, then the
+    // farthest from their line and from the plane of all three.
+    size_t a = 0;
+    for (size_t i = 1; i < points.size(); ++i) {
+        if (points[i].x < points[a].x) a = i;
+    }
+    size_t b = a;
+    float best = 0.0f;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const glm::vec3 offset = points[i] - points[a];
+        if (glm::dot(offset, offset) > best) {
+            best = glm::dot(offset, offset);
+            b = i;
+        }
+    }
+    if (std::sqrt(best) <= eps) return hull;
+    const glm::vec3 line = glm::normalize(points[b] - points[a]);
+    size_t c = a;
+    best = 0.0f;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const float distance = glm::length(glm::cross(points[i] - points[a], line));
+        if (distance > best) {
+            best = distance;
+            c = i;
+        }
+    }
+    if (best <= eps) return hull;
+    const glm::vec3 planeNormal = glm::normalize(glm::cross(points[b] - points[a], points[c] - points[a]));
+    size_t d = a;
+    best = 0.0f;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const float distance = std::abs(glm::dot(points[i] - points[a], planeNormal));
+        if (distance > best) {
+            best = distance;
+            d = i;
+        }
+    }
+    if (best <= eps) return hull;
+
+    struct Face {
+        uint32_t v[3];
+        glm::vec3 normal;
+        float offset;
+    };
+    const glm::vec3 interior = (points[a] + points[b] + points[c] + points[d]) * 0.25f;
+    std::vector<Face> faces;
+    auto addFace = [&](uint32_t i, uint32_t j, uint32_t k) {
+        const glm::vec3 n = unitOrZero(glm::cross(points[j] - points[i], points[k] - points[i]));
+        faces.push_back({{i, j, k}, n, glm::dot(n, points[i])});
+    };
+    auto addSeedFace = [&](uint32_t i, uint32_t j, uint32_t k) {
+        if (glm::dot(glm::cross(points[j] - points[i], points[k] - points[i]), interior - points[i]) > 0.0f) std::swap(j, k);
+        addFace(i, j, k);
+    };
+    auto hasEdge = [](const Face& face, uint32_t from, uint32_t to) {
+        for (int e = 0; e < 3; ++e) {
+            if (face.v[e] == from && face.v[(e + 1) % 3] == to) return true;
+        }
+        return false;
+    };
+    const uint32_t ia = static_cast<uint32_t>(a), ib = static_cast<uint32_t>(b), ic = static_cast<uint32_t>(c), id = static_cast<uint32_t>(d);
+    addSeedFace(ia, ib, ic);
+    addSeedFace(ia, ib, id);
+    addSeedFace(ia, ic, id);
+    addSeedFace(ib, ic, id);
+    std::vector<uint32_t> used = {ia, ib, ic, id};
+    std::vector<uint8_t> onHull(points.size(), 0);
+    for (uint32_t v : used) onHull[v] = 1;
+
+    std::vector<uint8_t> visible;
+    std::vector<size_t> stack;
+    std::vector<std::pair<uint32_t, uint32_t>> horizon;
+    while (used.size() < maxVertices) {
+        float farthest = eps;
+        size_t pick = points.size();
+        size_t pickFace = 0;
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (onHull[i]) continue;
+            for (size_t f = 0; f < faces.size(); ++f) {
+                const float distance = glm::dot(faces[f].normal, points[i]) - faces[f].offset;
+                if (distance > farthest) {
+                    farthest = distance;
+                    pick = i;
+                    pickFace = f;
+                }
+            }
+        }
+        if (pick == points.size()) break;
+
+        // Faces the new point sees go, grown out from the one it is farthest
+        // in front of so they stay connected; the loop of edges around them
+        // is joined to the point instead, keeping its winding.
+        const glm::vec3& p = points[pick];
+        visible.assign(faces.size(), 0);
+        visible[pickFace] = 1;
+        stack.assign(1, pickFace);
+        horizon.clear();
+        while (!stack.empty()) {
+            const Face& face = faces[stack.back()];
+            stack.pop_back();
+            for (int e = 0; e < 3; ++e) {
+                const uint32_t from = face.v[e], to = face.v[(e + 1) % 3];
+                for (size_t f = 0; f < faces.size(); ++f) {
+                    if (visible[f] || !hasEdge(faces[f], to, from)) continue;
+                    if (glm::dot(faces[f].normal, p) - faces[f].offset > eps) {
+                        visible[f] = 1;
+                        stack.push_back(f);
+                    }
+                    break;
+                }
+            }
+        }
+        for (size_t f = 0; f < faces.size(); ++f) {
+            if (!visible[f]) continue;
+            for (int e = 0; e < 3; ++e) {
+                const uint32_t from = faces[f].v[e], to = faces[f].v[(e + 1) % 3];
+                bool inside = false;
+                for (size_t g = 0; g < faces.size() && !inside; ++g) inside = visible[g] && hasEdge(faces[g], to, from);
+                if (!inside) horizon.emplace_back(from, to);
+            }
+        }
+        size_t kept = 0;
+        for (size_t f = 0; f < faces.size(); ++f) {
+            if (!visible[f]) faces[kept++] = faces[f];
+        }
+        faces.resize(kept);
+        for (const auto& edge : horizon) addFace(edge.first, edge.second, static_cast<uint32_t>(pick));
+        used.push_back(static_cast<uint32_t>(pick));
+        onHull[pick] = 1;
+    }
+
+    std::vector<uint32_t> remap(points.size(), UINT32_MAX);
+    for (const Face& face : faces) {
+        for (uint32_t v : face.v) {
+            if (remap[v] == UINT32_MAX) {
+                remap[v] = static_cast<uint32_t>(hull.vertices.size());
+                hull.vertices.push_back(points[v]);
+            }
+            hull.indices.push_back(remap[v]);
+        }
+    }
+    return hull;
+}
+
+std::vector<ConvexHull> decomposeConvex(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const DecompositionSettings& settings) {
+    std::vector<glm::vec3> corners;
+    corners.reserve(indices.size());
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        if (indices[t] >= vertices.size() || indices[t + 1] >= vertices.size() || indices[t + 2] >= vertices.size()) continue;
+        for (size_t k = 0; k < 3; ++k) corners.push_back(vertices[indices[t + k]]);
+    }
+    if (corners.empty()) return {};
+    const float threshold = settings.maxConcavity * diagonal(corners);
+
+    std::vector<Part> parts;
+    parts.push_back(makePart(std::move(corners), settings));
+    while (parts.size() < settings.maxHulls) {
+        size_t worst = parts.size();
+        for (size_t i = 0; i < parts.size(); ++i) {
+            if (!parts[i].settled && (worst == parts.size() || parts[i].concavity > parts[worst].concavity)) worst = i;
+        }
+        if (worst == parts.size() || parts[worst].concavity <= threshold) break;
+
+        const Part& part = parts[worst];
+        glm::vec3 low = part.corners[0];
+        glm::vec3 high = part.corners[0];
+        for (const glm::vec3& p : part.corners) {
+            low = glm::min(low, p);
+            high = glm::max(high, p);
+        }
+        float bestCost = FLT_MAX;
+        Part bestBelow, bestAbove;
+        std::vector<glm::vec3> below, above;
+        std::vector<float> coordinates, planes;
+        for (int axis = 0; axis < 3; ++axis) {
+            const float extent = high[axis] - low[axis];
+            if (extent <= 0.0f) continue;
+            // Creases and steps sit at vertices, so each evenly spaced plane
+            // moves to the nearest vertex coordinate strictly inside the part.
+            coordinates.clear();
+            for (const glm::vec3& p : part.corners) {
+                if (p[axis] > low[axis] && p[axis] < high[axis]) coordinates.push_back(p[axis]);
+            }
+            std::sort(coordinates.begin(), coordinates.end());
+            planes.clear();
+            for (uint32_t k = 1; k <= settings.planesPerAxis; ++k) {
+                const float even = low[axis] + extent * k / (settings.planesPerAxis + 1);
+                float plane = even;
+                auto next = std::lower_bound(coordinates.begin(), coordinates.end(), even);
+                if (next != coordinates.end()) plane = *next;
+                if (next != coordinates.begin() && (next == coordinates.end() || even - *(next - 1) < *next - even)) plane = *(next - 1);
+                if (std::find(planes.begin(), planes.end(), plane) == planes.end()) planes.push_back(plane);
+            }
+            for (float plane : planes) {
+                below.clear();
+                above.clear();
+                splitCorners(part.corners, axis, plane, below, above);
+                if (below.empty() || above.empty()) continue;
+                Part first = makePart(below, settings);
+                Part second = makePart(above, settings);
+                const float cost = first.gap + second.gap;
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestBelow = std::move(first);
+                    bestAbove = std::move(second);
+                }
+            }
+        }
+        // A cut that leaves as much space between surface and hulls buys nothing.
+        if (bestCost == FLT_MAX || bestCost >= part.gap) {
+            parts[worst].settled = true;
+            continue;
+        }
+        parts[worst] = std::move(bestBelow);
+        parts.push_back(std::move(bestAbove));
+    }
+
+    std::vector<ConvexHull> hulls;
+    hulls.reserve(parts.size());
+    for (Part& part : parts) {
+        if (!part.hull.indices.empty()) hulls.push_back(std::move(part.hull));
+    }
+    return hulls;
+}
+
+std::vector<ConvexHull> loadConvexDecomposition(const Model& model, const DecompositionSettings& settings) {
+    const std::vector<float>& interleaved = model.getVertices();
+    std::vector<glm::vec3> vertices(interleaved.size() / Model::kFloatsPerVertex);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const size_t base = i * Model::kFloatsPerVertex;
+        vertices[i] = glm::vec3(interleaved[base], interleaved[base + 1], interleaved[base + 2]);
+    }
+    const uint64_t hash = hashInput(vertices, model.getIndices(), settings);
+    const std::string& source = model.getSourcePath();
+    const std::string cachePath = source + ".hulls";
+    std::vector<ConvexHull> hulls;
+    if (!source.empty() && readCache(cachePath, hash, hulls)) return hulls;
+    hulls = decomposeConvex(vertices, model.getIndices(), settings);
+    if (!source.empty()) writeCache(cachePath, hash, hulls);
+    return hulls;
+}
+
+std::vector<ConvexCollider*> attachConvexHulls(Entity* parent, const std::vector<ConvexHull>& hulls) {
+    std::vector<ConvexCollider*> colliders;
+    colliders.reserve(hulls.size());
+    std::vector<float> positions;
+    for (const ConvexHull& hull : hulls) {
+        positions.clear();
+        for (const glm::vec3& v : hull.vertices) {
+            positions.insert(positions.end(), {v.x, v.y, v.z});
+        }
+        ConvexCollider* collider = new ConvexCollider({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, parent->getName());
+        collider->setVertices(positions, hull.indices);
+        parent->addChild(collider);
+        colliders.push_back(collider);
+    }
+    return colliders;
+}
@@ -0,0 +1,284 @@
+#include <ConvexPolyhedron.h>
+#include <ConvexDecomposition.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+    // Neighbouring hull triangles this close to parallel, with corners this
+    // near the plane of their face's first triangle (as a share of the
+    // hull's bounding diagonal), share a face.
+    constexpr float kCoplanarCos = 0.9999f;
+    constexpr float kPlanarTolerance = 1e-5f;
+    // Edge pairs closer than this to parallel give no axis of their own.
+    constexpr float kParallelSin = 1e-3f;
+    // An edge axis has to beat the best face by this much, so resting
+    // contacts keep a stable face normal.
+    constexpr float kEdgeTolerance = 1e-4f;
+
+    uint64_t edgeKey(uint32_t from, uint32_t to) {
+        return (static_cast<uint64_t>(from) << 32) | to;
+    }
+
+    // Gauss map arcs a-b and c-d cross: the edges they belong to build a
+    // face of the Minkowski difference. bxa is cross(b, a).
+    bool isMinkowskiFace(const glm::vec3& a, const glm::vec3& b, const glm::vec3& bxa, const glm::vec3& c, const glm::vec3& d) {
+        const glm::vec3 dxc = glm::cross(d, c);
+        const float cba = glm::dot(c, bxa);
+        const float dba = glm::dot(d, bxa);
+        const float adc = glm::dot(a, dxc);
+        const float bdc = glm::dot(b, dxc);
+        return cba * dba < 0.0f && adc * bdc < 0.0f && cba * bdc > 0.0f;
+    }
+
+    // Face of `of` that the other hull's deepest vertex is least far behind.
+    float faceSeparation(const PolyhedronView& of, const PolyhedronView& other, glm::vec3& normal) {
+        float best = -FLT_MAX;
+        uint32_t support = 0;
+        for (size_t f = 0; f < of.shape->planes.size(); ++f) {
+            const glm::vec3 n(of.planes[f]);
+            support = polyhedronSupport(other, -n, support);
+            const float separation = glm::dot(n, other.vertices[support] + other.offset) - of.planes[f].w - glm::dot(n, of.offset);
+            if (separation > best) {
+                best = separation;
+                normal = n;
+                if (separation > 0.0f) break;
+            }
+        }
+        return best;
+    }
+
+    // Half-edge form of hull, merging neighbouring triangles that lie within
+    // planarDistance of their face's first triangle. A negative distance
+    // merges nothing.
+    bool buildTopology(ConvexPolyhedron& out, const ConvexHull& hull, float planarDistance) {
+        const size_t triangleCount = hull.indices.size() / 3;
+        auto corner = [&](size_t t, size_t k) { return hull.indices[t * 3 + k % 3]; };
+
+        std::unordered_map<uint64_t, uint32_t> triangleOf;
+        std::vector<glm::vec3> normals(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const glm::vec3& a = hull.vertices[corner(t, 0)];
+            normals[t] = glm::cross(hull.vertices[corner(t, 1)] - a, hull.vertices[corner(t, 2)] - a);
+            for (size_t k = 0; k < 3; ++k) {
+                if (!triangleOf.emplace(edgeKey(corner(t, k), corner(t, k + 1)), static_cast<uint32_t>(t)).second) return false;
+            }
+        }
+        auto neighbour = [&](size_t t, size_t k) {
+            auto it = triangleOf.find(edgeKey(corner(t, k + 1), corner(t, k)));
+            return it == triangleOf.end() ? UINT32_MAX : it->second;
+        };
+
+        // Flood each face out from a seed triangle over neighbours in its
+        // plane, so a gently curved run is not merged into one.
+        std::vector<uint32_t> faceOf(triangleCount, UINT32_MAX);
+        std::vector<uint32_t> stack;
+        for (size_t seed = 0; seed < triangleCount; ++seed) {
+            if (faceOf[seed] != UINT32_MAX) continue;
+            const uint32_t face = static_cast<uint32_t>(out.planes.size());
+            const glm::vec3 seedNormal = glm::normalize(normals[seed]);
+            const float seedOffset = glm::dot(seedNormal, hull.vertices[corner(seed, 0)]);
+            auto inPlane = [&](uint32_t t) {
+                if (glm::dot(normals[t], seedNormal) <= kCoplanarCos * glm::length(normals[t])) return false;
+                for (size_t k = 0; k < 3; ++k) {
+                    if (std::abs(glm::dot(seedNormal, hull.vertices[corner(t, k)]) - seedOffset) > planarDistance) return false;
+                }
+                return true;
+            };
+            glm::vec3 sum(0.0f);
+            faceOf[seed] = face;
+            stack.assign(1, static_cast<uint32_t>(seed));
+            while (!stack.empty()) {
+                const uint32_t t = stack.back();
+                stack.pop_back();
+                sum += normals[t];
+                for (size_t k = 0; k < 3; ++k) {
+                    const uint32_t n = neighbour(t, k);
+                    if (n == UINT32_MAX) {
+                        out.clear();
+                        return false;
+                    }
+                    if (faceOf[n] != UINT32_MAX || !inPlane(n)) continue;
+                    faceOf[n] = face;
+                    stack.push_back(n);
+                }
+            }
+            out.planes.emplace_back(glm::normalize(sum), -FLT_MAX);
+        }
+        for (size_t t = 0; t < triangleCount; ++t) {
+            glm::vec4& plane = out.planes[faceOf[t]];
+            for (size_t k = 0; k < 3; ++k) plane.w = std::max(plane.w, glm::dot(glm::vec3(plane), hull.vertices[corner(t, k)]));
+        }
+
+        // One twin pair per crease between two faces; vertices that end up
+        // inside a merged face are dropped.
+        std::vector<uint32_t> remap(hull.vertices.size(), UINT32_MAX);
+        auto vertexIndex = [&](uint32_t v) {
+            if (remap[v] == UINT32_MAX) {
+                remap[v] = static_cast<uint32_t>(out.vertices.size());
+                out.vertices.push_back(hull.vertices[v]);
+            }
+            return remap[v];
+        };
+        std::unordered_map<uint64_t, uint32_t> edgeOf;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (size_t k = 0; k < 3; ++k) {
+                const uint32_t n = neighbour(t, k);
+                if (faceOf[n] == faceOf[t] || edgeOf.count(edgeKey(corner(t, k), corner(t, k + 1)))) continue;
+                const uint32_t e = static_cast<uint32_t>(out.edges.size());
+                edgeOf[edgeKey(corner(t, k), corner(t, k + 1))] = e;
+                edgeOf[edgeKey(corner(t, k + 1), corner(t, k))] = e + 1;
+                out.edges.push_back({vertexIndex(corner(t, k)), 0, faceOf[t]});
+                out.edges.push_back({vertexIndex(corner(t, k + 1)), 0, faceOf[n]});
+            }
+        }
+
+        // Around a convex face each vertex is the origin of exactly one edge.
+        std::unordered_map<uint64_t, uint32_t> edgeFrom;
+        out.vertexEdges.assign(out.vertices.size(), 0);
+        for (uint32_t e = 0; e < out.edges.size(); ++e) {
+            edgeFrom[edgeKey(out.edges[e].face, out.edges[e].origin)] = e;
+            out.vertexEdges[out.edges[e].origin] = e;
+        }
+        for (ConvexPolyhedron::HalfEdge& edge : out.edges) {
+            const uint32_t e = static_cast<uint32_t>(&edge - out.edges.data());
+            auto it = edgeFrom.find(edgeKey(edge.face, out.edges[e ^ 1].origin));
+            if (it == edgeFrom.end()) {
+                out.clear();
+                return false;
+            }
+            edge.next = it->second;
+        }
+
+        // A merge across a slight fold can leave a vertex on only two faces,
+        // cut off from the neighbour that climbs past it.
+        std::vector<uint32_t> degree(out.vertices.size(), 0);
+        for (const ConvexPolyhedron::HalfEdge& edge : out.edges) ++degree[edge.origin];
+        for (uint32_t d : degree) {
+            if (d < 3) {
+                out.clear();
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void ConvexPolyhedron::clear() {
+    vertices.clear();
+    edges.clear();
+    planes.clear();
+    vertexEdges.clear();
+}
+
+bool ConvexPolyhedron::build(const std::vector<glm::vec3>& points) {
+    clear();
+    const ConvexHull hull = buildConvexHull(points, UINT32_MAX);
+    if (hull.indices.size() < 12) return false;
+    glm::vec3 low = hull.vertices[0], high = hull.vertices[0];
+    for (const glm::vec3& v : hull.vertices) {
+        low = glm::min(low, v);
+        high = glm::max(high, v);
+    }
+    // Without merging every triangle is its own face; coplanar neighbours
+    // then meet at creases with no Gauss map arc, which SAT skips.
+    return buildTopology(*this, hull, kPlanarTolerance * glm::length(high - low)) || buildTopology(*this, hull, -1.0f);
+}
+
+void ConvexPolyhedron::transform(const glm::mat4& transform, glm::vec3* outVertices, glm::vec4* outPlanes) const {
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        outVertices[i] = glm::vec3(transform * glm::vec4(vertices[i], 1.0f));
+    }
+    const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+    for (size_t f = 0; f < planes.size(); ++f) {
+        const glm::vec3 normal(planes[f]);
+        const glm::vec3 n = glm::normalize(normalMatrix * normal);
+        const glm::vec3 point = glm::vec3(transform * glm::vec4(normal * planes[f].w, 1.0f));
+        outPlanes[f] = glm::vec4(n, glm::dot(n, point));
+    }
+}
+
+uint32_t polyhedronSupport(const PolyhedronView& view, const glm::vec3& direction, uint32_t start) {
+    const ConvexPolyhedron& shape = *view.shape;
+    uint32_t best = start;
+    float bestDistance = glm::dot(view.vertices[best], direction);
+    for (bool moved = true; moved;) {
+        moved = false;
+        const uint32_t first = shape.vertexEdges[best];
+        uint32_t edge = first;
+        do {
+            const uint32_t neighbour = shape.edges[edge ^ 1].origin;
+            const float distance = glm::dot(view.vertices[neighbour], direction);
+            if (distance > bestDistance) {
+                best = neighbour;
+                bestDistance = distance;
+                moved = true;
+                break;
+            }
+            edge = shape.edges[edge ^ 1].next;
+        } while (edge != first);
+    }
+    return best;
+}
+
+float polyhedronSeparation(const PolyhedronView& a, const PolyhedronView& b, glm::vec3& axis) {
+    glm::vec3 normalA(0.0f), normalB(0.0f);
+    const float faceA = faceSeparation(a, b, normalA);
+    if (faceA > 0.0f) {
+        axis = normalA;
+        return faceA;
+    }
+    const float faceB = faceSeparation(b, a, normalB);
+    if (faceB > 0.0f) {
+        axis = -normalB;
+        return faceB;
+    }
+    float best = faceA;
+    axis = normalA;
+    if (faceB > faceA) {
+        best = faceB;
+        axis = -normalB;
+    }
+
+    // b enters the Minkowski difference mirrored, so its normals are negated.
+    float bestEdge = -FLT_MAX;
+    glm::vec3 edgeAxis(0.0f);
+    const glm::vec3 centerA = a.center + a.offset;
+    const auto& edgesA = a.shape->edges;
+    const auto& edgesB = b.shape->edges;
+    for (size_t i = 0; i < edgesA.size(); i += 2) {
+        const glm::vec3 na(a.planes[edgesA[i].face]);
+        const glm::vec3 nb(a.planes[edgesA[i + 1].face]);
+        const glm::vec3 bxa = glm::cross(nb, na);
+        const glm::vec3 pa = a.vertices[edgesA[i].origin] + a.offset;
+        const glm::vec3 ea = a.vertices[edgesA[i + 1].origin] + a.offset - pa;
+        for (size_t j = 0; j < edgesB.size(); j += 2) {
+            const glm::vec3 nc = -glm::vec3(b.planes[edgesB[j].face]);
+            const glm::vec3 nd = -glm::vec3(b.planes[edgesB[j + 1].face]);
+            if (!isMinkowskiFace(na, nb, bxa, nc, nd)) continue;
+            const glm::vec3 pb = b.vertices[edgesB[j].origin] + b.offset;
+            const glm::vec3 eb = b.vertices[edgesB[j + 1].origin] + b.offset - pb;
+            glm::vec3 n = glm::cross(ea, eb);
+            const float length = glm::length(n);
+            if (length <= kParallelSin * glm::length(ea) * glm::length(eb)) continue;
+            n /= length;
+            if (glm::dot(n, pa - centerA) < 0.0f) n = -n;
+            const float separation = glm::dot(n, pb - pa);
+            if (separation > bestEdge) {
+                bestEdge = separation;
+                edgeAxis = n;
+                if (separation > 0.0f) {
+                    axis = n;
+                    return separation;
+                }
+            }
+        }
+    }
+    if (bestEdge > best + kEdgeTolerance) {
+        axis = edgeAxis;
+        return bestEdge;
+    }
+    return best;
+}
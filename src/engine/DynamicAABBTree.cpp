@@ -0,0 +1,251 @@
+#include <DynamicAABBTree.h>
+#include <algorithm>
+#include <cstdlib>
+
+int32_t DynamicAABBTree::allocateNode() {
+    if (freeList == kNullNode) {
+        nodes.emplace_back();
+        return static_cast<int32_t>(nodes.size() - 1);
+    }
+    int32_t nodeId = freeList;
+    Node& node = nodes[static_cast<size_t>(nodeId)];
+    freeList = node.parent;
+    node = Node{};
+    return nodeId;
+}
+
+void DynamicAABBTree::freeNode(int32_t nodeId) {
+    Node& node = nodes[static_cast<size_t>(nodeId)];
+    node = Node{};
+    node.parent = freeList;
+    freeList = nodeId;
+}
+
+int32_t DynamicAABBTree::createProxy(const ColliderAABB& aabb, Collider* collider, uint32_t layers) {
+    int32_t proxyId = allocateNode();
+    Node& node = nodes[static_cast<size_t>(proxyId)];
+    node.aabb.min = aabb.min - glm::vec3(kAABBMargin);
+    node.aabb.max = aabb.max + glm::vec3(kAABBMargin);
+    node.collider = collider;
+    node.layers = layers;
+    node.height = 0;
+    insertLeaf(proxyId);
+    ++proxyCount;
+    return proxyId;
+}
+
+void DynamicAABBTree::destroyProxy(int32_t proxyId) {
+    if (proxyId < 0 || static_cast<size_t>(proxyId) >= nodes.size()) return;
+    if (!nodes[static_cast<size_t>(proxyId)].isLeaf() || nodes[static_cast<size_t>(proxyId)].height != 0) return;
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --proxyCount;
+}
+
+bool DynamicAABBTree::moveProxy(int32_t proxyId, const ColliderAABB& aabb, const glm::vec3& displacement) {
+    Node& node = nodes[static_cast<size_t>(proxyId)];
+    if (contains(node.aabb, aabb)) {
+        return false;
+    }
+    removeLeaf(proxyId);
+
+    // Predict motion so a steadily moving collider does not reinsert every frame.
+    ColliderAABB fat{aabb.min - glm::vec3(kAABBMargin), aabb.max + glm::vec3(kAABBMargin)};
+    glm::vec3 d = kDisplacementMultiplier * displacement;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (d[axis] < 0.0f) {
+            fat.min[axis] += d[axis];
+        } else {
+            fat.max[axis] += d[axis];
+        }
+    }
+    nodes[static_cast<size_t>(proxyId)].aabb = fat;
+    insertLeaf(proxyId);
+    return true;
+}
+
+void DynamicAABBTree::setProxyLayers(int32_t proxyId, uint32_t layers) {
+    if (proxyId < 0 || static_cast<size_t>(proxyId) >= nodes.size()) return;
+    nodes[static_cast<size_t>(proxyId)].layers = layers;
+    for (int32_t index = nodes[static_cast<size_t>(proxyId)].parent; index != kNullNode;) {
+        Node& node = nodes[static_cast<size_t>(index)];
+        node.layers = nodes[static_cast<size_t>(node.child1)].layers | nodes[static_cast<size_t>(node.child2)].layers;
+        index = node.parent;
+    }
+}
+
+void DynamicAABBTree::clear() {
+    nodes.clear();
+    root = kNullNode;
+    freeList = kNullNode;
+    proxyCount = 0;
+}
+
+void DynamicAABBTree::insertLeaf(int32_t leaf) {
+    if (root == kNullNode) {
+        root = leaf;
+        nodes[static_cast<size_t>(root)].parent = kNullNode;
+        return;
+    }
+
+    // Walk down choosing the child that grows the least in surface area.
+    const ColliderAABB leafAABB = nodes[static_cast<size_t>(leaf)].aabb;
+    int32_t index = root;
+    while (!nodes[static_cast<size_t>(index)].isLeaf()) {
+        const Node& node = nodes[static_cast<size_t>(index)];
+        int32_t child1 = node.child1;
+        int32_t child2 = node.child2;
+
+        float area = surfaceArea(node.aabb);
+        float combinedArea = surfaceArea(combine(node.aabb, leafAABB));
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t child) {
+            const Node& c = nodes[static_cast<size_t>(child)];
+            ColliderAABB merged = combine(leafAABB, c.aabb);
+            if (c.isLeaf()) {
+                return surfaceArea(merged) + inheritanceCost;
+            }
+            return (surfaceArea(merged) - surfaceArea(c.aabb)) + inheritanceCost;
+        };
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = (cost1 < cost2) ? child1 : child2;
+    }
+    int32_t sibling = index;
+
+    int32_t oldParent = nodes[static_cast<size_t>(sibling)].parent;
+    int32_t newParent = allocateNode();
+    Node& parentNode = nodes[static_cast<size_t>(newParent)];
+    parentNode.parent = oldParent;
+    parentNode.aabb = combine(leafAABB, nodes[static_cast<size_t>(sibling)].aabb);
+    parentNode.layers = nodes[static_cast<size_t>(leaf)].layers | nodes[static_cast<size_t>(sibling)].layers;
+    parentNode.height = nodes[static_cast<size_t>(sibling)].height + 1;
+    parentNode.child1 = sibling;
+    parentNode.child2 = leaf;
+    nodes[static_cast<size_t>(sibling)].parent = newParent;
+    nodes[static_cast<size_t>(leaf)].parent = newParent;
+
+    if (oldParent != kNullNode) {
+        Node& op = nodes[static_cast<size_t>(oldParent)];
+        if (op.child1 == sibling) {
+            op.child1 = newParent;
+        } else {
+            op.child2 = newParent;
+        }
+    } else {
+        root = newParent;
+    }
+
+    refitAncestors(nodes[static_cast<size_t>(leaf)].parent);
+}
+
+void DynamicAABBTree::removeLeaf(int32_t leaf) {
+    if (leaf == root) {
+        root = kNullNode;
+        return;
+    }
+    int32_t parent = nodes[static_cast<size_t>(leaf)].parent;
+    int32_t grandParent = nodes[static_cast<size_t>(parent)].parent;
+    int32_t sibling = nodes[static_cast<size_t>(parent)].child1 == leaf
+        ? nodes[static_cast<size_t>(parent)].child2
+        : nodes[static_cast<size_t>(parent)].child1;
+
+    if (grandParent != kNullNode) {
+        Node& gp = nodes[static_cast<size_t>(grandParent)];
+        if (gp.child1 == parent) {
+            gp.child1 = sibling;
+        } else {
+            gp.child2 = sibling;
+        }
+        nodes[static_cast<size_t>(sibling)].parent = grandParent;
+        freeNode(parent);
+        refitAncestors(grandParent);
+    } else {
+        root = sibling;
+        nodes[static_cast<size_t>(sibling)].parent = kNullNode;
+        freeNode(parent);
+    }
+    nodes[static_cast<size_t>(leaf)].parent = kNullNode;
+}
+
+void DynamicAABBTree::refitAncestors(int32_t nodeId) {
+    int32_t index = nodeId;
+    while (index != kNullNode) {
+        index = balance(index);
+        Node& node = nodes[static_cast<size_t>(index)];
+        const Node& c1 = nodes[static_cast<size_t>(node.child1)];
+        const Node& c2 = nodes[static_cast<size_t>(node.child2)];
+        node.height = 1 + std::max(c1.height, c2.height);
+        node.aabb = combine(c1.aabb, c2.aabb);
+        node.layers = c1.layers | c2.layers;
+        index = node.parent;
+    }
+}
+
+// Rotates the subtree rooted at A when one side is more than one level
+// taller than the other. Returns the new subtree root.
+int32_t DynamicAABBTree::balance(int32_t iA) {
+    Node& A = nodes[static_cast<size_t>(iA)];
+    if (A.isLeaf() || A.height < 2) {
+        return iA;
+    }
+    int32_t iB = A.child1;
+    int32_t iC = A.child2;
+    Node& B = nodes[static_cast<size_t>(iB)];
+    Node& C = nodes[static_cast<size_t>(iC)];
+    int32_t diff = C.height - B.height;
+
+    auto rotateUp = [&](int32_t iP, Node& P, int32_t iOther, Node& Other, bool pIsChild2) -> int32_t {
+        int32_t iF = P.child1;
+        int32_t iG = P.child2;
+        Node& F = nodes[static_cast<size_t>(iF)];
+        Node& G = nodes[static_cast<size_t>(iG)];
+
+        P.child1 = iA;
+        P.parent = A.parent;
+        A.parent = iP;
+        if (P.parent != kNullNode) {
+            Node& pp = nodes[static_cast<size_t>(P.parent)];
+            if (pp.child1 == iA) {
+                pp.child1 = iP;
+            } else {
+                pp.child2 = iP;
+            }
+        } else {
+            root = iP;
+        }
+
+        // Keep the taller grandchild under P, hand the shorter one to A.
+        int32_t iKeep = F.height > G.height ? iF : iG;
+        int32_t iGive = F.height > G.height ? iG : iF;
+        Node& keep = nodes[static_cast<size_t>(iKeep)];
+        Node& give = nodes[static_cast<size_t>(iGive)];
+        P.child2 = iKeep;
+        if (pIsChild2) {
+            A.child2 = iGive;
+        } else {
+            A.child1 = iGive;
+        }
+        give.parent = iA;
+        A.aabb = combine(Other.aabb, give.aabb);
+        P.aabb = combine(A.aabb, keep.aabb);
+        A.layers = Other.layers | give.layers;
+        P.layers = A.layers | keep.layers;
+        A.height = 1 + std::max(Other.height, give.height);
+        P.height = 1 + std::max(A.height, keep.height);
+        (void)iOther;
+        return iP;
+    };
+
+    if (diff > 1) {
+        return rotateUp(iC, C, iB, B, true);
+    }
+    if (diff < -1) {
+        return rotateUp(iB, B, iC, C, false);
+    }
+    return iA;
+}
@@ -35,20 +35,30 @@ AABB Entity::getWorldBounds(const glm::mat4& worldTransform) const {
 }
 
 void Entity::addChild(Entity* child) {
-    if (child->parent) {
-        child->parent->removeChild(child);
+    if (Entity* oldParent = child->getParent()) {
+        oldParent->removeChild(child);
     }
     children.push_back(child);
-    child->parent = this;
+    EntityStore::getInstance()->setParent(child->storeId, storeId);
+    child->markTransformDirty();
+    child->onAttached();
 }
 
 void Entity::removeChild(Entity* child) {
     children.erase(std::remove(children.begin(), children.end(), child), children.end());
-    child->parent = nullptr;
+    child->onDetached();
+    EntityStore::getInstance()->setParent(child->storeId, EntityStore::kNone);
+    child->markTransformDirty();
+}
+
+Entity* Entity::getParent() const {
+    const EntityStore* store = EntityStore::getInstance();
+    const EntityStore::Id parent = store->parents[storeId];
+    return parent == EntityStore::kNone ? nullptr : store->owners[parent];
 }
 
 void Entity::moveToParent(Entity* newParent) {
-    if (parent) {
+    if (Entity* parent = getParent()) {
         parent->removeChild(this);
     }
     if (newParent) {
@@ -65,48 +75,61 @@ Entity* Entity::getChild(const std::string& name) {
     return nullptr;
 }
 
-glm::vec3 Entity::getWorldPosition() { return worldPosition; }
+glm::vec3 Entity::getWorldPosition() { return glm::vec3(getWorldTransform()[3]); }
 
-glm::vec3 Entity::getWorldRotation() { return worldRotation; }
+glm::vec3 Entity::getWorldRotation() {
+    const glm::mat4 transform = getWorldTransform();
+    const glm::vec3 worldScale = getWorldScale();
+    glm::mat3 rotationMatrix;
+    rotationMatrix[0] = glm::vec3(transform[0]) / worldScale.x;
+    rotationMatrix[1] = glm::vec3(transform[1]) / worldScale.y;
+    rotationMatrix[2] = glm::vec3(transform[2]) / worldScale.z;
 
-glm::vec3 Entity::getWorldScale() { return worldScale; }
+    glm::vec3 worldRotation;
+    worldRotation.x = glm::degrees(std::atan2(rotationMatrix[1][2], rotationMatrix[2][2]));
+    worldRotation.y = glm::degrees(std::atan2(-rotationMatrix[0][2], std::sqrt(rotationMatrix[1][2] * rotationMatrix[1][2] + rotationMatrix[2][2] * rotationMatrix[2][2])));
+    worldRotation.z = glm::degrees(std::atan2(rotationMatrix[0][1], rotationMatrix[0][0]));
+    return worldRotation;
+}
 
-glm::mat4 Entity::getWorldTransform() { return worldTransform; }
+glm::vec3 Entity::getWorldScale() {
+    const glm::mat4 transform = getWorldTransform();
+    return glm::vec3(glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])));
+}
 
-void Entity::updateWorldTransform() {
-    glm::mat4 transform(1.0f);
-    std::vector<Entity*> hierarchy;
-    for (Entity* current = this; current != nullptr; current = current->getParent()) {
-        hierarchy.push_back(current);
+glm::mat4 Entity::getWorldTransform() { return EntityStore::getInstance()->worldTransforms[storeId]; }
+
+void Entity::markTransformDirty() {
+    uint8_t& dirty = EntityStore::getInstance()->transformDirty[storeId];
+    if (dirty) return;
+    dirty = 1;
+    for (Entity* child : children) {
+        child->markTransformDirty();
     }
+}
 
-    for (int i = static_cast<int>(hierarchy.size()) - 1; i >= 0; --i) {
-        Entity* current = hierarchy[i];
-        transform = glm::translate(transform, current->getPosition());
-        glm::vec3 rot = current->getRotation();
-        transform = glm::rotate(transform, glm::radians(rot.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        transform = glm::rotate(transform, glm::radians(rot.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        transform = glm::rotate(transform, glm::radians(rot.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        transform = glm::scale(transform, current->getScale());
+void Entity::refreshWorldTransform() {
+    EntityStore* store = EntityStore::getInstance();
+    // Applying our own steps to the parent's world matrix gives the same
+    // result, bit for bit, as replaying every ancestor's steps from the root.
+    glm::mat4 transform(1.0f);
+    if (Entity* parent = getParent()) {
+        parent->updateWorldTransform();
+        transform = store->worldTransforms[parent->storeId];
     }
-    
-    worldTransform = transform;
+    transform = glm::translate(transform, store->positions[storeId]);
+    glm::vec3 rot = store->rotations[storeId];
+    transform = glm::rotate(transform, glm::radians(rot.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    transform = glm::rotate(transform, glm::radians(rot.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    transform = glm::rotate(transform, glm::radians(rot.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    transform = glm::scale(transform, store->scales[storeId]);
 
-    worldPosition = glm::vec3(transform[3]);
-    
-    glm::vec3 scaleX = glm::vec3(transform[0]);
-    glm::vec3 scaleY = glm::vec3(transform[1]);
-    glm::vec3 scaleZ = glm::vec3(transform[2]);
-    worldScale = glm::vec3(glm::length(scaleX), glm::length(scaleY), glm::length(scaleZ));
-    
-    glm::mat3 rotationMatrix;
-    rotationMatrix[0] = scaleX / worldScale.x;
-    rotationMatrix[1] = scaleY / worldScale.y;
-    rotationMatrix[2] = scaleZ / worldScale.z;
-    
-    worldRotation.x = glm::degrees(std::atan2(rotationMatrix[1][2], rotationMatrix[2][2]));
-    worldRotation.y = glm::degrees(std::atan2(-rotationMatrix[0][2], std::sqrt(rotationMatrix[1][2] * rotationMatrix[1][2] + rotationMatrix[2][2] * rotationMatrix[2][2])));
-    worldRotation.z = glm::degrees(std::atan2(rotationMatrix[0][1], rotationMatrix[0][0]));
+    store->transformDirty[storeId] = 0;
+    glm::mat4& worldTransform = store->worldTransforms[storeId];
+    if (transform != worldTransform) {
+        worldTransform = transform;
+        onWorldTransformChanged();
+    }
 }
 
 void Entity::loadTextures() {
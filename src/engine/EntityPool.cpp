@@ -0,0 +1,61 @@
+#include <EntityPool.h>
+#include <cstddef>
+#include <new>
+
+EntityPool* EntityPool::getInstance() {
+    // Never destroyed: entities owned by other singletons may still be freed at exit.
+    static EntityPool* instance = new EntityPool();
+    return instance;
+}
+
+void* EntityPool::allocate(size_t size) {
+    if (size == 0 || size > kMaxPooledSize) {
+        return ::operator new(size);
+    }
+    const size_t index = sizeClass(size);
+    if (!freeLists[index]) {
+        refill(index);
+    }
+    FreeBlock* block = freeLists[index];
+    freeLists[index] = block->next;
+    ++live;
+    return block;
+}
+
+void EntityPool::deallocate(void* block, size_t size) {
+    if (!block) return;
+    if (size == 0 || size > kMaxPooledSize) {
+        ::operator delete(block);
+        return;
+    }
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    const size_t index = sizeClass(size);
+    freed->next = freeLists[index];
+    freeLists[index] = freed;
+    --live;
+}
+
+void EntityPool::refill(size_t index) {
+    // Operator new's alignment covers every entity type, and block sizes
+    // are multiples of it, so every block in the chunk stays aligned.
+    const size_t blockSize = (index + 1) * kGranularity;
+    const size_t blocks = kChunkSize / blockSize;
+    std::byte* chunk = static_cast<std::byte*>(::operator new(kChunkSize));
+    chunks.push_back(chunk);
+    // Threaded back to front so blocks are handed out in address order.
+    for (size_t i = blocks; i-- > 0;) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+        block->next = freeLists[index];
+        freeLists[index] = block;
+    }
+}
+
+bool EntityPool::releaseChunks() {
+    if (live > 0) return false;
+    for (void* chunk : chunks) {
+        ::operator delete(chunk);
+    }
+    chunks.clear();
+    freeLists.fill(nullptr);
+    return true;
+}
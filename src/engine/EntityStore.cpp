@@ -0,0 +1,128 @@
+#include <EntityStore.h>
+#include <Entity.h>
+
+EntityStore* EntityStore::getInstance() {
+    // Never destroyed: entities owned by other singletons may still be freed at exit.
+    static EntityStore* instance = new EntityStore();
+    return instance;
+}
+
+EntityStore::RenderPass EntityStore::renderPassFor(const std::string& shader) {
+    if (shader == "gbuffer") return RenderPass::GBuffer;
+    if (shader == "skybox") return RenderPass::Skybox;
+    return RenderPass::None;
+}
+
+EntityStore::Id EntityStore::create(Entity* owner, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale, RenderPass pass) {
+    const Id id = static_cast<Id>(owners.size());
+    owners.push_back(owner);
+    parents.push_back(kNone);
+    subtreeEnds.push_back(id + 1);
+    positions.push_back(position);
+    rotations.push_back(rotation);
+    scales.push_back(scale);
+    worldTransforms.push_back(glm::mat4(1.0f));
+    transformDirty.push_back(1);
+    models.push_back(nullptr);
+    active.push_back(1);
+    renderPasses.push_back(pass);
+    sceneDirty = true;
+
+    EntityHandle& handle = owner->handle;
+    if (freeHandles.empty()) {
+        handle.index = static_cast<uint32_t>(handleOwners.size());
+        handleOwners.push_back(owner);
+        handleGenerations.push_back(1);
+    } else {
+        handle.index = freeHandles.back();
+        freeHandles.pop_back();
+        handleOwners[handle.index] = owner;
+    }
+    handle.generation = handleGenerations[handle.index];
+    return id;
+}
+
+void EntityStore::destroy(Id id) {
+    const uint32_t index = owners[id]->handle.index;
+    handleOwners[index] = nullptr;
+    // Zero is skipped so a default handle never resolves.
+    if (++handleGenerations[index] == 0) handleGenerations[index] = 1;
+    freeHandles.push_back(index);
+
+    owners[id] = nullptr;
+    parents[id] = kNone;
+    models[id] = nullptr;
+    // Holes read as inactive, so render scans pass over them.
+    active[id] = 0;
+    sceneDirty = true;
+}
+
+void EntityStore::setParent(Id id, Id parent) {
+    parents[id] = parent;
+    sceneDirty = true;
+}
+
+template <typename T>
+void EntityStore::permute(std::vector<T>& column, const std::vector<Id>& order) {
+    std::vector<T> sorted;
+    sorted.reserve(order.size());
+    for (Id from : order) {
+        sorted.push_back(column[from]);
+    }
+    column.swap(sorted);
+}
+
+size_t EntityStore::sortScene(const std::vector<Entity*>& roots) {
+    // newSlots[old] is where the entity in slot old ends up.
+    std::vector<Id> newSlots(owners.size(), kNone);
+    std::vector<Id> order;
+    order.reserve(owners.size());
+    std::vector<Id> ends;
+    ends.reserve(owners.size());
+
+    auto visit = [&](auto&& self, Entity* entity) -> void {
+        const Id from = entity->storeId;
+        if (newSlots[from] != kNone) return;
+        const size_t at = order.size();
+        newSlots[from] = static_cast<Id>(at);
+        order.push_back(from);
+        ends.push_back(0);
+        for (Entity* child : entity->getChildren()) {
+            self(self, child);
+        }
+        ends[at] = static_cast<Id>(order.size());
+    };
+    for (Entity* root : roots) {
+        visit(visit, root);
+    }
+    const size_t sceneCount = order.size();
+
+    for (size_t slot = 0; slot < owners.size(); ++slot) {
+        if (owners[slot] && newSlots[slot] == kNone) {
+            newSlots[slot] = static_cast<Id>(order.size());
+            order.push_back(static_cast<Id>(slot));
+            ends.push_back(static_cast<Id>(order.size()));
+        }
+    }
+
+    permute(owners, order);
+    permute(parents, order);
+    permute(positions, order);
+    permute(rotations, order);
+    permute(scales, order);
+    permute(worldTransforms, order);
+    permute(transformDirty, order);
+    permute(models, order);
+    permute(active, order);
+    permute(renderPasses, order);
+    subtreeEnds.swap(ends);
+
+    for (size_t slot = 0; slot < owners.size(); ++slot) {
+        owners[slot]->storeId = static_cast<Id>(slot);
+        if (parents[slot] != kNone) {
+            parents[slot] = newSlots[parents[slot]];
+        }
+    }
+    sceneDirty = false;
+    return sceneCount;
+}
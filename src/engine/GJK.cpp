@@ -0,0 +1,622 @@
+#include <GJK.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxGJKIterations = 64;
+constexpr int kMaxEPAIterations = 64;
+constexpr float kGJKRelativeEpsilon = 1e-6f;
+constexpr float kEPATolerance = 1e-4f;
+constexpr int kMaxCastIterations = 32;
+constexpr float kCastTolerance = 1e-3f;
+constexpr int kMaxCastBisections = 16;
+
+struct SupportPoint {
+    glm::vec3 w;  // a - b
+    glm::vec3 a;
+    glm::vec3 b;
+};
+
+SupportPoint minkowskiSupport(const ConvexShape& a, const ConvexShape& b, const glm::vec3& dir) {
+    SupportPoint p;
+    p.a = a.support(dir);
+    p.b = b.support(-dir);
+    p.w = p.a - p.b;
+    return p;
+}
+
+// Simplex with barycentric weights of the point closest to the origin. Solving
+// drops every vertex whose weight is zero so at most four survive.
+struct Simplex {
+    std::array<SupportPoint, 4> verts;
+    std::array<float, 4> weights{};
+    int count = 0;
+
+    void keep(std::initializer_list<std::pair<int, float>> kept) {
+        std::array<SupportPoint, 4> v;
+        int n = 0;
+        for (const auto& [index, weight] : kept) {
+            v[n] = verts[index];
+            weights[n] = weight;
+            ++n;
+        }
+        verts = v;
+        count = n;
+    }
+
+    glm::vec3 closest() const {
+        glm::vec3 p(0.0f);
+        for (int i = 0; i < count; ++i) p += weights[i] * verts[i].w;
+        return p;
+    }
+
+    void witnessPoints(glm::vec3& pa, glm::vec3& pb) const {
+        pa = glm::vec3(0.0f);
+        pb = glm::vec3(0.0f);
+        for (int i = 0; i < count; ++i) {
+            pa += weights[i] * verts[i].a;
+            pb += weights[i] * verts[i].b;
+        }
+    }
+};
+
+void solveSegment(Simplex& s, int ia, int ib) {
+    const glm::vec3 a = s.verts[ia].w;
+    const glm::vec3 ab = s.verts[ib].w - a;
+    float denom = glm::dot(ab, ab);
+    float t = denom > 0.0f ? glm::dot(-a, ab) / denom : 0.0f;
+    if (t <= 0.0f) {
+        s.keep({{ia, 1.0f}});
+    } else if (t >= 1.0f) {
+        s.keep({{ib, 1.0f}});
+    } else {
+        s.keep({{ia, 1.0f - t}, {ib, t}});
+    }
+}
+
+// Closest point on triangle to the origin (Ericson, Real-Time Collision Detection 5.1.5).
+void solveTriangle(Simplex& s, int ia, int ib, int ic) {
+    const glm::vec3 a = s.verts[ia].w;
+    const glm::vec3 b = s.verts[ib].w;
+    const glm::vec3 c = s.verts[ic].w;
+    const glm::vec3 ab = b - a;
+    const glm::vec3 ac = c - a;
+
+    float d1 = glm::dot(ab, -a);
+    float d2 = glm::dot(ac, -a);
+    if (d1 <= 0.0f && d2 <= 0.0f) { s.keep({{ia, 1.0f}}); return; }
+
+    float d3 = glm::dot(ab, -b);
+    float d4 = glm::dot(ac, -b);
+    if (d3 >= 0.0f && d4 <= d3) { s.keep({{ib, 1.0f}}); return; }
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        float v = d1 / (d1 - d3);
+        s.keep({{ia, 1.0f - v}, {ib, v}});
+        return;
+    }
+
+    float d5 = glm::dot(ab, -c);
+    float d6 = glm::dot(ac, -c);
+    if (d6 >= 0.0f && d5 <= d6) { s.keep({{ic, 1.0f}}); return; }
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        float w = d2 / (d2 - d6);
+        s.keep({{ia, 1.0f - w}, {ic, w}});
+        return;
+    }
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        s.keep({{ib, 1.0f - w}, {ic, w}});
+        return;
+    }
+
+    float denom = va + vb + vc;
+    if (std::abs(denom) < 1e-12f) {
+        // Degenerate triangle: fall back to its longest edge.
+        solveSegment(s, ia, glm::dot(ab, ab) > glm::dot(ac, ac) ? ib : ic);
+        return;
+    }
+    float v = vb / denom;
+    float w = vc / denom;
+    s.keep({{ia, 1.0f - v - w}, {ib, v}, {ic, w}});
+}
+
+// True when the origin and d lie on opposite sides of plane abc.
+bool originOutsideFace(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d) {
+    glm::vec3 n = glm::cross(b - a, c - a);
+    float signOrigin = glm::dot(-a, n);
+    float signD = glm::dot(d - a, n);
+    if (signD * signD < 1e-12f) return true;
+    return signOrigin * signD < 0.0f;
+}
+
+// Returns true when the origin lies inside the tetrahedron.
+bool solveTetrahedron(Simplex& s) {
+    static const int faces[4][4] = {{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+    float bestDist = std::numeric_limits<float>::max();
+    Simplex best;
+    bool anyOutside = false;
+    for (const auto& f : faces) {
+        if (!originOutsideFace(s.verts[f[0]].w, s.verts[f[1]].w, s.verts[f[2]].w, s.verts[f[3]].w)) continue;
+        anyOutside = true;
+        Simplex candidate = s;
+        solveTriangle(candidate, f[0], f[1], f[2]);
+        glm::vec3 p = candidate.closest();
+        float dist = glm::dot(p, p);
+        if (dist < bestDist) {
+            bestDist = dist;
+            best = candidate;
+        }
+    }
+    if (!anyOutside) return true;
+    s = best;
+    return false;
+}
+
+// Runs GJK and leaves the final simplex in `s`. Returns true on overlap.
+// `hint` seeds the search, e.g. with the separating axis of a previous query.
+bool runGJK(const ConvexShape& a, const ConvexShape& b, Simplex& s, glm::vec3& v, const glm::vec3* hint = nullptr) {
+    glm::vec3 dir = hint ? *hint : a.center - b.center;
+    if (glm::dot(dir, dir) < 1e-12f) dir = glm::vec3(1.0f, 0.0f, 0.0f);
+    s.count = 1;
+    s.verts[0] = minkowskiSupport(a, b, -dir);
+    s.weights[0] = 1.0f;
+    v = s.verts[0].w;
+
+    for (int iter = 0; iter < kMaxGJKIterations; ++iter) {
+        float vv = glm::dot(v, v);
+        if (vv < 1e-12f) return true;
+
+        SupportPoint w = minkowskiSupport(a, b, -v);
+        if (vv - glm::dot(v, w.w) <= kGJKRelativeEpsilon * vv) return false;
+
+        bool duplicate = false;
+        for (int i = 0; i < s.count; ++i) {
+            glm::vec3 d = s.verts[i].w - w.w;
+            if (glm::dot(d, d) < 1e-12f) { duplicate = true; break; }
+        }
+        if (duplicate) return false;
+
+        s.verts[s.count++] = w;
+        switch (s.count) {
+            case 2: solveSegment(s, 0, 1); break;
+            case 3: solveTriangle(s, 0, 1, 2); break;
+            case 4:
+                if (solveTetrahedron(s)) {
+                    v = glm::vec3(0.0f);
+                    return true;
+                }
+                break;
+            default: break;
+        }
+        glm::vec3 next = s.closest();
+        if (glm::dot(next, next) >= vv) return false;  // no progress
+        v = next;
+    }
+    return glm::dot(v, v) < 1e-8f;
+}
+
+// Grows a degenerate GJK result into a tetrahedron that encloses the origin.
+bool completeTetrahedron(const ConvexShape& a, const ConvexShape& b, Simplex& s) {
+    static const glm::vec3 kAxes[6] = {
+        {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+        {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}
+    };
+    if (s.count == 1) {
+        for (const auto& axis : kAxes) {
+            SupportPoint p = minkowskiSupport(a, b, axis);
+            if (glm::length(p.w - s.verts[0].w) > 1e-5f) {
+                s.verts[s.count++] = p;
+                break;
+            }
+        }
+    }
+    if (s.count == 2) {
+        glm::vec3 d = s.verts[1].w - s.verts[0].w;
+        glm::vec3 ref = std::abs(d.x) < 0.9f * glm::length(d) ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        glm::vec3 perp = glm::normalize(glm::cross(d, ref));
+        glm::vec3 perp2 = glm::normalize(glm::cross(d, perp));
+        const glm::vec3 dirs[4] = {perp, -perp, perp2, -perp2};
+        for (const auto& dir : dirs) {
+            SupportPoint p = minkowskiSupport(a, b, dir);
+            if (glm::length(glm::cross(p.w - s.verts[0].w, d)) > 1e-5f) {
+                s.verts[s.count++] = p;
+                break;
+            }
+        }
+    }
+    if (s.count == 3) {
+        glm::vec3 n = glm::cross(s.verts[1].w - s.verts[0].w, s.verts[2].w - s.verts[0].w);
+        if (glm::dot(n, n) < 1e-12f) return false;
+        n = glm::normalize(n);
+        SupportPoint p = minkowskiSupport(a, b, n);
+        if (std::abs(glm::dot(p.w - s.verts[0].w, n)) < 1e-5f) p = minkowskiSupport(a, b, -n);
+        if (std::abs(glm::dot(p.w - s.verts[0].w, n)) < 1e-5f) return false;
+        s.verts[s.count++] = p;
+    }
+    return s.count == 4;
+}
+
+struct EPAFace {
+    int i0, i1, i2;
+    glm::vec3 normal;
+    float distance;
+};
+
+bool makeFace(const std::vector<SupportPoint>& pts, int i0, int i1, int i2, EPAFace& face) {
+    glm::vec3 n = glm::cross(pts[i1].w - pts[i0].w, pts[i2].w - pts[i0].w);
+    float len = glm::length(n);
+    if (len < 1e-10f) return false;
+    face.i0 = i0; face.i1 = i1; face.i2 = i2;
+    face.normal = n / len;
+    face.distance = glm::dot(face.normal, pts[i0].w);
+    return true;
+}
+
+void fillContact(const std::vector<SupportPoint>& pts, const EPAFace& face, GJKResult& out) {
+    const glm::vec3 a = pts[face.i0].w;
+    const glm::vec3 b = pts[face.i1].w;
+    const glm::vec3 c = pts[face.i2].w;
+    const glm::vec3 p = face.normal * face.distance;
+    const glm::vec3 v0 = b - a, v1 = c - a, v2 = p - a;
+    float d00 = glm::dot(v0, v0), d01 = glm::dot(v0, v1), d11 = glm::dot(v1, v1);
+    float d20 = glm::dot(v2, v0), d21 = glm::dot(v2, v1);
+    float denom = d00 * d11 - d01 * d01;
+    float v = 0.0f, w = 0.0f;
+    if (std::abs(denom) > 1e-12f) {
+        v = (d11 * d20 - d01 * d21) / denom;
+        w = (d00 * d21 - d01 * d20) / denom;
+    }
+    float u = 1.0f - v - w;
+    out.pointA = u * pts[face.i0].a + v * pts[face.i1].a + w * pts[face.i2].a;
+    out.pointB = u * pts[face.i0].b + v * pts[face.i1].b + w * pts[face.i2].b;
+    // The face normal points out of A-B; A has to move against it.
+    out.normal = -face.normal;
+    out.penetration = std::max(face.distance, 0.0f);
+}
+
+bool runEPA(const ConvexShape& a, const ConvexShape& b, const Simplex& s, GJKResult& out) {
+    std::vector<SupportPoint> pts(s.verts.begin(), s.verts.begin() + 4);
+    std::vector<EPAFace> faces;
+    faces.reserve(32);
+    const glm::vec3 centroid = 0.25f * (pts[0].w + pts[1].w + pts[2].w + pts[3].w);
+    static const int kTetraFaces[4][3] = {{0, 1, 2}, {0, 3, 1}, {0, 2, 3}, {1, 3, 2}};
+    for (const auto& f : kTetraFaces) {
+        EPAFace face;
+        if (!makeFace(pts, f[0], f[1], f[2], face)) return false;
+        if (glm::dot(face.normal, pts[f[0]].w - centroid) < 0.0f) {
+            makeFace(pts, f[0], f[2], f[1], face);
+        }
+        faces.push_back(face);
+    }
+
+    std::vector<std::pair<int, int>> horizon;
+    for (int iter = 0; iter < kMaxEPAIterations; ++iter) {
+        size_t closest = 0;
+        for (size_t i = 1; i < faces.size(); ++i) {
+            if (faces[i].distance < faces[closest].distance) closest = i;
+        }
+        const EPAFace face = faces[closest];
+        SupportPoint p = minkowskiSupport(a, b, face.normal);
+        float growth = glm::dot(p.w, face.normal) - face.distance;
+        if (growth < kEPATolerance) {
+            fillContact(pts, face, out);
+            return true;
+        }
+
+        int newIndex = static_cast<int>(pts.size());
+        pts.push_back(p);
+
+        // Remove every face that sees the new point and keep the boundary edges.
+        horizon.clear();
+        auto addEdge = [&](int e0, int e1) {
+            for (size_t i = 0; i < horizon.size(); ++i) {
+                if (horizon[i].first == e1 && horizon[i].second == e0) {
+                    horizon[i] = horizon.back();
+                    horizon.pop_back();
+                    return;
+                }
+            }
+            horizon.emplace_back(e0, e1);
+        };
+        for (size_t i = 0; i < faces.size();) {
+            const EPAFace& f = faces[i];
+            if (glm::dot(f.normal, p.w - pts[f.i0].w) > 0.0f) {
+                addEdge(f.i0, f.i1);
+                addEdge(f.i1, f.i2);
+                addEdge(f.i2, f.i0);
+                faces[i] = faces.back();
+                faces.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        for (const auto& [e0, e1] : horizon) {
+            EPAFace nf;
+            if (makeFace(pts, e0, e1, newIndex, nf)) faces.push_back(nf);
+        }
+        if (faces.empty()) {
+            fillContact(pts, face, out);
+            return true;
+        }
+    }
+
+    size_t closest = 0;
+    for (size_t i = 1; i < faces.size(); ++i) {
+        if (faces[i].distance < faces[closest].distance) closest = i;
+    }
+    fillContact(pts, faces[closest], out);
+    return true;
+}
+
+bool isRounded(const ConvexShape& shape) {
+    return shape.kind == ConvexShape::Kind::Sphere || shape.kind == ConvexShape::Kind::Capsule;
+}
+
+// GJK normals between parallel faces far from the origin carry float noise.
+// When the contact lies inside a single face of a box or triangle target,
+// that face's normal is exact, so use it instead.
+void snapToFace(const ConvexShape& target, ShapeCastResult& hit) {
+    constexpr float kFaceEps = 2.0f * kCastTolerance;
+    if (target.kind == ConvexShape::Kind::Box) {
+        const glm::vec3 rel = hit.point - target.center;
+        int face = -1;
+        for (int i = 0; i < 3; ++i) {
+            const float x = glm::dot(rel, target.axes[i]);
+            const float h = target.halfExtents[i];
+            if (std::abs(std::abs(x) - h) <= kFaceEps) {
+                if (face >= 0) return;  // edge or corner
+                face = i;
+            } else if (std::abs(x) > h) {
+                return;
+            }
+        }
+        if (face < 0) return;
+        glm::vec3 n = target.axes[face];
+        if (glm::dot(n, hit.normal) < 0.0f) n = -n;
+        hit.normal = n;
+        return;
+    }
+    if (target.kind == ConvexShape::Kind::Points && target.pointCount == 3) {
+        const glm::vec3& a = target.points[0];
+        const glm::vec3& b = target.points[1];
+        const glm::vec3& c = target.points[2];
+        glm::vec3 n = glm::cross(b - a, c - a);
+        const float area2 = glm::dot(n, n);
+        if (area2 < 1e-12f) return;
+        const glm::vec3 p = hit.point - target.offset;
+        const float u = glm::dot(glm::cross(c - b, p - b), n) / area2;
+        const float v = glm::dot(glm::cross(a - c, p - c), n) / area2;
+        const float w = 1.0f - u - v;
+        constexpr float kInterior = 1e-3f;
+        if (u < kInterior || v < kInterior || w < kInterior) return;
+        n /= std::sqrt(area2);
+        if (glm::dot(n, hit.normal) < 0.0f) n = -n;
+        hit.normal = n;
+    }
+}
+
+} // namespace
+
+glm::vec3 ConvexShape::support(const glm::vec3& dir) const {
+    switch (kind) {
+        case Kind::Box: {
+            glm::vec3 p = center;
+            for (int i = 0; i < 3; ++i) {
+                float s = glm::dot(dir, axes[i]) >= 0.0f ? 1.0f : -1.0f;
+                p += axes[i] * (s * halfExtents[i]);
+            }
+            return p;
+        }
+        case Kind::Points: {
+            if (pointCount == 0) return center;
+            size_t best = 0;
+            float bestDot = glm::dot(points[0], dir);
+            for (size_t i = 1; i < pointCount; ++i) {
+                float d = glm::dot(points[i], dir);
+                if (d > bestDot) {
+                    bestDot = d;
+                    best = i;
+                }
+            }
+            return points[best] + offset;
+        }
+        case Kind::Sphere: {
+            float len = glm::length(dir);
+            return len > 1e-12f ? center + dir * (radius / len) : center;
+        }
+        case Kind::Capsule: {
+            const glm::vec3 tip = center + axes[1] * (glm::dot(dir, axes[1]) >= 0.0f ? halfLength : -halfLength);
+            float len = glm::length(dir);
+            return len > 1e-12f ? tip + dir * (radius / len) : tip;
+        }
+    }
+    return center;
+}
+
+bool gjkDistance(const ConvexShape& a, const ConvexShape& b, GJKResult& out, const glm::vec3* hint) {
+    Simplex s;
+    glm::vec3 v;
+    out = GJKResult{};
+    if (runGJK(a, b, s, v, hint)) {
+        out.intersecting = true;
+        return true;
+    }
+    s.witnessPoints(out.pointA, out.pointB);
+    out.distance = glm::length(v);
+    out.normal = out.distance > 0.0f ? v / out.distance : glm::vec3(0.0f);
+    return false;
+}
+
+bool gjkPenetration(const ConvexShape& a, const ConvexShape& b, GJKResult& out) {
+    Simplex s;
+    glm::vec3 v;
+    out = GJKResult{};
+    if (!runGJK(a, b, s, v)) {
+        s.witnessPoints(out.pointA, out.pointB);
+        out.distance = glm::length(v);
+        return false;
+    }
+    out.intersecting = true;
+    if (!completeTetrahedron(a, b, s) || !runEPA(a, b, s, out)) {
+        // Touching or flat contact: report zero depth along the centre line.
+        glm::vec3 d = a.center - b.center;
+        float len = glm::length(d);
+        out.normal = len > 1e-6f ? d / len : glm::vec3(0.0f, 1.0f, 0.0f);
+        out.penetration = 0.0f;
+    }
+    return true;
+}
+
+bool separatedAlong(const ConvexShape& a, const ConvexShape& b, const glm::vec3& axis) {
+    return glm::dot(axis, a.support(-axis)) > glm::dot(axis, b.support(axis));
+}
+
+bool sweptSeparatedAlong(const ConvexShape& a, const glm::vec3& direction, float maxDistance, const ConvexShape& b, const glm::vec3& axis) {
+    const float closing = std::min(glm::dot(axis, direction), 0.0f) * maxDistance;
+    return glm::dot(axis, a.support(-axis)) + closing > glm::dot(axis, b.support(axis));
+}
+
+bool gjkCast(const ConvexShape& moving, const glm::vec3& direction, float maxDistance, const ConvexShape& target, ShapeCastResult& out, glm::vec3* separatingAxis) {
+    out = ShapeCastResult{};
+    if (separatingAxis && *separatingAxis != glm::vec3(0.0f) &&
+        sweptSeparatedAlong(moving, direction, maxDistance, target, *separatingAxis)) {
+        return false;
+    }
+    // Spheres and capsules are swept as their core point or segment plus a
+    // margin: GJK is exact on the core but converges slowly and noisily on
+    // the curved surface.
+    ConvexShape movingCore = moving;
+    ConvexShape targetCore = target;
+    float margin = 0.0f;
+    if (isRounded(moving)) {
+        margin += moving.radius;
+        movingCore.radius = 0.0f;
+    }
+    const float targetRadius = isRounded(target) ? target.radius : 0.0f;
+    if (isRounded(target)) {
+        margin += target.radius;
+        targetCore.radius = 0.0f;
+    }
+    // Fills r with the separation of the shapes at travel t; false if they
+    // overlap. Each query starts from the previous normal, which is close to
+    // the answer as the shapes only ever move a little between them.
+    glm::vec3 lastNormal = separatingAxis ? *separatingAxis : glm::vec3(0.0f);
+    auto separated = [&](float t, GJKResult& r) {
+        ConvexShape swept = movingCore;
+        swept.translate(direction * t);
+        const bool warm = lastNormal != glm::vec3(0.0f);
+        if (gjkDistance(swept, targetCore, r, warm ? &lastNormal : nullptr) || r.distance <= margin) return false;
+        lastNormal = r.normal;
+        r.distance -= margin;
+        r.pointB += r.normal * targetRadius;
+        return true;
+    };
+    // The last separating normal is the best first guess for the next query on this pair.
+    auto remember = [&]() {
+        if (separatingAxis) *separatingAxis = lastNormal;
+    };
+
+    GJKResult r;
+    float t = 0.0f;
+    float separatedAt = 0.0f;
+    bool converged = false;
+    for (int i = 0; i < kMaxCastIterations; ++i) {
+        if (!separated(t, r)) {
+            if (i == 0) {
+                gjkPenetration(moving, target, r);
+                out.distance = 0.0f;
+                out.normal = r.normal;
+                out.point = r.pointB;
+                remember();
+                return true;
+            }
+            // The last advance can overshoot by GJK's tolerance; bisect back to first contact.
+            float lo = separatedAt;
+            float hi = t;
+            for (int k = 0; k < kMaxCastBisections && hi - lo > 0.5f * kCastTolerance; ++k) {
+                const float mid = 0.5f * (lo + hi);
+                if (separated(mid, r)) {
+                    lo = mid;
+                    out.normal = r.normal;
+                    out.point = r.pointB;
+                } else {
+                    hi = mid;
+                }
+            }
+            t = lo;
+            converged = true;
+            break;
+        }
+        separatedAt = t;
+        out.normal = r.normal;
+        out.point = r.pointB;
+        const float approach = -glm::dot(direction, r.normal);
+        if (r.distance < kCastTolerance) {
+            // Touching but sliding along or away from the contact: the plane
+            // through it separates the shapes for the rest of the sweep.
+            if (approach <= 1e-6f) {
+                remember();
+                return false;
+            }
+            // Close the remaining gap along the current normal.
+            t = std::min(t + r.distance / approach, maxDistance);
+            converged = true;
+            break;
+        }
+        // Everything of target lies behind the plane through its closest point,
+        // so moving until that plane is reached cannot skip a contact. Stopping
+        // just short keeps the shapes apart, so the next query still yields the
+        // normal of the feature actually hit.
+        if (approach <= 1e-6f) {
+            remember();
+            return false;
+        }
+        t += (r.distance - 0.5f * kCastTolerance) / approach;
+        if (t > maxDistance) {
+            remember();
+            return false;
+        }
+    }
+    // Out of iterations short of contact. Advancing never passes the first
+    // contact, so the impact is no earlier than t: report it there rather
+    // than a miss the caller would tunnel through.
+    if (!converged) {
+        if (separated(t, r)) {
+            out.normal = r.normal;
+            out.point = r.pointB;
+        } else {
+            t = separatedAt;
+        }
+    }
+    out.distance = t;
+    snapToFace(target, out);
+    remember();
+    return true;
+}
+
+bool timeOfImpact(const ConvexShape& a, const glm::vec3& motionA, const ConvexShape& b, const glm::vec3& motionB, ShapeCastResult& out) {
+    const glm::vec3 relative = motionA - motionB;
+    const float length = glm::length(relative);
+    if (length <= kGJKRelativeEpsilon) {
+        out = ShapeCastResult{};
+        GJKResult r;
+        if (!gjkPenetration(a, b, r)) return false;
+        out.normal = r.normal;
+        out.point = r.pointB;
+        return true;
+    }
+    if (!gjkCast(a, relative / length, length, b, out)) return false;
+    out.distance /= length;
+    out.point += motionB * out.distance;
+    return true;
+}
@@ -0,0 +1,325 @@
+#include <HeightfieldCollider.h>
+#include <CollisionWorld.h>
+#include <GJK.h>
+#include <TextureManager.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <iostream>
+#include <utility>
+
+void HeightfieldCollider::setHeights(uint32_t columns, uint32_t rows, std::vector<uint16_t> samples, const glm::vec2& spacing, float heightScale, float heightOffset) {
+    heights.clear();
+    this->columns = 0;
+    this->rows = 0;
+    if (columns < 2 || rows < 2 || samples.size() != static_cast<size_t>(columns) * rows || spacing.x <= 0.0f || spacing.y <= 0.0f) {
+        std::cerr << "HeightfieldCollider::setHeights - invalid grid (" << columns << " x " << rows << ", " << samples.size() << " samples)\n";
+        CollisionWorld::getInstance()->updateCollider(this);
+        return;
+    }
+    heights = std::move(samples);
+    this->columns = columns;
+    this->rows = rows;
+    this->spacing = spacing;
+    this->heightScale = heightScale;
+    this->heightOffset = heightOffset;
+    gridOrigin = glm::vec2(-0.5f * spacing.x * (columns - 1), -0.5f * spacing.y * (rows - 1));
+    const auto [low, high] = std::minmax_element(heights.begin(), heights.end());
+    minSample = *low;
+    maxSample = *high;
+    cacheValid = false;
+    CollisionWorld::getInstance()->updateCollider(this);
+}
+
+bool HeightfieldCollider::loadHeightmap(const std::string& path, const glm::vec2& spacing, float heightRange, float heightOffset) {
+    std::vector<uint16_t> samples;
+    int width = 0;
+    int height = 0;
+    if (!TextureManager::loadHeightmap(path, samples, width, height)) return false;
+    setHeights(static_cast<uint32_t>(width), static_cast<uint32_t>(height), std::move(samples), spacing, heightRange / 65535.0f, heightOffset);
+    return !heights.empty();
+}
+
+float HeightfieldCollider::getHeight(float x, float z) const {
+    if (heights.empty()) return 0.0f;
+    const float u = std::clamp((x - gridOrigin.x) / spacing.x, 0.0f, static_cast<float>(columns - 1));
+    const float v = std::clamp((z - gridOrigin.y) / spacing.y, 0.0f, static_cast<float>(rows - 1));
+    const int i = std::min(static_cast<int>(u), static_cast<int>(columns) - 2);
+    const int j = std::min(static_cast<int>(v), static_cast<int>(rows) - 2);
+    const float fx = u - i;
+    const float fz = v - j;
+    const float a = sampleHeight(i, j);
+    const float d = sampleHeight(i + 1, j + 1);
+    if (fx >= fz) {
+        const float b = sampleHeight(i + 1, j);
+        return a + (b - a) * fx + (d - b) * fz;
+    }
+    const float c = sampleHeight(i, j + 1);
+    return a + (c - a) * fz + (d - c) * fx;
+}
+
+bool HeightfieldCollider::sampleSurface(const glm::vec3& worldPoint, glm::vec3& surfacePoint, glm::vec3& normal) const {
+    if (heights.empty()) return false;
+    ensureCacheUpdated();
+    const glm::vec3 local = glm::vec3(inverseWorldTr * glm::vec4(worldPoint, 1.0f));
+    const float u = (local.x - gridOrigin.x) / spacing.x;
+    const float v = (local.z - gridOrigin.y) / spacing.y;
+    if (u < 0.0f || v < 0.0f || u > static_cast<float>(columns - 1) || v > static_cast<float>(rows - 1)) return false;
+    const int i = std::min(static_cast<int>(u), static_cast<int>(columns) - 2);
+    const int j = std::min(static_cast<int>(v), static_cast<int>(rows) - 2);
+    surfacePoint = glm::vec3(lastWorldTr * glm::vec4(local.x, getHeight(local.x, local.z), local.z, 1.0f));
+    normal = Collider::normalizeOrZero(glm::transpose(glm::mat3(inverseWorldTr)) * localNormal(i, j, u - i >= v - j ? 0 : 1));
+    return true;
+}
+
+// Cell (i, j) has corners a = (i, j), b = (i + 1, j), c = (i, j + 1) and
+// d = (i + 1, j + 1). Its triangles are (a, d, b) and (a, c, d), both wound
+// to face +Y.
+void HeightfieldCollider::localTriangle(uint32_t triangle, std::array<glm::vec3, 3>& verts) const {
+    const uint32_t cell = triangle / 2;
+    const int i = static_cast<int>(cell % (columns - 1));
+    const int j = static_cast<int>(cell / (columns - 1));
+    verts[0] = localVertex(i, j);
+    if (triangle % 2 == 0) {
+        verts[1] = localVertex(i + 1, j + 1);
+        verts[2] = localVertex(i + 1, j);
+    } else {
+        verts[1] = localVertex(i, j + 1);
+        verts[2] = localVertex(i + 1, j + 1);
+    }
+}
+
+glm::vec3 HeightfieldCollider::localNormal(int i, int j, int half) const {
+    const glm::vec3 a = localVertex(i, j);
+    const glm::vec3 d = localVertex(i + 1, j + 1);
+    if (half == 0) return Collider::normalizeOrZero(glm::cross(d - a, localVertex(i + 1, j) - a));
+    return Collider::normalizeOrZero(glm::cross(localVertex(i, j + 1) - a, d - a));
+}
+
+// A heightfield knows its neighbours without a search, so edge flags are
+// worked out per query rather than stored.
+uint8_t HeightfieldCollider::flatEdges(uint32_t triangle) const {
+    const uint32_t cell = triangle / 2;
+    const int half = static_cast<int>(triangle % 2);
+    const int i = static_cast<int>(cell % (columns - 1));
+    const int j = static_cast<int>(cell / (columns - 1));
+    const int lastI = static_cast<int>(columns) - 2;
+    const int lastJ = static_cast<int>(rows) - 2;
+    const glm::vec3 n = localNormal(i, j, half);
+    auto flat = [&](int ni, int nj, int nhalf, uint8_t edge) -> uint8_t {
+        if (ni < 0 || nj < 0 || ni > lastI || nj > lastJ) return 0;
+        return glm::dot(n, localNormal(ni, nj, nhalf)) > kFlatEdgeCos ? static_cast<uint8_t>(1u << edge) : 0;
+    };
+    if (half == 0) {
+        return static_cast<uint8_t>(flat(i, j, 1, 0) | flat(i + 1, j, 1, 1) | flat(i, j - 1, 1, 2));
+    }
+    return static_cast<uint8_t>(flat(i - 1, j, 0, 0) | flat(i, j + 1, 0, 1) | flat(i, j, 0, 2));
+}
+
+void HeightfieldCollider::cellHeightRange(int i, int j, float& low, float& high) const {
+    const size_t row = static_cast<size_t>(j) * columns + static_cast<size_t>(i);
+    const auto [lo, hi] = std::minmax({heights[row], heights[row + 1], heights[row + columns], heights[row + columns + 1]});
+    low = lo * heightScale + heightOffset;
+    high = hi * heightScale + heightOffset;
+    if (low > high) std::swap(low, high);
+}
+
+bool HeightfieldCollider::cellRange(const ColliderAABB& localBox, glm::ivec2& first, glm::ivec2& last) const {
+    const ColliderAABB bounds = localBounds();
+    if (!DynamicAABBTree::overlaps(bounds, localBox)) return false;
+    const int lastI = static_cast<int>(columns) - 2;
+    const int lastJ = static_cast<int>(rows) - 2;
+    first.x = std::clamp(static_cast<int>(std::floor((localBox.min.x - gridOrigin.x) / spacing.x)), 0, lastI);
+    first.y = std::clamp(static_cast<int>(std::floor((localBox.min.z - gridOrigin.y) / spacing.y)), 0, lastJ);
+    last.x = std::clamp(static_cast<int>(std::floor((localBox.max.x - gridOrigin.x) / spacing.x)), 0, lastI);
+    last.y = std::clamp(static_cast<int>(std::floor((localBox.max.z - gridOrigin.y) / spacing.y)), 0, lastJ);
+    return true;
+}
+
+ColliderAABB HeightfieldCollider::localBounds() const {
+    float low = minSample * heightScale + heightOffset;
+    float high = maxSample * heightScale + heightOffset;
+    if (low > high) std::swap(low, high);
+    return {glm::vec3(gridOrigin.x, low, gridOrigin.y), glm::vec3(-gridOrigin.x, high, -gridOrigin.y)};
+}
+
+void HeightfieldCollider::ensureCacheUpdated() const {
+    if (cacheValid && isBaked()) return;
+    glm::mat4 tr = const_cast<HeightfieldCollider*>(this)->getWorldTransform();
+    if (cacheValid && tr == lastWorldTr) return;
+    inverseWorldTr = glm::inverse(tr);
+    lastWorldTr = tr;
+    cacheValid = true;
+}
+
+ColliderAABB HeightfieldCollider::toLocal(const ColliderAABB& worldBox) const {
+    auto corners = Collider::cornersFromAABB(worldBox);
+    for (auto& c : corners) {
+        c = glm::vec3(inverseWorldTr * glm::vec4(c, 1.0f));
+    }
+    return Collider::aabbFromCorners(corners);
+}
+
+ColliderAABB HeightfieldCollider::computeWorldAABB() const {
+    glm::mat4 tr = const_cast<HeightfieldCollider*>(this)->getWorldTransform();
+    if (heights.empty()) {
+        glm::vec3 p = glm::vec3(tr[3]);
+        return {p - glm::vec3(0.001f), p + glm::vec3(0.001f)};
+    }
+    auto corners = Collider::cornersFromAABB(localBounds());
+    for (auto& c : corners) {
+        c = glm::vec3(tr * glm::vec4(c, 1.0f));
+    }
+    return Collider::aabbFromCorners(corners);
+}
+
+ConvexShape HeightfieldCollider::computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
+    (void)deltaRot;
+    ColliderAABB box = computeWorldAABB();
+    ConvexShape shape;
+    shape.kind = ConvexShape::Kind::Box;
+    shape.center = 0.5f * (box.min + box.max) + deltaPos;
+    shape.halfExtents = 0.5f * (box.max - box.min);
+    return shape;
+}
+
+void HeightfieldCollider::getWorldTriangle(uint32_t triangle, glm::vec3& a, glm::vec3& b, glm::vec3& c) const {
+    ensureCacheUpdated();
+    std::array<glm::vec3, 3> verts;
+    localTriangle(triangle, verts);
+    a = glm::vec3(lastWorldTr * glm::vec4(verts[0], 1.0f));
+    b = glm::vec3(lastWorldTr * glm::vec4(verts[1], 1.0f));
+    c = glm::vec3(lastWorldTr * glm::vec4(verts[2], 1.0f));
+}
+
+bool HeightfieldCollider::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const {
+    constexpr float kParallelEps = 1e-12f;
+    constexpr float kHeightSlack = 1e-4f;
+    if (heights.empty()) return false;
+    ensureCacheUpdated();
+    // The local ray keeps the world parameterisation, so cell crossings and
+    // triangle hits (tested in world space) compare directly.
+    const glm::vec3 o = glm::vec3(inverseWorldTr * glm::vec4(origin, 1.0f));
+    const glm::vec3 d = glm::vec3(inverseWorldTr * glm::vec4(direction, 0.0f));
+    const ColliderAABB bounds = localBounds();
+    float tEnter = 0.0f;
+    float tExit = maxDistance;
+    for (int k = 0; k < 3; ++k) {
+        if (std::abs(d[k]) < kParallelEps) {
+            if (o[k] < bounds.min[k] || o[k] > bounds.max[k]) return false;
+            continue;
+        }
+        float t0 = (bounds.min[k] - o[k]) / d[k];
+        float t1 = (bounds.max[k] - o[k]) / d[k];
+        if (t0 > t1) std::swap(t0, t1);
+        tEnter = std::max(tEnter, t0);
+        tExit = std::min(tExit, t1);
+        if (tEnter > tExit) return false;
+    }
+
+    // Walk the cells under the ray in order; the first one hit holds the closest hit.
+    const glm::vec3 start = o + d * tEnter;
+    int i = std::clamp(static_cast<int>(std::floor((start.x - gridOrigin.x) / spacing.x)), 0, static_cast<int>(columns) - 2);
+    int j = std::clamp(static_cast<int>(std::floor((start.z - gridOrigin.y) / spacing.y)), 0, static_cast<int>(rows) - 2);
+    const int stepI = d.x > 0.0f ? 1 : -1;
+    const int stepJ = d.z > 0.0f ? 1 : -1;
+    const bool movesI = std::abs(d.x) >= kParallelEps;
+    const bool movesJ = std::abs(d.z) >= kParallelEps;
+    const float deltaI = movesI ? spacing.x / std::abs(d.x) : FLT_MAX;
+    const float deltaJ = movesJ ? spacing.y / std::abs(d.z) : FLT_MAX;
+    float nextI = movesI ? (gridOrigin.x + (i + (stepI > 0 ? 1 : 0)) * spacing.x - o.x) / d.x : FLT_MAX;
+    float nextJ = movesJ ? (gridOrigin.y + (j + (stepJ > 0 ? 1 : 0)) * spacing.y - o.z) / d.z : FLT_MAX;
+    float cellEnter = tEnter;
+    while (true) {
+        const float cellExit = std::min({nextI, nextJ, tExit});
+        float low, high;
+        cellHeightRange(i, j, low, high);
+        const float y0 = o.y + d.y * cellEnter;
+        const float y1 = o.y + d.y * cellExit;
+        if (std::max(y0, y1) >= low - kHeightSlack && std::min(y0, y1) <= high + kHeightSlack) {
+            const uint32_t cell = static_cast<uint32_t>(j) * (columns - 1) + static_cast<uint32_t>(i);
+            float best = maxDistance;
+            bool found = false;
+            for (uint32_t triangle = cell * 2; triangle < cell * 2 + 2; ++triangle) {
+                glm::vec3 a, b, c;
+                getWorldTriangle(triangle, a, b, c);
+                float t = 0.0f;
+                glm::vec3 normal(0.0f);
+                if (Collider::rayTriangle(origin, direction, best, a, b, c, t, normal)) {
+                    best = t;
+                    hit = {const_cast<HeightfieldCollider*>(this), origin + direction * t, normal, t};
+                    found = true;
+                }
+            }
+            if (found) return true;
+        }
+        if (cellExit >= tExit) return false;
+        if (nextI < nextJ) {
+            i += stepI;
+            cellEnter = nextI;
+            nextI += deltaI;
+        } else {
+            j += stepJ;
+            cellEnter = nextJ;
+            nextJ += deltaJ;
+        }
+        if (i < 0 || j < 0 || i > static_cast<int>(columns) - 2 || j > static_cast<int>(rows) - 2) return false;
+    }
+}
+
+bool HeightfieldCollider::shapeCast(const ConvexShape& shape, const glm::vec3& direction, float maxDistance, RaycastHit& hit, glm::vec3* /*separatingAxis*/) const {
+    const ColliderAABB start = Collider::shapeBounds(shape);
+    const glm::vec3 travel = direction * maxDistance;
+    const ColliderAABB swept{glm::min(start.min, start.min + travel), glm::max(start.max, start.max + travel)};
+    float best = maxDistance;
+    bool found = false;
+    std::array<glm::vec3, 3> verts;
+    queryTriangles(swept, [&](uint32_t triangle) {
+        getWorldTriangle(triangle, verts[0], verts[1], verts[2]);
+        ConvexShape tri;
+        tri.kind = ConvexShape::Kind::Points;
+        tri.points = verts.data();
+        tri.pointCount = verts.size();
+        tri.center = (verts[0] + verts[1] + verts[2]) / 3.0f;
+        ShapeCastResult result;
+        if (gjkCast(shape, direction, best, tri, result) && (!found || result.distance < best)) {
+            best = result.distance;
+            hit = {const_cast<HeightfieldCollider*>(this), result.point, result.normal, result.distance};
+            found = true;
+        }
+    });
+    return found;
+}
+
+bool HeightfieldCollider::collideShape(const ConvexShape& shape, const ColliderAABB& shapeBounds, CollisionMTV& out, std::vector<MeshContact>* contacts) const {
+    std::vector<MeshContact> localContacts;
+    std::vector<MeshContact>& found = contacts ? *contacts : localContacts;
+    const size_t firstContact = found.size();
+
+    queryTriangles(shapeBounds, [&](uint32_t tri) {
+        std::array<glm::vec3, 3> verts;
+        getWorldTriangle(tri, verts[0], verts[1], verts[2]);
+        ColliderAABB triBounds{glm::min(verts[0], glm::min(verts[1], verts[2])), glm::max(verts[0], glm::max(verts[1], verts[2]))};
+        if (!DynamicAABBTree::overlaps(triBounds, shapeBounds)) return;
+        MeshContact contact;
+        if (!Collider::triangleContact(shape, verts, flatEdges(tri), true, contact)) return;
+        contact.triangle = tri;
+        found.push_back(contact);
+    });
+    return Collider::combineContacts(found, firstContact, out);
+}
+
+bool HeightfieldCollider::intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
+    (void)deltaRot;
+    if (other.isConcave()) return false;
+    // Moving the heightfield by deltaPos is the same as moving the other collider by -deltaPos.
+    ColliderAABB otherBounds = other.getWorldAABB();
+    otherBounds.min -= deltaPos;
+    otherBounds.max -= deltaPos;
+    CollisionMTV res{};
+    if (!collideShape(other.getSupportShape(-deltaPos), otherBounds, res)) return false;
+    out.mtv = -res.mtv;
+    out.normal = -res.normal;
+    out.penetration = res.penetration;
+    return true;
+}
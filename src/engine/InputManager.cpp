@@ -1,4 +1,6 @@
 #include <InputManager.h>
+#include <PhysicsRecorder.h>
+#include <Renderer.h>
 #include <glfw/include/GLFW/glfw3.h>
 #include <vector>
 #include <functional>
@@ -59,6 +61,7 @@ void InputManager::processInput(GLFWwindow* window) {
         }
         mouseButtonStates[button] = state;
     }
+    PhysicsRecorder::getInstance()->recordInput(events, Renderer::getInstance()->isCursorLocked());
     dispatch(events);
 }
 
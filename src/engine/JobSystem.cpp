@@ -0,0 +1,286 @@
+#include <JobSystem.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+
+namespace {
+    // Which deque the calling thread owns: 0 on the main thread, 1.. on pool
+    // threads, and none on threads the job system did not start.
+    constexpr size_t kNoQueue = SIZE_MAX;
+    thread_local size_t currentQueue = kNoQueue;
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+struct JobSystem::Job {
+    const char* name = "";
+    std::function<void()> task;
+    Affinity affinity = Affinity::Any;
+    // Unfinished dependencies, plus one held by schedule while it links them.
+    std::atomic<int> pending{1};
+    std::atomic<bool> done{false};
+    std::mutex mutex;
+    std::vector<JobHandle> continuations;
+};
+
+JobSystem* JobSystem::getInstance() {
+    static JobSystem instance;
+    return &instance;
+}
+
+JobSystem::JobSystem() {
+    currentQueue = 0;
+    queues.push_back(std::make_unique<Queue>());
+    const unsigned hardware = std::thread::hardware_concurrency();
+    startWorkers(hardware > 1 ? hardware - 1 : 0);
+}
+
+JobSystem::~JobSystem() {
+    stopWorkers();
+}
+
+void JobSystem::setWorkerCount(size_t count) {
+    stopWorkers();
+    startWorkers(count);
+}
+
+void JobSystem::startWorkers(size_t count) {
+    // Queues outlive the workers that owned them, so their timings are kept.
+    while (queues.size() < count + 1) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    running = true;
+    for (size_t i = 1; i <= count; ++i) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+void JobSystem::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void JobSystem::workerLoop(size_t index) {
+    currentQueue = index;
+    while (running) {
+        if (runOne()) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&] { return !running || queued.load() > 0; });
+    }
+}
+
+JobSystem::JobHandle JobSystem::schedule(const char* name, std::function<void()> task, std::initializer_list<JobHandle> dependencies, Affinity affinity) {
+    JobHandle job = std::make_shared<Job>();
+    job->name = name;
+    job->task = std::move(task);
+    job->affinity = affinity;
+    for (const JobHandle& dependency : dependencies) {
+        if (!dependency) continue;
+        std::lock_guard<std::mutex> lock(dependency->mutex);
+        if (!dependency->done) {
+            dependency->continuations.push_back(job);
+            ++job->pending;
+        }
+    }
+    if (--job->pending == 0) {
+        enqueue(job);
+    }
+    return job;
+}
+
+bool JobSystem::isDone(const JobHandle& job) const {
+    return !job || job->done.load();
+}
+
+void JobSystem::wait(const JobHandle& job) {
+    while (!isDone(job)) {
+        if (!runOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(const char* name, size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (count + grain - 1) / grain;
+    std::atomic<size_t> next{0};
+    auto drain = [&] {
+        for (size_t chunk; (chunk = next.fetch_add(1)) < chunks;) {
+            const size_t begin = chunk * grain;
+            body(begin, std::min(count, begin + grain));
+        }
+    };
+
+    // Each helper drains chunks until none are left, so a helper that
+    // starts late finds nothing to do and returns at once.
+    const size_t helpers = std::min(workers.size(), chunks - 1);
+    std::vector<JobHandle> spawned;
+    spawned.reserve(helpers);
+    for (size_t i = 0; i < helpers; ++i) {
+        spawned.push_back(schedule(name, drain));
+    }
+    const auto start = std::chrono::steady_clock::now();
+    drain();
+    record(name, millisecondsSince(start));
+    for (const JobHandle& job : spawned) {
+        wait(job);
+    }
+}
+
+void JobSystem::runMainThreadJobs() {
+    for (;;) {
+        JobHandle job;
+        {
+            std::lock_guard<std::mutex> lock(mainMutex);
+            if (mainJobs.empty()) return;
+            job = std::move(mainJobs.front());
+            mainJobs.pop_front();
+        }
+        run(job);
+    }
+}
+
+void JobSystem::enqueue(const JobHandle& job) {
+    if (job->affinity == Affinity::MainThread) {
+        std::lock_guard<std::mutex> lock(mainMutex);
+        mainJobs.push_back(job);
+        return;
+    }
+    Queue& queue = *queues[currentQueue < queues.size() ? currentQueue : 0];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+    ++queued;
+    if (!workers.empty()) {
+        // Taking the lock orders this against a worker checking queued before it sleeps.
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wake.notify_one();
+    }
+}
+
+JobSystem::JobHandle JobSystem::takeJob(size_t index) {
+    const size_t count = queues.size();
+    if (index < count) {
+        Queue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            JobHandle job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            --queued;
+            return job;
+        }
+    }
+    const size_t first = index < count ? index : 0;
+    for (size_t offset = 1; offset <= count; ++offset) {
+        const size_t victim = (first + offset) % count;
+        if (victim == index) continue;
+        Queue& other = *queues[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.jobs.empty()) {
+            JobHandle job = std::move(other.jobs.front());
+            other.jobs.pop_front();
+            --queued;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+bool JobSystem::runOne() {
+    if (currentQueue == 0) {
+        JobHandle job;
+        {
+            std::lock_guard<std::mutex> lock(mainMutex);
+            if (!mainJobs.empty()) {
+                job = std::move(mainJobs.front());
+                mainJobs.pop_front();
+            }
+        }
+        if (job) {
+            run(job);
+            return true;
+        }
+    }
+    if (JobHandle job = takeJob(currentQueue)) {
+        run(job);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::run(const JobHandle& job) {
+    const auto start = std::chrono::steady_clock::now();
+    job->task();
+    record(job->name, millisecondsSince(start));
+    finish(job);
+}
+
+void JobSystem::finish(const JobHandle& job) {
+    std::vector<JobHandle> ready;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->task = nullptr;
+        job->done = true;
+        ready.swap(job->continuations);
+    }
+    for (const JobHandle& continuation : ready) {
+        if (--continuation->pending == 0) {
+            enqueue(continuation);
+        }
+    }
+}
+
+void JobSystem::record(const char* name, double ms) {
+    Queue& queue = *queues[currentQueue < queues.size() ? currentQueue : 0];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    Timing& timing = queue.timings[name];
+    ++timing.runs;
+    timing.totalMs += ms;
+    timing.maxMs = std::max(timing.maxMs, ms);
+}
+
+std::vector<JobSystem::JobStats> JobSystem::getStats() const {
+    // The same literal can have a different address in each translation unit.
+    std::map<std::string, JobStats> byName;
+    for (const auto& queue : queues) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        for (const auto& [name, timing] : queue->timings) {
+            if (timing.runs == 0) continue;
+            JobStats& stats = byName[name];
+            stats.name = name;
+            stats.runs += timing.runs;
+            stats.totalMs += timing.totalMs;
+            stats.maxMs = std::max(stats.maxMs, timing.maxMs);
+        }
+    }
+    std::vector<JobStats> stats;
+    stats.reserve(byName.size());
+    for (auto& [name, entry] : byName) {
+        stats.push_back(std::move(entry));
+    }
+    std::sort(stats.begin(), stats.end(), [](const JobStats& a, const JobStats& b) {
+        return a.totalMs > b.totalMs;
+    });
+    return stats;
+}
+
+void JobSystem::resetStats() {
+    for (const auto& queue : queues) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        for (auto& [name, timing] : queue->timings) {
+            timing = Timing{};
+        }
+    }
+}
@@ -0,0 +1,311 @@
+#include <MeshCollider.h>
+#include <ClosestPoints.h>
+#include <CollisionWorld.h>
+#include <GJK.h>
+
+#include <algorithm>
+#include <iostream>
+
+void MeshCollider::setVertices(const std::vector<float>& positions, const std::vector<uint32_t>& indices) {
+    setVerticesInterleaved(positions, 3, 0, indices);
+}
+
+void MeshCollider::setVerticesInterleaved(const std::vector<float>& interleaved, size_t strideFloats, size_t positionOffsetFloats, const std::vector<uint32_t>& indices) {
+    localVertices.clear();
+    triangles.clear();
+    if (strideFloats < positionOffsetFloats + 3) {
+        std::cerr << "MeshCollider::setVerticesInterleaved - invalid stride/offset (" << strideFloats << ", " << positionOffsetFloats << ")\n";
+        return;
+    }
+    const size_t vcount = interleaved.size() / strideFloats;
+    localVertices.reserve(vcount);
+    for (size_t i = 0; i < vcount; ++i) {
+        size_t base = i * strideFloats + positionOffsetFloats;
+        localVertices.emplace_back(interleaved[base + 0], interleaved[base + 1], interleaved[base + 2]);
+    }
+    const size_t tcount = indices.size() / 3;
+    triangles.reserve(tcount);
+    for (size_t t = 0; t < tcount; ++t) {
+        uint32_t i0 = indices[t*3 + 0];
+        uint32_t i1 = indices[t*3 + 1];
+        uint32_t i2 = indices[t*3 + 2];
+        if (i0 < vcount && i1 < vcount && i2 < vcount) {
+            triangles.emplace_back(i0, i1, i2);
+        }
+    }
+    buildBVH();
+    buildEdgeFlags();
+    cacheValid = false;
+    CollisionWorld::getInstance()->updateCollider(this);
+}
+
+void MeshCollider::buildBVH() {
+    nodes.clear();
+    if (triangles.empty()) return;
+    std::vector<glm::vec3> centroids(triangles.size());
+    std::vector<uint32_t> order(triangles.size());
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        const glm::uvec3& t = triangles[i];
+        centroids[i] = (localVertices[t.x] + localVertices[t.y] + localVertices[t.z]) / 3.0f;
+        order[i] = static_cast<uint32_t>(i);
+    }
+    nodes.reserve(2 * (triangles.size() / kMaxLeafTriangles + 1));
+    buildNode(centroids, order, 0, static_cast<uint32_t>(triangles.size()), 0);
+
+    // Store triangles in leaf order so every leaf owns a contiguous range.
+    std::vector<glm::uvec3> sorted(triangles.size());
+    for (size_t i = 0; i < order.size(); ++i) sorted[i] = triangles[order[i]];
+    triangles.swap(sorted);
+}
+
+// Median split along the longest axis of the centroid bounds.
+uint32_t MeshCollider::buildNode(const std::vector<glm::vec3>& centroids, std::vector<uint32_t>& order, uint32_t begin, uint32_t end, uint32_t depth) {
+    const uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+
+    ColliderAABB bounds{glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max())};
+    ColliderAABB centroidBounds = bounds;
+    for (uint32_t i = begin; i < end; ++i) {
+        const glm::uvec3& t = triangles[order[i]];
+        for (int k = 0; k < 3; ++k) {
+            const glm::vec3& v = localVertices[t[k]];
+            bounds.min = glm::min(bounds.min, v);
+            bounds.max = glm::max(bounds.max, v);
+        }
+        centroidBounds.min = glm::min(centroidBounds.min, centroids[order[i]]);
+        centroidBounds.max = glm::max(centroidBounds.max, centroids[order[i]]);
+    }
+    nodes[nodeIndex].bounds = bounds;
+
+    const uint32_t count = end - begin;
+    if (count <= kMaxLeafTriangles || depth + 2 >= kMaxBVHDepth) {
+        nodes[nodeIndex].start = begin;
+        nodes[nodeIndex].count = count;
+        return nodeIndex;
+    }
+
+    glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+    int axis = 0;
+    if (extent.y > extent[axis]) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+
+    const uint32_t mid = begin + count / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&](uint32_t a, uint32_t b) {
+        return centroids[a][axis] < centroids[b][axis];
+    });
+
+    buildNode(centroids, order, begin, mid, depth + 1);
+    uint32_t right = buildNode(centroids, order, mid, end, depth + 1);
+    nodes[nodeIndex].start = right;
+    nodes[nodeIndex].count = 0;
+    return nodeIndex;
+}
+
+// Welds vertices by position (exported meshes split them at UV seams) and flags
+// edges whose neighbour is nearly coplanar. Contacts on those edges are
+// resolved along the face normal so shapes slide across them without snagging.
+void MeshCollider::buildEdgeFlags() {
+    flatEdges.assign(triangles.size(), 0);
+    if (triangles.empty()) return;
+
+    constexpr float kWeldGrid = 1e-4f;
+    std::vector<glm::ivec3> quantized(localVertices.size());
+    std::vector<uint32_t> byPosition(localVertices.size());
+    for (size_t i = 0; i < localVertices.size(); ++i) {
+        quantized[i] = glm::ivec3(glm::round(localVertices[i] / kWeldGrid));
+        byPosition[i] = static_cast<uint32_t>(i);
+    }
+    auto lessPos = [&](uint32_t a, uint32_t b) {
+        const glm::ivec3& qa = quantized[a];
+        const glm::ivec3& qb = quantized[b];
+        if (qa.x != qb.x) return qa.x < qb.x;
+        if (qa.y != qb.y) return qa.y < qb.y;
+        return qa.z < qb.z;
+    };
+    std::sort(byPosition.begin(), byPosition.end(), lessPos);
+    std::vector<uint32_t> welded(localVertices.size());
+    for (size_t i = 0; i < byPosition.size(); ++i) {
+        bool same = i > 0 && !lessPos(byPosition[i - 1], byPosition[i]);
+        welded[byPosition[i]] = same ? welded[byPosition[i - 1]] : byPosition[i];
+    }
+
+    struct EdgeRef {
+        uint32_t a, b;
+        uint32_t triangle;
+        uint8_t edge;
+    };
+    std::vector<EdgeRef> edges;
+    edges.reserve(triangles.size() * 3);
+    std::vector<glm::vec3> normals(triangles.size());
+    for (uint32_t t = 0; t < triangles.size(); ++t) {
+        const glm::uvec3& tri = triangles[t];
+        normals[t] = Collider::normalizeOrZero(glm::cross(localVertices[tri.y] - localVertices[tri.x], localVertices[tri.z] - localVertices[tri.x]));
+        for (uint8_t e = 0; e < 3; ++e) {
+            uint32_t a = welded[tri[e]];
+            uint32_t b = welded[tri[(e + 1) % 3]];
+            edges.push_back({std::min(a, b), std::max(a, b), t, e});
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](const EdgeRef& l, const EdgeRef& r) {
+        return l.a != r.a ? l.a < r.a : l.b < r.b;
+    });
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j].a == edges[i].a && edges[j].b == edges[i].b) ++j;
+        // Only manifold edges (exactly two triangles) can be internal.
+        if (j - i == 2) {
+            const EdgeRef& e0 = edges[i];
+            const EdgeRef& e1 = edges[i + 1];
+            if (std::abs(glm::dot(normals[e0.triangle], normals[e1.triangle])) > kFlatEdgeCos) {
+                flatEdges[e0.triangle] |= static_cast<uint8_t>(1u << e0.edge);
+                flatEdges[e1.triangle] |= static_cast<uint8_t>(1u << e1.edge);
+            }
+        }
+        i = j;
+    }
+}
+
+void MeshCollider::ensureCacheUpdated() const {
+    if (cacheValid && isBaked()) return;
+    glm::mat4 tr = const_cast<MeshCollider*>(this)->getWorldTransform();
+    if (cacheValid && tr == lastWorldTr) return;
+    worldVerts.resize(localVertices.size());
+    for (size_t i = 0; i < localVertices.size(); ++i) {
+        worldVerts[i] = glm::vec3(tr * glm::vec4(localVertices[i], 1.0f));
+    }
+    inverseWorldTr = glm::inverse(tr);
+    lastWorldTr = tr;
+    cacheValid = true;
+}
+
+ColliderAABB MeshCollider::toLocal(const ColliderAABB& worldBox) const {
+    auto corners = Collider::cornersFromAABB(worldBox);
+    for (auto& c : corners) {
+        c = glm::vec3(inverseWorldTr * glm::vec4(c, 1.0f));
+    }
+    return Collider::aabbFromCorners(corners);
+}
+
+ColliderAABB MeshCollider::computeWorldAABB() const {
+    glm::mat4 tr = const_cast<MeshCollider*>(this)->getWorldTransform();
+    if (nodes.empty()) {
+        glm::vec3 p = glm::vec3(tr[3]);
+        return {p - glm::vec3(0.001f), p + glm::vec3(0.001f)};
+    }
+    auto corners = Collider::cornersFromAABB(nodes[0].bounds);
+    for (auto& c : corners) {
+        c = glm::vec3(tr * glm::vec4(c, 1.0f));
+    }
+    return Collider::aabbFromCorners(corners);
+}
+
+ConvexShape MeshCollider::computeSupportShape(const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
+    (void)deltaRot;
+    ColliderAABB box = computeWorldAABB();
+    ConvexShape shape;
+    shape.kind = ConvexShape::Kind::Box;
+    shape.center = 0.5f * (box.min + box.max) + deltaPos;
+    shape.halfExtents = 0.5f * (box.max - box.min);
+    return shape;
+}
+
+void MeshCollider::getWorldTriangle(uint32_t triangle, glm::vec3& a, glm::vec3& b, glm::vec3& c) const {
+    ensureCacheUpdated();
+    const glm::uvec3& t = triangles[triangle];
+    a = worldVerts[t.x];
+    b = worldVerts[t.y];
+    c = worldVerts[t.z];
+}
+
+bool MeshCollider::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const {
+    if (nodes.empty()) return false;
+    ensureCacheUpdated();
+    // The local ray keeps the world parameterisation, so node entry distances
+    // and triangle hits (tested in world space) compare directly.
+    const glm::vec3 localOrigin = glm::vec3(inverseWorldTr * glm::vec4(origin, 1.0f));
+    const glm::vec3 invDirection = DynamicAABBTree::inverseDirection(glm::vec3(inverseWorldTr * glm::vec4(direction, 0.0f)));
+    float best = maxDistance;
+    bool found = false;
+    std::array<uint32_t, kMaxBVHDepth> stack;
+    size_t count = 0;
+    stack[count++] = 0;
+    while (count > 0) {
+        const uint32_t nodeIndex = stack[--count];
+        const BVHNode& node = nodes[nodeIndex];
+        float tEnter = 0.0f;
+        if (!DynamicAABBTree::rayIntersects(node.bounds, localOrigin, invDirection, best, tEnter)) continue;
+        if (node.count == 0) {
+            stack[count++] = node.start;
+            stack[count++] = nodeIndex + 1;
+            continue;
+        }
+        for (uint32_t i = node.start; i < node.start + node.count; ++i) {
+            const glm::uvec3& tri = triangles[i];
+            float t = 0.0f;
+            glm::vec3 normal(0.0f);
+            if (Collider::rayTriangle(origin, direction, best, worldVerts[tri.x], worldVerts[tri.y], worldVerts[tri.z], t, normal)) {
+                best = t;
+                hit = {const_cast<MeshCollider*>(this), origin + direction * t, normal, t};
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+bool MeshCollider::shapeCast(const ConvexShape& shape, const glm::vec3& direction, float maxDistance, RaycastHit& hit, glm::vec3* /*separatingAxis*/) const {
+    const ColliderAABB start = Collider::shapeBounds(shape);
+    const glm::vec3 travel = direction * maxDistance;
+    const ColliderAABB swept{glm::min(start.min, start.min + travel), glm::max(start.max, start.max + travel)};
+    float best = maxDistance;
+    bool found = false;
+    std::array<glm::vec3, 3> verts;
+    queryTriangles(swept, [&](uint32_t triangle) {
+        getWorldTriangle(triangle, verts[0], verts[1], verts[2]);
+        ConvexShape tri;
+        tri.kind = ConvexShape::Kind::Points;
+        tri.points = verts.data();
+        tri.pointCount = verts.size();
+        tri.center = (verts[0] + verts[1] + verts[2]) / 3.0f;
+        ShapeCastResult result;
+        if (gjkCast(shape, direction, best, tri, result) && (!found || result.distance < best)) {
+            best = result.distance;
+            hit = {const_cast<MeshCollider*>(this), result.point, result.normal, result.distance};
+            found = true;
+        }
+    });
+    return found;
+}
+
+bool MeshCollider::collideShape(const ConvexShape& shape, const ColliderAABB& shapeBounds, CollisionMTV& out, std::vector<MeshContact>* contacts) const {
+    std::vector<MeshContact> localContacts;
+    std::vector<MeshContact>& found = contacts ? *contacts : localContacts;
+    const size_t firstContact = found.size();
+
+    queryTriangles(shapeBounds, [&](uint32_t tri) {
+        std::array<glm::vec3, 3> verts;
+        getWorldTriangle(tri, verts[0], verts[1], verts[2]);
+        ColliderAABB triBounds{glm::min(verts[0], glm::min(verts[1], verts[2])), glm::max(verts[0], glm::max(verts[1], verts[2]))};
+        if (!DynamicAABBTree::overlaps(triBounds, shapeBounds)) return;
+        MeshContact contact;
+        if (!Collider::triangleContact(shape, verts, flatEdges[tri], false, contact)) return;
+        contact.triangle = tri;
+        found.push_back(contact);
+    });
+    return Collider::combineContacts(found, firstContact, out);
+}
+
+bool MeshCollider::intersectsMTV(const Collider& other, CollisionMTV& out, const glm::vec3& deltaPos, const glm::vec3& deltaRot) const {
+    (void)deltaRot;
+    if (other.isConcave()) return false;
+    // Moving the mesh by deltaPos is the same as moving the other collider by -deltaPos.
+    ColliderAABB otherBounds = other.getWorldAABB();
+    otherBounds.min -= deltaPos;
+    otherBounds.max -= deltaPos;
+    CollisionMTV res{};
+    if (!collideShape(other.getSupportShape(-deltaPos), otherBounds, res)) return false;
+    out.mtv = -res.mtv;
+    out.normal = -res.normal;
+    out.penetration = res.penetration;
+    return true;
+}
@@ -17,6 +17,7 @@ struct GeoSurface {
 
 void Model::loadFromFile(const std::string& path) {
     const std::filesystem::path modelPath(path);
+    sourcePath = path;
     auto dataResult = fastgltf::GltfDataBuffer::FromPath(modelPath);
     if (!dataResult) {
         std::cerr << "Failed to open glTF file: " << path << " Error: "
@@ -43,7 +44,7 @@ void Model::loadFromFile(const std::string& path) {
         std::cerr << "No primitives found in mesh: " << mesh.name << std::endl;
         return;
     }
-    constexpr std::size_t floatsPerVertex = 11; // position (3) + normal (3) + uv (2) + tangent (3)
+    constexpr std::size_t floatsPerVertex = kFloatsPerVertex;
     for (const auto& primitive : mesh.primitives) {
         if (!primitive.indicesAccessor.has_value()) {
             std::cerr << "Primitive missing index accessor in glTF file: " << path << std::endl;
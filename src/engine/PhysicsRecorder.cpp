@@ -0,0 +1,337 @@
+#include <PhysicsRecorder.h>
+#include <Entity.h>
+#include <EntityManager.h>
+#include <InputManager.h>
+#include <PhysicsWorld.h>
+#include <Renderer.h>
+#include <SceneManager.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+namespace {
+    constexpr uint32_t kRecordingMagic = 0x43524650u;   // "PFRC"
+    constexpr uint32_t kRecordingVersion = 1;
+
+    struct EntityState {
+        std::string name;
+        glm::vec3 position{0.0f};
+        glm::vec3 rotation{0.0f};
+        glm::vec3 scale{1.0f};
+    };
+
+    struct Frame {
+        float delta = 0.0f;
+        size_t firstBatch = 0;
+        size_t batchCount = 0;
+        uint64_t hash = 0;
+    };
+
+    struct Recording {
+        int32_t sceneId = 0;
+        uint32_t seed = 0;
+        float timestep = PhysicsWorld::kDefaultTimestep;
+        int32_t maxStepsPerFrame = PhysicsWorld::kDefaultMaxStepsPerFrame;
+        float accumulator = 0.0f;
+        std::vector<EntityState> entities;
+        std::vector<std::pair<bool, std::vector<InputEvent>>> batches;
+        std::vector<Frame> frames;
+    };
+
+    // Every entity, roots in name order and each followed by its children.
+    template <typename Visit>
+    void forEachEntity(Visit&& visit) {
+        auto traverse = [&](auto&& self, Entity* entity) -> void {
+            visit(entity);
+            for (Entity* child : entity->getChildren()) {
+                self(self, child);
+            }
+        };
+        for (auto& [name, entity] : EntityManager::getInstance()->getAllEntities()) {
+            if (entity->getParent() == nullptr) {
+                traverse(traverse, entity);
+            }
+        }
+    }
+
+    void hashBytes(uint64_t& hash, const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        }
+    }
+
+    uint64_t hashEntityState() {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        forEachEntity([&](Entity* entity) {
+            const glm::vec3 values[3] = {entity->getPosition(), entity->getRotation(), entity->getScale()};
+            hashBytes(hash, values, sizeof(values));
+        });
+        return hash;
+    }
+
+    template <typename T>
+    bool readValue(std::ifstream& in, T& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    template <typename T>
+    void writeValue(std::ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeEvent(std::ofstream& out, const InputEvent& event) {
+        writeValue(out, static_cast<uint8_t>(event.type));
+        switch (event.type) {
+            case InputEvent::Type::KeyPress:
+            case InputEvent::Type::KeyRelease:
+                writeValue(out, event.keyEvent);
+                break;
+            case InputEvent::Type::MouseMove:
+                writeValue(out, event.mouseMoveEvent);
+                break;
+            case InputEvent::Type::MouseButtonPress:
+            case InputEvent::Type::MouseButtonRelease:
+                writeValue(out, event.mouseButtonEvent);
+                break;
+            case InputEvent::Type::Scroll:
+                writeValue(out, event.scrollEvent);
+                break;
+        }
+    }
+
+    bool readEvent(std::ifstream& in, InputEvent& event) {
+        uint8_t type = 0;
+        if (!readValue(in, type) || type > static_cast<uint8_t>(InputEvent::Type::Scroll)) return false;
+        event.type = static_cast<InputEvent::Type>(type);
+        switch (event.type) {
+            case InputEvent::Type::KeyPress:
+            case InputEvent::Type::KeyRelease:
+                return readValue(in, event.keyEvent);
+            case InputEvent::Type::MouseMove:
+                return readValue(in, event.mouseMoveEvent);
+            case InputEvent::Type::MouseButtonPress:
+            case InputEvent::Type::MouseButtonRelease:
+                return readValue(in, event.mouseButtonEvent);
+            case InputEvent::Type::Scroll:
+                return readValue(in, event.scrollEvent);
+        }
+        return false;
+    }
+
+    // Reads the header and every complete frame; a frame cut short by a
+    // crash ends the recording rather than failing it.
+    bool readRecording(const std::string& path, Recording& recording) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        uint32_t magic = 0, version = 0, entityCount = 0;
+        if (!readValue(in, magic) || !readValue(in, version)) return false;
+        if (magic != kRecordingMagic || version != kRecordingVersion) return false;
+        if (!readValue(in, recording.sceneId) || !readValue(in, recording.seed) || !readValue(in, recording.timestep) ||
+            !readValue(in, recording.maxStepsPerFrame) || !readValue(in, recording.accumulator) || !readValue(in, entityCount)) {
+            return false;
+        }
+        recording.entities.assign(entityCount, {});
+        for (EntityState& state : recording.entities) {
+            uint16_t nameLength = 0;
+            if (!readValue(in, nameLength)) return false;
+            state.name.resize(nameLength);
+            if (!in.read(state.name.data(), nameLength) || !readValue(in, state.position) || !readValue(in, state.rotation) || !readValue(in, state.scale)) {
+                return false;
+            }
+        }
+        while (true) {
+            Frame frame;
+            uint8_t batchCount = 0;
+            if (!readValue(in, frame.delta) || !readValue(in, batchCount)) break;
+            frame.firstBatch = recording.batches.size();
+            frame.batchCount = batchCount;
+            bool complete = true;
+            for (uint8_t b = 0; b < batchCount && complete; ++b) {
+                uint8_t cursorLocked = 0;
+                uint16_t eventCount = 0;
+                complete = readValue(in, cursorLocked) && readValue(in, eventCount);
+                std::vector<InputEvent> events(complete ? eventCount : 0);
+                for (InputEvent& event : events) {
+                    if (!(complete = readEvent(in, event))) break;
+                }
+                recording.batches.emplace_back(cursorLocked != 0, std::move(events));
+            }
+            if (!complete || !readValue(in, frame.hash)) {
+                recording.batches.resize(frame.firstBatch);
+                break;
+            }
+            recording.frames.push_back(frame);
+        }
+        return true;
+    }
+}
+
+PhysicsRecorder* PhysicsRecorder::getInstance() {
+    static PhysicsRecorder instance;
+    return &instance;
+}
+
+void PhysicsRecorder::recordTo(const std::string& path) {
+    stopRecording();
+    recordPath = path;
+}
+
+void PhysicsRecorder::stopRecording() {
+    if (out.is_open()) {
+        out.close();
+    }
+    recordPath.clear();
+    pending.clear();
+}
+
+void PhysicsRecorder::replayFrom(const std::string& path) {
+    replayPath = path;
+}
+
+void PhysicsRecorder::onSceneStarted(int sceneId) {
+    if (!isRecording() || isReplaying()) return;
+    if (out.is_open()) {
+        out.close();
+    }
+    pending.clear();
+    out.open(recordPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "PhysicsRecorder - could not write " << recordPath << "\n";
+        recordPath.clear();
+        return;
+    }
+    // Enemies pick strafe directions with rand(), so the seed is part of the input.
+    const uint32_t seed = std::random_device{}();
+    std::srand(seed);
+
+    std::vector<EntityState> entities;
+    forEachEntity([&](Entity* entity) {
+        entities.push_back({entity->getName(), entity->getPosition(), entity->getRotation(), entity->getScale()});
+    });
+    const PhysicsWorld* physics = PhysicsWorld::getInstance();
+    writeValue(out, kRecordingMagic);
+    writeValue(out, kRecordingVersion);
+    writeValue(out, static_cast<int32_t>(sceneId));
+    writeValue(out, seed);
+    writeValue(out, physics->getTimestep());
+    writeValue(out, static_cast<int32_t>(physics->getMaxStepsPerFrame()));
+    writeValue(out, physics->getAccumulator());
+    writeValue(out, static_cast<uint32_t>(entities.size()));
+    for (const EntityState& state : entities) {
+        const uint16_t nameLength = static_cast<uint16_t>(std::min<size_t>(state.name.size(), UINT16_MAX));
+        writeValue(out, nameLength);
+        out.write(state.name.data(), nameLength);
+        writeValue(out, state.position);
+        writeValue(out, state.rotation);
+        writeValue(out, state.scale);
+    }
+}
+
+void PhysicsRecorder::recordInput(const std::vector<InputEvent>& events, bool cursorLocked) {
+    if (!out.is_open() || events.empty()) return;
+    pending.push_back({cursorLocked, events});
+}
+
+void PhysicsRecorder::recordFrame(float frameDelta) {
+    if (!out.is_open()) return;
+    const size_t batchCount = std::min<size_t>(pending.size(), UINT8_MAX);
+    writeValue(out, frameDelta);
+    writeValue(out, static_cast<uint8_t>(batchCount));
+    for (size_t b = 0; b < batchCount; ++b) {
+        const InputBatch& batch = pending[b];
+        const size_t eventCount = std::min<size_t>(batch.events.size(), UINT16_MAX);
+        writeValue(out, static_cast<uint8_t>(batch.cursorLocked ? 1 : 0));
+        writeValue(out, static_cast<uint16_t>(eventCount));
+        for (size_t e = 0; e < eventCount; ++e) {
+            writeEvent(out, batch.events[e]);
+        }
+    }
+    writeValue(out, hashEntityState());
+    pending.clear();
+}
+
+bool PhysicsRecorder::runReplay() {
+    matched = false;
+    Recording recording;
+    if (!readRecording(replayPath, recording)) {
+        std::cerr << "PhysicsRecorder - could not read recording " << replayPath << "\n";
+        return false;
+    }
+    SceneManager::getInstance()->switchScene(recording.sceneId);
+    std::srand(recording.seed);
+    PhysicsWorld* physics = PhysicsWorld::getInstance();
+    physics->setTimestep(recording.timestep);
+    physics->setMaxStepsPerFrame(recording.maxStepsPerFrame);
+    physics->setAccumulator(recording.accumulator);
+
+    std::vector<Entity*> entities;
+    forEachEntity([&](Entity* entity) { entities.push_back(entity); });
+    if (entities.size() != recording.entities.size()) {
+        std::cerr << "PhysicsRecorder - scene " << recording.sceneId << " built " << entities.size()
+                  << " entities, the recording has " << recording.entities.size() << "\n";
+        return false;
+    }
+    size_t restored = 0;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        Entity* entity = entities[i];
+        const EntityState& state = recording.entities[i];
+        if (entity->getName() != state.name) {
+            std::cerr << "PhysicsRecorder - expected entity " << state.name << ", scene built " << entity->getName() << "\n";
+            return false;
+        }
+        if (entity->getPosition() != state.position || entity->getRotation() != state.rotation || entity->getScale() != state.scale) {
+            entity->setPosition(state.position);
+            entity->setRotation(state.rotation);
+            entity->setScale(state.scale);
+            ++restored;
+        }
+    }
+    if (restored > 0) {
+        std::cerr << "PhysicsRecorder - moved " << restored << " entities back to their recorded start\n";
+    }
+
+    using Clock = std::chrono::steady_clock;
+    Renderer* renderer = Renderer::getInstance();
+    InputManager* input = InputManager::getInstance();
+    const uint64_t firstTick = physics->getTick();
+    size_t divergedFrame = SIZE_MAX;
+    size_t worstFrame = 0;
+    double worstMs = 0.0;
+    double totalMs = 0.0;
+    for (size_t f = 0; f < recording.frames.size(); ++f) {
+        const Frame& frame = recording.frames[f];
+        const Clock::time_point start = Clock::now();
+        for (size_t b = frame.firstBatch; b < frame.firstBatch + frame.batchCount; ++b) {
+            const auto& [cursorLocked, events] = recording.batches[b];
+            if (renderer->isCursorLocked() != cursorLocked) {
+                renderer->setCursorLocked(cursorLocked);
+            }
+            input->dispatch(events);
+        }
+        renderer->simulateFrame(frame.delta);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        totalMs += ms;
+        if (ms > worstMs) {
+            worstMs = ms;
+            worstFrame = f;
+        }
+        if (divergedFrame == SIZE_MAX && hashEntityState() != frame.hash) {
+            divergedFrame = f;
+        }
+    }
+
+    const size_t frameCount = recording.frames.size();
+    std::cout << "Replayed " << frameCount << " frames, " << (physics->getTick() - firstTick) << " physics steps, in "
+              << totalMs << " ms (mean " << (frameCount > 0 ? totalMs / static_cast<double>(frameCount) : 0.0)
+              << " ms, worst " << worstMs << " ms at frame " << worstFrame << ")\n";
+    if (divergedFrame != SIZE_MAX) {
+        std::cout << "State diverged from the recording at frame " << divergedFrame << "\n";
+        return false;
+    }
+    std::cout << "State matched the recording on every frame\n";
+    matched = true;
+    return true;
+}
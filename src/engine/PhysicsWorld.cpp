@@ -0,0 +1,387 @@
+#include <PhysicsWorld.h>
+#include <CharacterEntity.h>
+#include <CollisionWorld.h>
+#include <Entity.h>
+#include <JobSystem.h>
+#include <Projectile.h>
+#include <RigidBody.h>
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+namespace {
+    // Frames longer than this (window drags, breakpoints) are treated as this long.
+    constexpr float kMaxFrameDelta = 0.25f;
+
+    void refreshSubtree(Entity* entity) {
+        entity->updateWorldTransform();
+        for (Entity* child : entity->getChildren()) {
+            refreshSubtree(child);
+        }
+    }
+
+    // World-space shift that draws entity at previousPosition blended toward
+    // where it is now.
+    glm::vec3 blendOffset(Entity* entity, const glm::vec3& previousPosition, float alpha) {
+        // Gameplay and the steps above moved the entity after this frame's
+        // transform pass, so bring its subtree up to date before blending.
+        refreshSubtree(entity);
+        const glm::vec3 local = glm::mix(previousPosition, entity->getPosition(), alpha) - entity->getPosition();
+        Entity* parent = entity->getParent();
+        return parent ? glm::vec3(parent->getWorldTransform() * glm::vec4(local, 0.0f)) : local;
+    }
+}
+
+PhysicsWorld* PhysicsWorld::getInstance() {
+    static PhysicsWorld instance;
+    return &instance;
+}
+
+void PhysicsWorld::addBody(CharacterEntity* body) {
+    if (!body || bodyIndex.count(body)) return;
+    bodyIndex[body] = bodies.size();
+    bodies.push_back(Body{body, body->getPosition(), glm::vec3(0.0f)});
+}
+
+void PhysicsWorld::removeBody(CharacterEntity* body) {
+    auto it = bodyIndex.find(body);
+    if (it == bodyIndex.end()) return;
+    const size_t index = it->second;
+    bodyIndex.erase(it);
+    if (index + 1 != bodies.size()) {
+        bodies[index] = bodies.back();
+        bodyIndex[bodies[index].entity] = index;
+    }
+    bodies.pop_back();
+}
+
+void PhysicsWorld::addProjectile(Projectile* projectile) {
+    if (!projectile || flightIndex.count(projectile)) return;
+    flightIndex[projectile] = flights.size();
+    flights.push_back(Flight{projectile, projectile->getPosition(), glm::vec3(0.0f)});
+}
+
+// Keeps launch order, which is the order projectiles move and hit in.
+void PhysicsWorld::removeProjectile(Projectile* projectile) {
+    auto it = flightIndex.find(projectile);
+    if (it == flightIndex.end()) return;
+    const size_t index = it->second;
+    flightIndex.erase(it);
+    flights.erase(flights.begin() + static_cast<std::ptrdiff_t>(index));
+    for (size_t i = index; i < flights.size(); ++i) {
+        flightIndex[flights[i].projectile] = i;
+    }
+}
+
+void PhysicsWorld::setTimestep(float seconds) {
+    if (seconds <= 0.0f) {
+        std::cerr << "PhysicsWorld: ignoring non-positive timestep " << seconds << std::endl;
+        return;
+    }
+    timestep = seconds;
+    accumulator = std::min(accumulator, timestep);
+}
+
+void PhysicsWorld::setMaxStepsPerFrame(int steps) {
+    maxStepsPerFrame = std::max(steps, 1);
+}
+
+void PhysicsWorld::setAccumulator(float seconds) {
+    accumulator = std::clamp(seconds, 0.0f, timestep);
+    alpha = accumulator / timestep;
+}
+
+int PhysicsWorld::update(float frameDelta) {
+    accumulator += std::clamp(frameDelta, 0.0f, kMaxFrameDelta);
+
+    int steps = 0;
+    while (accumulator >= timestep && steps < maxStepsPerFrame) {
+        step();
+        accumulator -= timestep;
+        ++steps;
+        ++tick;
+    }
+    if (steps == maxStepsPerFrame && accumulator >= timestep) {
+        accumulator = std::fmod(accumulator, timestep);
+    }
+    alpha = accumulator / timestep;
+
+    updateRenderOffsets();
+    return steps;
+}
+
+void PhysicsWorld::wake(const Entity* entity) {
+    if (!entity) return;
+    if (auto it = bodyIndex.find(entity); it != bodyIndex.end()) {
+        bodies[it->second].entity->wake();
+    }
+    rigidBodies.wake(entity);
+}
+
+void PhysicsWorld::wakeBodies(const ColliderAABB& region) {
+    CollisionWorld::getInstance()->query(region, [&](Collider* collider) {
+        wake(collider->getParent());
+        return true;
+    });
+}
+
+void PhysicsWorld::step() {
+    for (Body& body : bodies) {
+        CharacterEntity* entity = body.entity;
+        // Moved by gameplay while asleep, e.g. teleported.
+        if (entity->sleeping && entity->getPosition() != body.previousPosition) {
+            entity->wake();
+        }
+        body.previousPosition = entity->getPosition();
+    }
+    buildIslands();
+    CollisionWorld* collisionWorld = CollisionWorld::getInstance();
+    // Warm lazily built collider caches so the islands below only read shared colliders.
+    collisionWorld->prepareQueries();
+
+    const size_t islandCount = islandRanges.size();
+    const bool parallel = bodies.size() >= kMinParallelBodies && islandCount > 1;
+    JobSystem::getInstance()->parallelFor("PhysicsWorld::islands", islandCount, parallel ? 1 : islandCount, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const auto [begin, end] = islandRanges[i];
+            std::span<CharacterEntity* const> island(islandBodies.data() + begin, end - begin);
+            for (CharacterEntity* body : island) {
+                body->islandMates = island;
+                body->simulate(timestep);
+            }
+            for (CharacterEntity* body : island) {
+                body->islandMates = {};
+            }
+        }
+    });
+
+    // In body order, so the result does not depend on island scheduling.
+    for (uint32_t i : activeBodies) {
+        CharacterEntity* entity = bodies[i].entity;
+        for (const CharacterEntity::Push& push : entity->pushes) {
+            rigidBodies.push(push.collider, push.point, push.direction, push.speed, entity->pushMass);
+        }
+        entity->pushes.clear();
+    }
+
+    // Projectiles sweep against the tree before it is synced: bodies are
+    // still found where the step started and hit along their motion.
+    if (!flights.empty()) {
+        recordBodyMotion();
+        for (Flight& flight : flights) {
+            flight.previousPosition = flight.projectile->getPosition();
+            flight.projectile->simulate(timestep);
+        }
+        bodyMotion.clear();
+    }
+
+    collisionWorld->refit();
+    if (rigidBodies.getBodyCount() > 0) {
+        rigidBodies.step(timestep);
+        collisionWorld->refit();
+    }
+    collisionWorld->updateTriggers();
+    // Whatever enters or leaves a trigger wakes up, and so does a body carrying the trigger.
+    collisionWorld->forEachTriggerChange([this](const Collider* trigger, const Collider* other) {
+        wake(trigger->getParent());
+        wake(other->getParent());
+    });
+    collisionWorld->dispatchTriggerEvents();
+}
+
+void PhysicsWorld::buildIslands() {
+    constexpr float kReachMargin = 0.05f;
+    const size_t count = bodies.size();
+    islandParent.resize(count);
+    reachBounds.resize(count);
+    bodyColliders.assign(count, nullptr);
+    sweepOrder.clear();
+    activeBodies.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (!bodies[i].entity->sleeping) {
+            activeBodies.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    auto addBody = [&](uint32_t i) {
+        islandParent[i] = i;
+        CharacterEntity* entity = bodies[i].entity;
+        Collider* collider = entity->getBodyCollider();
+        if (!collider) return;
+        bodyColliders[i] = collider;
+        // Everything this body can touch during the step lies within its reach,
+        // including the step-height lift and ground snap of the controller.
+        const float reach = (entity->moveSpeed + std::abs(entity->velocity.y) + 9.81f * timestep) * timestep + entity->stepHeight + kReachMargin;
+        ColliderAABB bounds = collider->getWorldAABB();
+        reachBounds[i] = {bounds.min - glm::vec3(reach), bounds.max + glm::vec3(reach)};
+        sweepOrder.push_back(i);
+    };
+    // Bodies ignore each other's colliders outside their island, so every
+    // sleeper an awake body could reach wakes up and joins the step.
+    const CollisionWorld* collisionWorld = CollisionWorld::getInstance();
+    const size_t awake = activeBodies.size();
+    for (size_t k = 0; k < awake; ++k) {
+        const uint32_t i = activeBodies[k];
+        addBody(i);
+        if (!bodyColliders[i]) continue;
+        collisionWorld->query(reachBounds[i], bodyColliders[i]->getCollisionMask(), [&](Collider* collider) {
+            auto it = bodyIndex.find(collider->getParent());
+            if (it == bodyIndex.end()) return true;
+            CharacterEntity* sleeper = bodies[it->second].entity;
+            if (sleeper->sleeping && collider == sleeper->getBodyCollider() && bodyColliders[i]->canCollideWith(*collider)) {
+                sleeper->wake();
+                activeBodies.push_back(static_cast<uint32_t>(it->second));
+            }
+            return true;
+        });
+    }
+    for (size_t k = awake; k < activeBodies.size(); ++k) {
+        addBody(activeBodies[k]);
+    }
+    std::sort(activeBodies.begin(), activeBodies.end());
+
+    // Sweep along x and union every pair whose reach boxes overlap.
+    std::sort(sweepOrder.begin(), sweepOrder.end(), [&](uint32_t a, uint32_t b) {
+        return reachBounds[a].min.x < reachBounds[b].min.x;
+    });
+    for (size_t i = 0; i < sweepOrder.size(); ++i) {
+        const ColliderAABB& a = reachBounds[sweepOrder[i]];
+        for (size_t j = i + 1; j < sweepOrder.size(); ++j) {
+            const ColliderAABB& b = reachBounds[sweepOrder[j]];
+            if (b.min.x > a.max.x) break;
+            if (!DynamicAABBTree::overlaps(a, b)) continue;
+            if (!bodyColliders[sweepOrder[i]]->canCollideWith(*bodyColliders[sweepOrder[j]])) continue;
+            const uint32_t rootA = findIsland(sweepOrder[i]);
+            const uint32_t rootB = findIsland(sweepOrder[j]);
+            if (rootA != rootB) {
+                islandParent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+            }
+        }
+    }
+
+    // Roots are the lowest body index of their island, so islands and the
+    // bodies inside them come out in body order.
+    islandRanges.clear();
+    std::vector<uint32_t>& islandOf = sweepOrder;
+    islandOf.assign(count, 0);
+    for (uint32_t i : activeBodies) {
+        const uint32_t root = findIsland(i);
+        if (root == i) {
+            islandOf[i] = static_cast<uint32_t>(islandRanges.size());
+            islandRanges.emplace_back(0, 0);
+        } else {
+            islandOf[i] = islandOf[root];
+        }
+        ++islandRanges[islandOf[i]].second;
+    }
+    uint32_t offset = 0;
+    for (auto& range : islandRanges) {
+        const uint32_t size = range.second;
+        range = {offset, offset};
+        offset += size;
+    }
+    islandBodies.resize(activeBodies.size());
+    for (uint32_t i : activeBodies) {
+        auto& range = islandRanges[islandOf[i]];
+        islandBodies[range.second++] = bodies[i].entity;
+    }
+}
+
+uint32_t PhysicsWorld::findIsland(uint32_t body) {
+    while (islandParent[body] != body) {
+        islandParent[body] = islandParent[islandParent[body]];
+        body = islandParent[body];
+    }
+    return body;
+}
+
+void PhysicsWorld::recordBodyMotion() {
+    bodyMotion.resize(bodies.size());
+    maxBodyTravel = 0.0f;
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        CharacterEntity* entity = bodies[i].entity;
+        const glm::vec3 local = entity->getPosition() - bodies[i].previousPosition;
+        Entity* parent = entity->getParent();
+        bodyMotion[i] = parent ? glm::vec3(parent->getWorldTransform() * glm::vec4(local, 0.0f)) : local;
+        maxBodyTravel = std::max(maxBodyTravel, glm::length(bodyMotion[i]));
+    }
+}
+
+bool PhysicsWorld::sweep(const ConvexShape& shape, const glm::vec3& motion, RaycastHit& hit, const QueryFilter& filter) const {
+    const float distance = glm::length(motion);
+    if (distance < 1e-6f) return false;
+    const glm::vec3 direction = motion / distance;
+
+    // Static pass: everything but bodies, as it stands.
+    QueryFilter worldFilter = filter;
+    worldFilter.accept = [this, &filter](const Collider* collider) {
+        return !isBody(collider->getParent()) && (!filter.accept || filter.accept(collider));
+    };
+    const CollisionWorld* collisionWorld = CollisionWorld::getInstance();
+    const bool ray = shape.kind == ConvexShape::Kind::Sphere && shape.radius <= 0.0f;
+    bool found = ray ? collisionWorld->raycast(shape.center, direction, distance, hit, worldFilter)
+                     : collisionWorld->shapeCast(shape, direction, distance, hit, worldFilter);
+
+    // Bodies: the tree may hold them anywhere along this step's motion, so
+    // widen the query by the farthest any of them moved.
+    ColliderAABB bounds = Collider::shapeBounds(shape);
+    bounds.min = glm::min(bounds.min, bounds.min + motion) - glm::vec3(maxBodyTravel);
+    bounds.max = glm::max(bounds.max, bounds.max + motion) + glm::vec3(maxBodyTravel);
+    collisionWorld->query(bounds, filter.mask, [&](Collider* collider) {
+        auto it = bodyIndex.find(collider->getParent());
+        if (it == bodyIndex.end() || collider->isConcave() || !filter.passes(collider)) return true;
+        const glm::vec3 travel = bodyMotion.empty() ? glm::vec3(0.0f) : bodyMotion[it->second];
+        ShapeCastResult result;
+        if (timeOfImpact(shape, motion, collider->getSupportShape(-travel), travel, result) &&
+            (!found || result.distance * distance < hit.distance)) {
+            hit.collider = collider;
+            hit.point = result.point;
+            hit.normal = result.normal;
+            hit.distance = result.distance * distance;
+            found = true;
+        }
+        return true;
+    });
+    return found;
+}
+
+void PhysicsWorld::updateRenderOffsets() {
+    for (Body& body : bodies) {
+        if (body.entity->sleeping) {
+            body.renderOffset = glm::vec3(0.0f);
+            continue;
+        }
+        body.renderOffset = blendOffset(body.entity, body.previousPosition, alpha);
+    }
+    for (Flight& flight : flights) {
+        flight.renderOffset = blendOffset(flight.projectile, flight.previousPosition, alpha);
+    }
+    for (uint32_t slot = 1; slot < rigidBodies.bodyCount; ++slot) {
+        rigidBodies.renderOffsets[slot] = rigidBodies.awake[slot]
+            ? blendOffset(rigidBodies.owners[slot], rigidBodies.previousPositions[slot], alpha)
+            : glm::vec3(0.0f);
+    }
+}
+
+const glm::vec3* PhysicsWorld::findRenderOffset(const Entity* entity) const {
+    for (; entity != nullptr; entity = entity->getParent()) {
+        if (auto it = bodyIndex.find(entity); it != bodyIndex.end()) {
+            return &bodies[it->second].renderOffset;
+        }
+        if (auto it = flightIndex.find(entity); it != flightIndex.end()) {
+            return &flights[it->second].renderOffset;
+        }
+        if (auto it = rigidBodies.slotOf.find(entity); it != rigidBodies.slotOf.end()) {
+            return &rigidBodies.renderOffsets[it->second];
+        }
+    }
+    return nullptr;
+}
+
+glm::mat4 PhysicsWorld::getRenderTransform(Entity* entity) const {
+    glm::mat4 transform = entity->getWorldTransform();
+    if (const glm::vec3* offset = findRenderOffset(entity)) {
+        transform[3] += glm::vec4(*offset, 0.0f);
+    }
+    return transform;
+}
@@ -0,0 +1,59 @@
+#include <Projectile.h>
+#include <CollisionWorld.h>
+
+namespace {
+    constexpr float kGravity = 9.81f;
+}
+
+Collider* Projectile::getShapeCollider() {
+    for (Entity* child : getChildren()) {
+        if (Collider* collider = dynamic_cast<Collider*>(child); collider && !collider->isTrigger()) {
+            return collider;
+        }
+    }
+    return nullptr;
+}
+
+void Projectile::simulate(float timestep) {
+    if (stopped) return;
+    velocity.y -= kGravity * gravityScale * timestep;
+    const glm::vec3 motion = velocity * timestep;
+
+    ConvexShape shape;
+    Collider* shapeCollider = getShapeCollider();
+    if (shapeCollider) {
+        shape = shapeCollider->getSupportShape();
+    } else {
+        shape.kind = ConvexShape::Kind::Sphere;
+        shape.center = getWorldPosition();
+        shape.radius = radius;
+    }
+
+    PhysicsWorld* physics = PhysicsWorld::getInstance();
+    QueryFilter filter;
+    filter.ignore = this;
+    filter.layer = CollisionLayer::Projectile;
+    filter.mask = hitMask;
+    // Other projectiles are mid-flight in this same loop; where they are
+    // would depend on launch order, so they are never hit.
+    filter.accept = [this, physics](const Collider* collider) {
+        const Entity* other = collider->getParent();
+        return other != owner && !physics->isProjectile(other);
+    };
+
+    RaycastHit hit;
+    const bool found = physics->sweep(shape, motion, hit, filter);
+    const float length = glm::length(motion);
+    const float travel = found && length > 0.0f ? hit.distance / length : 1.0f;
+    setPosition(getPosition() + motion * travel);
+    updateWorldTransform();
+    if (shapeCollider) {
+        shapeCollider->updateWorldTransform();
+    }
+    if (found) {
+        physics->wake(hit.collider->getParent());
+        stopped = true;
+        lastHit = hit;
+        onHit(hit);
+    }
+}
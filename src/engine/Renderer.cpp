@@ -9,7 +9,6 @@
 #include <stb/stb_image.h>
 #include <freetype/include/ft2build.h>
 #include FT_FREETYPE_H
-#include <omp.h>
 #include <iostream>
 #include <vector>
 #include <stdexcept>
@@ -28,12 +27,17 @@
 #include <variant>
 #include <queue>
 #include <Renderer.h>
+#include <JobSystem.h>
 #include <UIManager.h>
 #include <ShaderManager.h>
 #include <FontManager.h>
 #include <SceneManager.h>
 #include <TextureManager.h>
 #include <EntityManager.h>
+#include <EntityStore.h>
+#include <CollisionWorld.h>
+#include <PhysicsWorld.h>
+#include <PhysicsRecorder.h>
 #include <ModelManager.h>
 #include <Model.h>
 #include <UIObject.h>
@@ -160,7 +164,13 @@ struct TextVertex{
     void Renderer::run() {
         initWindow();
         initVulkan();
-        mainLoop();
+        PhysicsRecorder* recorder = PhysicsRecorder::getInstance();
+        if (recorder->isReplaying()) {
+            recorder->runReplay();
+        } else {
+            mainLoop();
+        }
+        recorder->stopRecording();
         cleanup();
     }
     ShaderManager* Renderer::getShaderManager() const { return shaderManager; }
@@ -756,6 +766,8 @@ struct TextVertex{
     void Renderer::initWindow() {
         glfwInit();
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        // Replays never present, but the scene still needs a device to load into.
+        glfwWindowHint(GLFW_VISIBLE, PhysicsRecorder::getInstance()->isReplaying() ? GLFW_FALSE : GLFW_TRUE);
         window = glfwCreateWindow(WIDTH, HEIGHT, "ParticleFront", nullptr, nullptr);
         glfwSetWindowUserPointer(window, this);
         glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);
@@ -954,6 +966,7 @@ struct TextVertex{
         while(!glfwWindowShouldClose(window)) {
             glfwPollEvents();
             processInput(window);
+            JobSystem::getInstance()->runMainThreadJobs();
             drawFrame();
         }
         vkDeviceWaitIdle(device);
@@ -1976,30 +1989,25 @@ void Renderer::createInstance() {
         fontManager->loadFont("src/assets/fonts/Lato.ttf", "Lato", 48);
     }
     void Renderer::updateEntities() {
-        auto& entities = entityManager->getAllEntities();
-        auto traverse = [&](auto&& self, Entity* entity) -> void {
-            entity->updateWorldTransform();
-            entity->update(deltaTime);
-            for (Entity* child : entity->getChildren()) {
-                self(self, child);
-            }
-        };
-        for (auto& [name, entity] : entities) {
-            if (entity->getParent() == nullptr) {
-                traverse(traverse, entity);
-            }
-        }
+        simulateFrame(deltaTime);
+        PhysicsRecorder::getInstance()->recordFrame(deltaTime);
+    }
+    void Renderer::simulateFrame(float frameDelta) {
+        entityManager->updateAll(frameDelta);
+        CollisionWorld::getInstance()->refit();
+        PhysicsWorld::getInstance()->update(frameDelta);
     }
     void Renderer::renderEntitiesGeometry(VkCommandBuffer commandBuffer) {
-        auto& entities = entityManager->getAllEntities();
+        EntityStore* store = EntityStore::getInstance();
+        const size_t count = entityManager->sortScene();
         glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 5.0f);
         float cameraFOV = 45.0f;
         glm::mat4 view = glm::mat4(1.0f);
 
-        int culledEntities = 0;
+        const PhysicsWorld* physicsWorld = PhysicsWorld::getInstance();
         Frustum frustrum;
         if (activeCamera) {
-            glm::mat4 cameraWorld = activeCamera->getWorldTransform();
+            glm::mat4 cameraWorld = PhysicsWorld::getInstance()->getRenderTransform(activeCamera);
             glm::vec4 worldPos = cameraWorld * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
             cameraPos = glm::vec3(worldPos);
             cameraFOV = activeCamera->getFOV();
@@ -2007,25 +2015,46 @@ void Renderer::createInstance() {
             frustrum = activeCamera->getFrustrum(aspectRatio, 0.1f, 100.0f, cameraWorld);
             view = glm::inverse(cameraWorld);
         }
-        auto renderEntity = [&](Entity* entity) -> bool {
-            if (!entity->isActive()) {
-                return false;
+        // An inactive entity hides its whole subtree, which is the run of slots after it.
+        drawSlots.clear();
+        for (size_t slot = 0; slot < count;) {
+            if (!store->isActive(slot)) {
+                slot = store->getSubtreeEnd(slot);
+                continue;
             }
-            std::string shaderName = entity->getShader();
-            if (shaderName != "gbuffer" && shaderName != "skybox") {
-                return true;
+            if (store->getRenderPass(slot) != EntityStore::RenderPass::None) {
+                drawSlots.push_back(static_cast<uint32_t>(slot));
             }
-            glm::mat4 modelMatrix = entity->getWorldTransform();
-            if (activeCamera && entity->getModel() && entity->getName() != "skybox") {
-                AABB bounds = entity->getWorldBounds(modelMatrix);
-                if (!frustrum.intersectsAABB(bounds.min, bounds.max)) {
-                    culledEntities++;
-                    return true;  // Culled: skip rendering
+            ++slot;
+        }
+
+        // Transforms and frustum tests only read entity state, so they run on
+        // the pool; recording the draws stays on this thread.
+        drawTransforms.resize(drawSlots.size());
+        drawVisible.resize(drawSlots.size());
+        JobSystem::getInstance()->parallelFor("Renderer::cull", drawSlots.size(), 256, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const size_t slot = drawSlots[i];
+                Entity* entity = store->getOwner(slot);
+                drawTransforms[i] = physicsWorld->getRenderTransform(entity);
+                bool visible = true;
+                if (activeCamera && store->getModel(slot) && store->getRenderPass(slot) != EntityStore::RenderPass::Skybox) {
+                    AABB bounds = entity->getWorldBounds(drawTransforms[i]);
+                    visible = frustrum.intersectsAABB(bounds.min, bounds.max);
                 }
+                drawVisible[i] = visible ? 1 : 0;
             }
-            Model* model = entity->getModel();
+        });
+
+        auto renderEntity = [&](size_t i) {
+            const size_t slot = drawSlots[i];
+            Entity* entity = store->getOwner(slot);
+            const EntityStore::RenderPass pass = store->getRenderPass(slot);
+            const char* shaderName = pass == EntityStore::RenderPass::GBuffer ? "gbuffer" : "skybox";
+            const glm::mat4& modelMatrix = drawTransforms[i];
+            Model* model = store->getModel(slot);
             Shader* shader = shaderManager->getShader(shaderName);
-            if (!model || !shader) return true;
+            if (!model || !shader) return;
             vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shader->pipeline);
             
             VkViewport viewport = {
@@ -2065,23 +2094,11 @@ void Renderer::createInstance() {
                     }
                 }
             }
-            return true;
         };
         
-        if (entities.empty()) return;
-        
-        auto traverse = [&](auto&& self, Entity* entity) -> void {
-            if (!renderEntity(entity)) {
-                return;
-            }
-            for (Entity* child : entity->getChildren()) {
-                self(self, child);
-            }
-        };
-        
-        for (auto& [name, entity] : entities) {
-            if (entity->getParent() == nullptr) {
-                traverse(traverse, entity);
+        for (size_t i = 0; i < drawSlots.size(); ++i) {
+            if (drawVisible[i]) {
+                renderEntity(i);
             }
         }
     }
@@ -2161,7 +2178,7 @@ void Renderer::createInstance() {
         glm::mat4 invView = glm::mat4(1.0f);
         glm::mat4 invProj = glm::mat4(1.0f);
         if (activeCamera) {
-            glm::mat4 cameraWorld = activeCamera->getWorldTransform();
+            glm::mat4 cameraWorld = PhysicsWorld::getInstance()->getRenderTransform(activeCamera);
             glm::vec4 worldPos = cameraWorld * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
             cameraPos = glm::vec3(worldPos);
             cameraFOV = activeCamera->getFOV();
@@ -2427,7 +2444,7 @@ void Renderer::createInstance() {
 
             SSRPushConstants ssrPushConstants{};
             if (activeCamera) {
-                glm::mat4 cameraWorld = activeCamera->getWorldTransform();
+                glm::mat4 cameraWorld = PhysicsWorld::getInstance()->getRenderTransform(activeCamera);
                 ssrPushConstants.view = glm::inverse(cameraWorld);
                 ssrPushConstants.proj = glm::perspective(glm::radians(activeCamera->getFOV()), 
                     static_cast<float>(swapChainExtent.width) / std::max(static_cast<float>(swapChainExtent.height), 1.0f), 
@@ -2526,6 +2543,14 @@ void Renderer::createInstance() {
         if(vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
             throw std::runtime_error("Failed to create texture sampler!");
     }
+    void Renderer::setCursorLocked(bool locked) {
+        glfwSetInputMode(window, GLFW_CURSOR, locked ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+        cursorLocked = locked;
+        firstMouse = true;
+        if (inputManager) {
+            inputManager->resetMouseDelta();
+        }
+    }
     void Renderer::setUIMode(bool enabled) {
         uiMode = enabled;
         hoveredObject = nullptr;
@@ -2716,10 +2741,7 @@ void Renderer::createInstance() {
 
         bool escapePressed = glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS;
         if (escapePressed && !escapeWasPressed && app->cursorLocked) {
-            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-            app->cursorLocked = false;
-            app->firstMouse = true;
-            app->inputManager->resetMouseDelta();
+            app->setCursorLocked(false);
         }
         escapeWasPressed = escapePressed;
 
@@ -2728,10 +2750,7 @@ void Renderer::createInstance() {
 
         if (!app->cursorLocked && !app->uiMode) {
             if (isPressed && !wasPressed) {
-                glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-                app->cursorLocked = true;
-                app->firstMouse = true;
-                app->inputManager->resetMouseDelta();
+                app->setCursorLocked(true);
             }
             wasPressed = isPressed;
             return;
@@ -0,0 +1,57 @@
+#include <RigidBody.h>
+#include <PhysicsWorld.h>
+#include <RigidBodySolver.h>
+
+namespace {
+    RigidBodySolver& solver() {
+        return PhysicsWorld::getInstance()->getRigidBodies();
+    }
+}
+
+RigidBody::RigidBody(const std::string& name, const std::string& shader, const glm::vec3& position, const glm::vec3& rotation, float mass, std::vector<std::string> textures)
+    : Entity(name, shader, position, rotation, glm::vec3(1.0f), std::move(textures)) {
+    solver().add(this, mass);
+}
+
+RigidBody::~RigidBody() {
+    solver().remove(this);
+}
+
+Collider* RigidBody::getShapeCollider() {
+    for (Entity* child : getChildren()) {
+        if (Collider* collider = dynamic_cast<Collider*>(child); collider && !collider->isTrigger()) {
+            return collider;
+        }
+    }
+    return nullptr;
+}
+
+float RigidBody::getMass() const { return solver().masses[slot]; }
+void RigidBody::setMass(float mass) { solver().setMass(slot, mass); }
+float RigidBody::getFriction() const { return solver().frictions[slot]; }
+void RigidBody::setFriction(float friction) { solver().frictions[slot] = std::max(friction, 0.0f); }
+float RigidBody::getRestitution() const { return solver().restitutions[slot]; }
+void RigidBody::setRestitution(float restitution) { solver().restitutions[slot] = std::clamp(restitution, 0.0f, 1.0f); }
+float RigidBody::getGravityScale() const { return solver().gravityScales[slot]; }
+void RigidBody::setGravityScale(float scale) { solver().gravityScales[slot] = scale; }
+
+glm::vec3 RigidBody::getLinearVelocity() const { return solver().linearVelocities[slot]; }
+
+void RigidBody::setLinearVelocity(const glm::vec3& velocity) {
+    solver().linearVelocities[slot] = velocity;
+    wake();
+}
+
+glm::vec3 RigidBody::getAngularVelocity() const { return solver().angularVelocities[slot]; }
+
+void RigidBody::setAngularVelocity(const glm::vec3& velocity) {
+    solver().angularVelocities[slot] = velocity;
+    wake();
+}
+
+void RigidBody::applyImpulse(const glm::vec3& impulse, const glm::vec3& point) {
+    solver().applyImpulse(slot, impulse, point);
+}
+
+bool RigidBody::isSleeping() const { return !solver().awake[slot]; }
+void RigidBody::wake() { solver().wake(slot); }
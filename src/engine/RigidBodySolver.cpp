@@ -0,0 +1,898 @@
+#include <RigidBodySolver.h>
+#include <CollisionWorld.h>
+#include <JobSystem.h>
+#include <PhysicsWorld.h>
+#include <RigidBody.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/euler_angles.hpp>
+
+namespace {
+    constexpr float kGravity = 9.81f;
+    // Pairs this far apart already get contacts, so bodies closing in are
+    // slowed to land exactly instead of sinking in and being pushed back out.
+    constexpr float kSpeculativeDistance = 0.02f;
+    // Penetration this small is left alone so resting contacts stay still;
+    // deeper overlap is pushed out by a fraction per step, at a capped speed.
+    constexpr float kLinearSlop = 0.005f;
+    constexpr float kBaumgarte = 0.2f;
+    constexpr float kMaxCorrectionSpeed = 3.0f;
+    // Slower impacts do not bounce, or resting bodies would never settle.
+    constexpr float kRestitutionThreshold = 1.0f;
+    constexpr float kLinearDamping = 0.01f;
+    constexpr float kAngularDamping = 0.05f;
+    // A point from an earlier step is kept while its two anchors have slid
+    // less than this apart along the surface.
+    constexpr float kPersistDistance = 0.04f;
+    // A body slower than this for kTimeToSleep is still; an island whose
+    // bodies are all still falls asleep.
+    constexpr float kSleepLinearSpeed = 0.05f;
+    constexpr float kSleepAngularSpeed = 0.05f;
+    constexpr float kTimeToSleep = 0.5f;
+    constexpr float kDefaultFriction = 0.5f;
+
+    glm::quat eulerToRotation(const glm::vec3& degrees) {
+        const glm::vec3 r = glm::radians(degrees);
+        return glm::normalize(glm::quat_cast(glm::mat3(glm::eulerAngleXYZ(r.x, r.y, r.z))));
+    }
+
+    // The inverse of Entity's X, then Y, then Z rotation order.
+    glm::vec3 rotationToEuler(const glm::quat& rotation) {
+        float x, y, z;
+        glm::extractEulerAngleXYZ(glm::mat4(glm::mat3_cast(rotation)), x, y, z);
+        return glm::degrees(glm::vec3(x, y, z));
+    }
+
+    // Depends on the normal alone, so accumulated friction impulses still
+    // point the same way on the next step.
+    void tangentBasis(const glm::vec3& n, glm::vec3& t1, glm::vec3& t2) {
+        t1 = std::abs(n.x) >= 0.57735f ? glm::vec3(n.y, -n.x, 0.0f) : glm::vec3(0.0f, n.z, -n.y);
+        t1 = glm::normalize(t1);
+        t2 = glm::cross(n, t1);
+    }
+
+    glm::mat3 boxInertia(float mass, const glm::vec3& half) {
+        const glm::vec3 sq = half * half;
+        const float k = mass / 3.0f;
+        return glm::mat3(glm::vec3(k * (sq.y + sq.z), 0.0f, 0.0f), glm::vec3(0.0f, k * (sq.x + sq.z), 0.0f), glm::vec3(0.0f, 0.0f, k * (sq.x + sq.y)));
+    }
+
+    void refreshSubtree(Entity* entity) {
+        entity->updateWorldTransform();
+        for (Entity* child : entity->getChildren()) {
+            refreshSubtree(child);
+        }
+    }
+}
+
+void RigidBodySolver::resetBody(size_t slot) {
+    owners[slot] = nullptr;
+    shapes[slot] = nullptr;
+    worldShapes[slot] = ConvexShape{};
+    positions[slot] = glm::vec3(0.0f);
+    orientations[slot] = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    linearVelocities[slot] = glm::vec3(0.0f);
+    angularVelocities[slot] = glm::vec3(0.0f);
+    masses[slot] = 0.0f;
+    inverseMasses[slot] = 0.0f;
+    inverseInertiaLocal[slot] = glm::mat3(0.0f);
+    inverseInertiaWorld[slot] = glm::mat3(0.0f);
+    frictions[slot] = kDefaultFriction;
+    restitutions[slot] = 0.0f;
+    gravityScales[slot] = 1.0f;
+    sleepTimers[slot] = 0.0f;
+    awake[slot] = 0;
+    writtenPositions[slot] = glm::vec3(0.0f);
+    writtenRotations[slot] = glm::vec3(0.0f);
+    previousPositions[slot] = glm::vec3(0.0f);
+    renderOffsets[slot] = glm::vec3(0.0f);
+}
+
+void RigidBodySolver::resizeBodies(size_t count) {
+    const size_t old = owners.size();
+    owners.resize(count);
+    shapes.resize(count);
+    worldShapes.resize(count);
+    positions.resize(count);
+    orientations.resize(count);
+    linearVelocities.resize(count);
+    angularVelocities.resize(count);
+    masses.resize(count);
+    inverseMasses.resize(count);
+    inverseInertiaLocal.resize(count);
+    inverseInertiaWorld.resize(count);
+    frictions.resize(count);
+    restitutions.resize(count);
+    gravityScales.resize(count);
+    sleepTimers.resize(count);
+    awake.resize(count);
+    writtenPositions.resize(count);
+    writtenRotations.resize(count);
+    previousPositions.resize(count);
+    renderOffsets.resize(count);
+    for (size_t slot = old; slot < count; ++slot) {
+        resetBody(slot);
+    }
+}
+
+void RigidBodySolver::moveBody(size_t from, size_t to) {
+    owners[to] = owners[from];
+    shapes[to] = shapes[from];
+    worldShapes[to] = worldShapes[from];
+    positions[to] = positions[from];
+    orientations[to] = orientations[from];
+    linearVelocities[to] = linearVelocities[from];
+    angularVelocities[to] = angularVelocities[from];
+    masses[to] = masses[from];
+    inverseMasses[to] = inverseMasses[from];
+    inverseInertiaLocal[to] = inverseInertiaLocal[from];
+    inverseInertiaWorld[to] = inverseInertiaWorld[from];
+    frictions[to] = frictions[from];
+    restitutions[to] = restitutions[from];
+    gravityScales[to] = gravityScales[from];
+    sleepTimers[to] = sleepTimers[from];
+    awake[to] = awake[from];
+    writtenPositions[to] = writtenPositions[from];
+    writtenRotations[to] = writtenRotations[from];
+    previousPositions[to] = previousPositions[from];
+    renderOffsets[to] = renderOffsets[from];
+}
+
+void RigidBodySolver::resizeContacts(size_t count) {
+    if (contactBodyA.size() >= count) return;
+    contactBodyA.resize(count);
+    contactBodyB.resize(count);
+    contactNormals.resize(count);
+    contactArmsA.resize(count);
+    contactArmsB.resize(count);
+    normalImpulses.resize(count);
+    contactSources.resize(count);
+    for (int t = 0; t < 2; ++t) {
+        tangentImpulses[t].resize(count);
+    }
+}
+
+void RigidBodySolver::add(RigidBody* body, float mass) {
+    if (!body || slotOf.count(body)) return;
+    const uint32_t slot = static_cast<uint32_t>(bodyCount++);
+    if (bodyCount > owners.size()) {
+        resizeBodies(bodyCount);
+    }
+    resetBody(slot);
+    owners[slot] = body;
+    body->slot = slot;
+    slotOf[body] = slot;
+    positions[slot] = body->getPosition();
+    orientations[slot] = eulerToRotation(body->getRotation());
+    writtenPositions[slot] = body->getPosition();
+    writtenRotations[slot] = body->getRotation();
+    previousPositions[slot] = body->getPosition();
+    masses[slot] = 1.0f;
+    setMass(slot, mass);
+    awake[slot] = 1;
+}
+
+void RigidBodySolver::remove(RigidBody* body) {
+    auto it = slotOf.find(body);
+    if (it == slotOf.end()) return;
+    const size_t slot = it->second;
+    slotOf.erase(it);
+    for (auto manifold = manifolds.begin(); manifold != manifolds.end();) {
+        if (manifold->second.bodyA == body || manifold->second.bodyB == body) {
+            manifold = manifolds.erase(manifold);
+        } else {
+            ++manifold;
+        }
+    }
+    const size_t last = bodyCount - 1;
+    if (slot != last) {
+        moveBody(last, slot);
+        owners[slot]->slot = static_cast<uint32_t>(slot);
+        slotOf[owners[slot]] = static_cast<uint32_t>(slot);
+    }
+    resetBody(last);
+    --bodyCount;
+    awakeBodies.erase(std::remove(awakeBodies.begin(), awakeBodies.end(), static_cast<uint32_t>(last)), awakeBodies.end());
+}
+
+void RigidBodySolver::setMass(uint32_t slot, float mass) {
+    if (!(mass > 0.0f) || !std::isfinite(mass)) {
+        std::cerr << "RigidBody: ignoring non-positive mass " << mass << std::endl;
+        return;
+    }
+    masses[slot] = mass;
+    updateMassProperties(slot);
+    wake(slot);
+}
+
+void RigidBodySolver::setIterations(int count) {
+    iterations = std::max(count, 1);
+}
+
+// Inertia of the shape about the body's origin, in the body's frame: the
+// shape's own box inertia rotated into the body, plus the parallel-axis
+// term for how far the shape sits from the origin.
+void RigidBodySolver::updateMassProperties(uint32_t slot) {
+    const float mass = masses[slot];
+    inverseMasses[slot] = 1.0f / mass;
+
+    const glm::mat3 toBody = glm::transpose(glm::mat3_cast(orientations[slot]));
+    glm::mat3 basis(1.0f);
+    glm::vec3 half(0.5f);
+    glm::vec3 offset(0.0f);
+    if (Collider* shape = shapes[slot]) {
+        const ConvexShape world = shape->getSupportShape();
+        offset = toBody * (world.center - positions[slot]);
+        switch (world.kind) {
+            case ConvexShape::Kind::Box:
+                basis = toBody * glm::mat3(world.axes[0], world.axes[1], world.axes[2]);
+                half = world.halfExtents;
+                break;
+            case ConvexShape::Kind::Capsule: {
+                // Only the capsule's long axis is meaningful; it is symmetric about it.
+                glm::vec3 across[2];
+                tangentBasis(world.axes[1], across[0], across[1]);
+                basis = toBody * glm::mat3(across[0], world.axes[1], across[1]);
+                half = glm::vec3(world.radius, world.halfLength + world.radius, world.radius);
+                break;
+            }
+            case ConvexShape::Kind::Sphere:
+                half = glm::vec3(world.radius);
+                break;
+            case ConvexShape::Kind::Points: {
+                glm::vec3 lo(FLT_MAX);
+                glm::vec3 hi(-FLT_MAX);
+                for (size_t i = 0; i < world.pointCount; ++i) {
+                    const glm::vec3 p = toBody * (world.points[i] + world.offset - positions[slot]);
+                    lo = glm::min(lo, p);
+                    hi = glm::max(hi, p);
+                }
+                if (world.pointCount > 0) {
+                    offset = (lo + hi) * 0.5f;
+                    half = (hi - lo) * 0.5f;
+                }
+                break;
+            }
+        }
+    }
+
+    const glm::mat3 own = basis * boxInertia(mass, half) * glm::transpose(basis);
+    glm::mat3 inertia;
+    const float offsetSq = glm::dot(offset, offset);
+    for (int c = 0; c < 3; ++c) {
+        glm::vec3 column = own[c] - offset * (mass * offset[c]);
+        column[c] += mass * offsetSq;
+        inertia[c] = column;
+    }
+    inverseInertiaLocal[slot] = glm::inverse(inertia);
+    const glm::mat3 rotation = glm::mat3_cast(orientations[slot]);
+    inverseInertiaWorld[slot] = rotation * inverseInertiaLocal[slot] * glm::transpose(rotation);
+}
+
+void RigidBodySolver::wake(uint32_t slot) {
+    if (slot == 0 || slot >= bodyCount) return;
+    awake[slot] = 1;
+    sleepTimers[slot] = 0.0f;
+}
+
+void RigidBodySolver::wake(const Entity* entity) {
+    if (auto it = slotOf.find(entity); it != slotOf.end()) {
+        wake(it->second);
+    }
+}
+
+void RigidBodySolver::applyImpulseAt(uint32_t slot, const glm::vec3& impulse, const glm::vec3& arm) {
+    linearVelocities[slot] += impulse * inverseMasses[slot];
+    angularVelocities[slot] += inverseInertiaWorld[slot] * glm::cross(arm, impulse);
+}
+
+void RigidBodySolver::applyImpulse(uint32_t slot, const glm::vec3& impulse, const glm::vec3& point) {
+    if (slot == 0 || slot >= bodyCount) return;
+    wake(slot);
+    applyImpulseAt(slot, impulse, point - positions[slot]);
+}
+
+void RigidBodySolver::push(const Collider* collider, const glm::vec3& point, const glm::vec3& direction, float speed, float pusherMass) {
+    if (!collider) return;
+    auto it = slotOf.find(collider->getParent());
+    if (it == slotOf.end()) return;
+    const uint32_t slot = it->second;
+    wake(slot);
+    const glm::vec3 arm = point - positions[slot];
+    const float along = glm::dot(linearVelocities[slot] + glm::cross(angularVelocities[slot], arm), direction);
+    if (along >= speed) return;
+    const glm::vec3 armCross = glm::cross(arm, direction);
+    const float k = inverseMasses[slot] + glm::dot(armCross, inverseInertiaWorld[slot] * armCross) + (pusherMass > 0.0f ? 1.0f / pusherMass : 0.0f);
+    if (k <= 0.0f) return;
+    applyImpulseAt(slot, direction * ((speed - along) / k), arm);
+}
+
+void RigidBodySolver::step(float timestep) {
+    if (bodyCount <= 1) return;
+    ++stepCount;
+
+    syncFromEntities();
+    findPairs(timestep);
+    for (uint32_t slot : awakeBodies) {
+        const glm::mat3 rotation = glm::mat3_cast(orientations[slot]);
+        inverseInertiaWorld[slot] = rotation * inverseInertiaLocal[slot] * glm::transpose(rotation);
+        glm::vec3& v = linearVelocities[slot];
+        v.y -= kGravity * gravityScales[slot] * timestep;
+        v *= 1.0f / (1.0f + timestep * kLinearDamping);
+        angularVelocities[slot] *= 1.0f / (1.0f + timestep * kAngularDamping);
+    }
+    collidePairs(timestep);
+    mergeManifolds();
+    buildIslands();
+    batchContacts();
+
+    const size_t islandCount = islandRanges.size();
+    const bool parallel = contactCount >= kMinParallelContacts && islandCount > 1;
+    JobSystem::getInstance()->parallelFor("RigidBodySolver::islands", islandCount, parallel ? 1 : islandCount, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const auto [begin, end] = islandBatchRanges[i];
+            prepareContacts(begin, end, timestep);
+            solveIsland(begin, end);
+            for (size_t k = begin; k < end; ++k) {
+                const ContactBatch& batch = contactBatches[k];
+                for (uint32_t l = 0; l < batch.lanes; ++l) {
+                    ManifoldPoint* point = contactSources[batch.contact[l]];
+                    point->normalImpulse = batch.impulse[0][l];
+                    point->tangentImpulse[0] = batch.impulse[1][l];
+                    point->tangentImpulse[1] = batch.impulse[2][l];
+                }
+            }
+        }
+    });
+
+    integrate(timestep);
+    updateSleep(timestep);
+    writeToEntities();
+
+    // Pairs that stopped touching; those of sleeping bodies are kept for when they wake.
+    for (auto it = manifolds.begin(); it != manifolds.end();) {
+        const Manifold& m = it->second;
+        const bool active = awake[m.bodyA->slot] || (m.bodyB && awake[m.bodyB->slot]);
+        if (m.lastStep != stepCount && active) {
+            it = manifolds.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Gameplay may have teleported bodies or attached their collider since the
+// last step; pick that up before anything reads the arrays.
+void RigidBodySolver::syncFromEntities() {
+    awakeBodies.clear();
+    for (uint32_t slot = 1; slot < bodyCount; ++slot) {
+        RigidBody* body = owners[slot];
+        if (body->getPosition() != writtenPositions[slot]) {
+            positions[slot] = body->getPosition();
+            writtenPositions[slot] = positions[slot];
+            wake(slot);
+        }
+        if (body->getRotation() != writtenRotations[slot]) {
+            orientations[slot] = eulerToRotation(body->getRotation());
+            writtenRotations[slot] = body->getRotation();
+            wake(slot);
+        }
+        if (!awake[slot]) continue;
+        Collider* shape = body->getShapeCollider();
+        if (shape != shapes[slot]) {
+            shapes[slot] = shape;
+            refreshSubtree(body);
+            updateMassProperties(slot);
+        }
+        previousPositions[slot] = positions[slot];
+        awakeBodies.push_back(slot);
+    }
+}
+
+// Every awake body looks for what it could touch within this step's margin.
+// A sleeping body in reach wakes up and looks in turn, so a pile wakes as a
+// whole. Each pair is found once, by whichever body looks first.
+void RigidBodySolver::findPairs(float timestep) {
+    float maxSpeed = 0.0f;
+    for (uint32_t slot : awakeBodies) {
+        maxSpeed = std::max(maxSpeed, glm::length(linearVelocities[slot]));
+    }
+    const float margin = kSpeculativeDistance + (maxSpeed + kGravity * timestep) * timestep;
+    pairs.clear();
+    visited.assign(bodyCount, 0);
+
+    const CollisionWorld* collisionWorld = CollisionWorld::getInstance();
+    for (size_t k = 0; k < awakeBodies.size(); ++k) {
+        const uint32_t i = awakeBodies[k];
+        visited[i] = 1;
+        Collider* shape = shapes[i];
+        if (!shape) continue;
+        ColliderAABB bounds = shape->getWorldAABB();
+        bounds.min -= glm::vec3(margin);
+        bounds.max += glm::vec3(margin);
+        collisionWorld->query(bounds, shape->getCollisionMask(), [&](Collider* other) {
+            if (other == shape || other->isTrigger() || other->getParent() == owners[i] || !shape->canCollideWith(*other)) return true;
+            if (!DynamicAABBTree::overlaps(bounds, other->getWorldAABB())) return true;
+            auto it = slotOf.find(other->getParent());
+            if (it == slotOf.end()) {
+                pairs.push_back(Pair{i, 0, other});
+                return true;
+            }
+            const uint32_t j = it->second;
+            if (visited[j]) return true;
+            if (!awake[j]) {
+                wake(j);
+                Collider* otherShape = owners[j]->getShapeCollider();
+                if (otherShape != shapes[j]) {
+                    shapes[j] = otherShape;
+                    refreshSubtree(owners[j]);
+                    updateMassProperties(j);
+                }
+                previousPositions[j] = positions[j];
+                awakeBodies.push_back(j);
+            }
+            if (other == shapes[j]) {
+                pairs.push_back(Pair{i, j, other});
+            }
+            return true;
+        });
+    }
+    std::sort(awakeBodies.begin(), awakeBodies.end());
+}
+
+// The narrowphase only reads shapes, so pairs run in parallel. Lazily
+// cached collider data is brought up to date first.
+void RigidBodySolver::collidePairs(float timestep) {
+    float maxSpeed = 0.0f;
+    for (uint32_t slot : awakeBodies) {
+        if (shapes[slot]) {
+            shapes[slot]->prepareQueries();
+            worldShapes[slot] = shapes[slot]->getSupportShape();
+        }
+        maxSpeed = std::max(maxSpeed, glm::length(linearVelocities[slot]));
+    }
+    for (const Pair& pair : pairs) {
+        if (pair.b == 0) pair.other->prepareQueries();
+    }
+    const float margin = kSpeculativeDistance + maxSpeed * timestep;
+
+    pairPoints.resize(pairs.size() * kMaxPairPoints);
+    pairPointCounts.assign(pairs.size(), 0);
+    const bool parallel = pairs.size() >= kMinParallelContacts;
+    JobSystem::getInstance()->parallelFor("RigidBodySolver::collidePairs", pairs.size(), parallel ? kPairGrain : pairs.size(), [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            const Pair& pair = pairs[p];
+            const ConvexShape& a = worldShapes[pair.a];
+            ContactPoint* out = &pairPoints[p * kMaxPairPoints];
+            uint32_t& count = pairPointCounts[p];
+
+            if (pair.b == 0 && pair.other->isConcave()) {
+                // Meshes and heightfields only report triangles the shape overlaps; each gives one point.
+                thread_local std::vector<MeshContact> found;
+                found.clear();
+                CollisionMTV mtv;
+                pair.other->collideShape(a, Collider::shapeBounds(a), mtv, &found);
+                std::sort(found.begin(), found.end(), [](const MeshContact& x, const MeshContact& y) {
+                    return x.penetration > y.penetration;
+                });
+                for (const MeshContact& contact : found) {
+                    if (count == kMaxPairPoints) break;
+                    ContactPoint& point = out[count++];
+                    point.normal = contact.normal;
+                    point.separation = -contact.penetration;
+                    point.position = contact.point - contact.normal * (contact.penetration * 0.5f);
+                    point.id = contact.triangle + 1;
+                }
+                continue;
+            }
+
+            const ConvexShape b = pair.b != 0 ? worldShapes[pair.b] : pair.other->getSupportShape();
+            if (a.kind == ConvexShape::Kind::Box && b.kind == ConvexShape::Kind::Box) {
+                count = static_cast<uint32_t>(collideBoxes(a, b, margin, out));
+            } else {
+                count = collideConvex(a, b, margin, out[0]) ? 1 : 0;
+            }
+        }
+    });
+}
+
+// Matches this step's points with the pair's earlier ones to carry their
+// impulses over. Box pairs get a complete manifold every step; the others
+// also keep earlier points that still hold, up to a full manifold.
+void RigidBodySolver::mergeManifolds() {
+    pending.clear();
+    PhysicsWorld* physics = PhysicsWorld::getInstance();
+
+    auto toLocal = [&](uint32_t slot, const glm::vec3& p) {
+        return slot == 0 ? p : glm::conjugate(orientations[slot]) * (p - positions[slot]);
+    };
+    auto toWorld = [&](uint32_t slot, const glm::vec3& p) {
+        return slot == 0 ? p : orientations[slot] * p + positions[slot];
+    };
+
+    for (size_t p = 0; p < pairs.size(); ++p) {
+        const Pair& pair = pairs[p];
+        const ContactPoint* incoming = &pairPoints[p * kMaxPairPoints];
+        const uint32_t count = pairPointCounts[p];
+        const PairKey key{shapes[pair.a], pair.other};
+        auto found = manifolds.find(key);
+        if (count == 0 && found == manifolds.end()) continue;
+        Manifold& m = found != manifolds.end() ? found->second : manifolds[key];
+        m.bodyA = owners[pair.a];
+        m.bodyB = pair.b != 0 ? owners[pair.b] : nullptr;
+        m.lastStep = stepCount;
+
+        const bool mesh = pair.b == 0 && pair.other->isConcave();
+        const bool boxes = !mesh && worldShapes[pair.a].kind == ConvexShape::Kind::Box &&
+                           (pair.b != 0 ? worldShapes[pair.b] : pair.other->getSupportShape()).kind == ConvexShape::Kind::Box;
+        const size_t capacity = mesh ? kMaxPairPoints : kMaxManifoldPoints;
+
+        ManifoldPoint merged[2 * kMaxPairPoints];
+        size_t mergedCount = 0;
+        bool used[kMaxPairPoints] = {};
+        for (uint32_t k = 0; k < count; ++k) {
+            const ContactPoint& c = incoming[k];
+            ManifoldPoint point;
+            point.normal = c.normal;
+            point.separation = c.separation;
+            point.id = c.id;
+            point.localA = toLocal(pair.a, c.position + c.normal * (c.separation * 0.5f));
+            point.localB = toLocal(pair.b, c.position - c.normal * (c.separation * 0.5f));
+            for (uint32_t old = 0; old < m.pointCount; ++old) {
+                if (used[old]) continue;
+                const ManifoldPoint& previous = m.points[old];
+                const glm::vec3 drift = previous.localA - point.localA;
+                // A mesh triangle or a GJK pair reports one point wherever it is deepest,
+                // so a point that moved is a new one and the old one may still hold.
+                if (previous.id != point.id || glm::dot(drift, drift) > kPersistDistance * kPersistDistance) continue;
+                used[old] = true;
+                point.normalImpulse = previous.normalImpulse;
+                point.tangentImpulse[0] = previous.tangentImpulse[0];
+                point.tangentImpulse[1] = previous.tangentImpulse[1];
+                break;
+            }
+            merged[mergedCount++] = point;
+        }
+        if (!boxes) {
+            for (uint32_t old = 0; old < m.pointCount; ++old) {
+                if (used[old]) continue;
+                ManifoldPoint point = m.points[old];
+                const glm::vec3 gap = toWorld(pair.a, point.localA) - toWorld(pair.b, point.localB);
+                point.separation = glm::dot(gap, point.normal);
+                const glm::vec3 slide = gap - point.normal * point.separation;
+                if (point.separation > kSpeculativeDistance || glm::dot(slide, slide) > kPersistDistance * kPersistDistance) continue;
+                merged[mergedCount++] = point;
+            }
+        }
+
+        if (mergedCount > capacity) {
+            if (capacity == kMaxManifoldPoints) {
+                ContactPoint candidates[2 * kMaxPairPoints];
+                for (size_t k = 0; k < mergedCount; ++k) {
+                    candidates[k].position = toWorld(pair.a, merged[k].localA);
+                    candidates[k].separation = merged[k].separation;
+                    candidates[k].id = static_cast<uint32_t>(k);
+                }
+                reduceContacts(candidates, mergedCount);
+                ManifoldPoint kept[kMaxManifoldPoints];
+                for (size_t k = 0; k < kMaxManifoldPoints; ++k) {
+                    kept[k] = merged[candidates[k].id];
+                }
+                std::copy(kept, kept + kMaxManifoldPoints, merged);
+            } else {
+                std::sort(merged, merged + mergedCount, [](const ManifoldPoint& x, const ManifoldPoint& y) {
+                    return x.separation < y.separation;
+                });
+            }
+            mergedCount = capacity;
+        }
+        std::copy(merged, merged + mergedCount, m.points);
+        m.pointCount = static_cast<uint32_t>(mergedCount);
+
+        for (uint32_t k = 0; k < m.pointCount; ++k) {
+            ManifoldPoint& point = m.points[k];
+            const glm::vec3 position = (toWorld(pair.a, point.localA) + toWorld(pair.b, point.localB)) * 0.5f;
+            pending.push_back(PendingContact{pair.a, pair.b, &point, position});
+        }
+        // Characters act as immovable here, but must not sleep through a prop landing on them.
+        if (pair.b == 0 && m.pointCount > 0 && glm::length(linearVelocities[pair.a]) > kSleepLinearSpeed) {
+            physics->wake(pair.other->getParent());
+        }
+    }
+}
+
+// Bodies joined by contacts form an island; slot 0 joins nothing. Contacts
+// and bodies are laid out island by island, islands in order of their
+// lowest slot, so each island's constraints are contiguous.
+void RigidBodySolver::buildIslands() {
+    islandParent.resize(bodyCount);
+    for (uint32_t slot : awakeBodies) {
+        islandParent[slot] = slot;
+    }
+    for (const PendingContact& contact : pending) {
+        if (contact.b == 0) continue;
+        const uint32_t rootA = findIsland(contact.a);
+        const uint32_t rootB = findIsland(contact.b);
+        if (rootA != rootB) {
+            islandParent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+    }
+
+    islandOf.resize(bodyCount);
+    islandRanges.clear();
+    islandBodyRanges.clear();
+    for (uint32_t slot : awakeBodies) {
+        const uint32_t root = findIsland(slot);
+        if (root == slot) {
+            islandOf[slot] = static_cast<uint32_t>(islandRanges.size());
+            islandRanges.emplace_back(0, 0);
+            islandBodyRanges.emplace_back(0, 0);
+        } else {
+            islandOf[slot] = islandOf[root];
+        }
+        ++islandBodyRanges[islandOf[slot]].second;
+    }
+    for (const PendingContact& contact : pending) {
+        ++islandRanges[islandOf[contact.a]].second;
+    }
+    uint32_t contactOffset = 0;
+    uint32_t bodyOffset = 0;
+    for (size_t i = 0; i < islandRanges.size(); ++i) {
+        const uint32_t contacts = islandRanges[i].second;
+        const uint32_t bodies = islandBodyRanges[i].second;
+        islandRanges[i] = {contactOffset, contactOffset};
+        islandBodyRanges[i] = {bodyOffset, bodyOffset};
+        contactOffset += contacts;
+        bodyOffset += bodies;
+    }
+    islandBodies.resize(awakeBodies.size());
+    for (uint32_t slot : awakeBodies) {
+        islandBodies[islandBodyRanges[islandOf[slot]].second++] = slot;
+    }
+
+    contactCount = pending.size();
+    resizeContacts(contactCount);
+    for (const PendingContact& contact : pending) {
+        const uint32_t c = islandRanges[islandOf[contact.a]].second++;
+        contactBodyA[c] = contact.a;
+        contactBodyB[c] = contact.b;
+        contactNormals[c] = contact.point->normal;
+        contactArmsA[c] = contact.position - positions[contact.a];
+        contactArmsB[c] = contact.position - positions[contact.b];
+        normalImpulses[c] = contact.point->normalImpulse;
+        tangentImpulses[0][c] = contact.point->tangentImpulse[0];
+        tangentImpulses[1][c] = contact.point->tangentImpulse[1];
+        contactSources[c] = contact.point;
+    }
+}
+
+uint32_t RigidBodySolver::findIsland(uint32_t slot) {
+    while (islandParent[slot] != slot) {
+        islandParent[slot] = islandParent[islandParent[slot]];
+        slot = islandParent[slot];
+    }
+    return slot;
+}
+
+// Greedy colouring: each contact takes a lane in the first batch of its
+// island that has one free and does not already move either of its bodies.
+void RigidBodySolver::batchContacts() {
+    contactBatches.clear();
+    islandBatchRanges.clear();
+    for (const auto& [begin, end] : islandRanges) {
+        const size_t first = contactBatches.size();
+        // Batches before open are full.
+        size_t open = first;
+        for (uint32_t c = begin; c < end; ++c) {
+            const uint32_t a = contactBodyA[c];
+            const uint32_t b = contactBodyB[c];
+            auto fits = [&](const ContactBatch& batch) {
+                if (batch.lanes == kLaneWidth) return false;
+                for (uint32_t l = 0; l < batch.lanes; ++l) {
+                    if (batch.bodyA[l] == a || batch.bodyB[l] == a || (b != 0 && (batch.bodyA[l] == b || batch.bodyB[l] == b))) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+            size_t k = open;
+            const size_t last = std::min(contactBatches.size(), open + kMaxBatchSearch);
+            while (k < last && !fits(contactBatches[k])) {
+                ++k;
+            }
+            if (k == last) {
+                k = contactBatches.size();
+                contactBatches.emplace_back();
+            }
+            ContactBatch& batch = contactBatches[k];
+            batch.bodyA[batch.lanes] = a;
+            batch.bodyB[batch.lanes] = b;
+            batch.contact[batch.lanes] = c;
+            ++batch.lanes;
+            while (open < contactBatches.size() && contactBatches[open].lanes == kLaneWidth) {
+                ++open;
+            }
+        }
+        islandBatchRanges.emplace_back(static_cast<uint32_t>(first), static_cast<uint32_t>(contactBatches.size()));
+    }
+}
+
+// Effective masses and target speeds, then last step's impulses applied
+// up front (warm starting).
+void RigidBodySolver::prepareContacts(size_t begin, size_t end, float timestep) {
+    for (size_t k = begin; k < end; ++k) {
+        ContactBatch& batch = contactBatches[k];
+        for (uint32_t l = 0; l < batch.lanes; ++l) {
+            const uint32_t c = batch.contact[l];
+            const uint32_t a = contactBodyA[c];
+            const uint32_t b = contactBodyB[c];
+            const glm::vec3 rA = contactArmsA[c];
+            const glm::vec3 rB = contactArmsB[c];
+            glm::vec3 axes[3];
+            axes[0] = contactNormals[c];
+            tangentBasis(axes[0], axes[1], axes[2]);
+
+            batch.inverseMassA[l] = inverseMasses[a];
+            batch.inverseMassB[l] = inverseMasses[b];
+            for (int row = 0; row < 3; ++row) {
+                const glm::vec3 crossA = glm::cross(rA, axes[row]);
+                const glm::vec3 crossB = glm::cross(rB, axes[row]);
+                const glm::vec3 angularA = inverseInertiaWorld[a] * crossA;
+                const glm::vec3 angularB = inverseInertiaWorld[b] * crossB;
+                for (int i = 0; i < 3; ++i) {
+                    batch.axis[row][i][l] = axes[row][i];
+                    batch.armCrossA[row][i][l] = crossA[i];
+                    batch.armCrossB[row][i][l] = crossB[i];
+                    batch.angularA[row][i][l] = angularA[i];
+                    batch.angularB[row][i][l] = angularB[i];
+                }
+                const float inverseMass = inverseMasses[a] + inverseMasses[b] + glm::dot(crossA, angularA) + glm::dot(crossB, angularB);
+                batch.mass[row][l] = inverseMass > 0.0f ? 1.0f / inverseMass : 0.0f;
+            }
+
+            const float separation = contactSources[c]->separation;
+            const glm::vec3 dv = linearVelocities[a] + glm::cross(angularVelocities[a], rA) - linearVelocities[b] - glm::cross(angularVelocities[b], rB);
+            const float vn = glm::dot(dv, axes[0]);
+            // Apart: close at most the gap this step. Overlapping: push out.
+            float target = separation > 0.0f ? -separation / timestep
+                                             : std::min(kBaumgarte * std::max(-separation - kLinearSlop, 0.0f) / timestep, kMaxCorrectionSpeed);
+            const float restitution = std::max(restitutions[a], restitutions[b]);
+            if (vn < -kRestitutionThreshold) {
+                target = std::max(target, -restitution * vn);
+            }
+            batch.targetVelocity[l] = target;
+            batch.friction[l] = std::sqrt(frictions[a] * frictions[b]);
+
+            batch.impulse[0][l] = normalImpulses[c];
+            batch.impulse[1][l] = tangentImpulses[0][c];
+            batch.impulse[2][l] = tangentImpulses[1][c];
+            const glm::vec3 impulse = axes[0] * normalImpulses[c] + axes[1] * tangentImpulses[0][c] + axes[2] * tangentImpulses[1][c];
+            applyImpulseAt(a, impulse, rA);
+            if (b != 0) {
+                applyImpulseAt(b, -impulse, rB);
+            }
+        }
+    }
+}
+
+// Gauss-Seidel over the island's batches: friction first, clamped by the
+// current normal impulse, then the non-penetration constraint. Contacts of
+// a batch share no moving body, so its lanes are solved at once.
+void RigidBodySolver::solveIsland(size_t begin, size_t end) {
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        for (size_t k = begin; k < end; ++k) {
+            ContactBatch& batch = contactBatches[k];
+            float vA[3][kLaneWidth];
+            float wA[3][kLaneWidth];
+            float vB[3][kLaneWidth];
+            float wB[3][kLaneWidth];
+            for (size_t l = 0; l < kLaneWidth; ++l) {
+                const uint32_t a = batch.bodyA[l];
+                const uint32_t b = batch.bodyB[l];
+                for (int i = 0; i < 3; ++i) {
+                    vA[i][l] = linearVelocities[a][i];
+                    wA[i][l] = angularVelocities[a][i];
+                    vB[i][l] = linearVelocities[b][i];
+                    wB[i][l] = angularVelocities[b][i];
+                }
+            }
+
+            // Speed along the row's axis at which the contact points close.
+            auto closing = [&](int row, float (&speed)[kLaneWidth]) {
+                for (size_t l = 0; l < kLaneWidth; ++l) {
+                    speed[l] = 0.0f;
+                }
+                for (int i = 0; i < 3; ++i) {
+                    for (size_t l = 0; l < kLaneWidth; ++l) {
+                        speed[l] += (vA[i][l] - vB[i][l]) * batch.axis[row][i][l] + wA[i][l] * batch.armCrossA[row][i][l] - wB[i][l] * batch.armCrossB[row][i][l];
+                    }
+                }
+            };
+            auto apply = [&](int row, const float (&delta)[kLaneWidth]) {
+                for (int i = 0; i < 3; ++i) {
+                    for (size_t l = 0; l < kLaneWidth; ++l) {
+                        vA[i][l] += batch.axis[row][i][l] * batch.inverseMassA[l] * delta[l];
+                        wA[i][l] += batch.angularA[row][i][l] * delta[l];
+                        vB[i][l] -= batch.axis[row][i][l] * batch.inverseMassB[l] * delta[l];
+                        wB[i][l] -= batch.angularB[row][i][l] * delta[l];
+                    }
+                }
+            };
+
+            float speed[kLaneWidth];
+            float delta[kLaneWidth];
+            for (int row = 1; row < 3; ++row) {
+                closing(row, speed);
+                for (size_t l = 0; l < kLaneWidth; ++l) {
+                    const float maxFriction = batch.friction[l] * batch.impulse[0][l];
+                    const float previous = batch.impulse[row][l];
+                    batch.impulse[row][l] = std::clamp(previous - speed[l] * batch.mass[row][l], -maxFriction, maxFriction);
+                    delta[l] = batch.impulse[row][l] - previous;
+                }
+                apply(row, delta);
+            }
+            closing(0, speed);
+            for (size_t l = 0; l < kLaneWidth; ++l) {
+                const float previous = batch.impulse[0][l];
+                batch.impulse[0][l] = std::max(previous + (batch.targetVelocity[l] - speed[l]) * batch.mass[0][l], 0.0f);
+                delta[l] = batch.impulse[0][l] - previous;
+            }
+            apply(0, delta);
+
+            for (uint32_t l = 0; l < batch.lanes; ++l) {
+                const uint32_t a = batch.bodyA[l];
+                const uint32_t b = batch.bodyB[l];
+                linearVelocities[a] = {vA[0][l], vA[1][l], vA[2][l]};
+                angularVelocities[a] = {wA[0][l], wA[1][l], wA[2][l]};
+                if (b != 0) {
+                    linearVelocities[b] = {vB[0][l], vB[1][l], vB[2][l]};
+                    angularVelocities[b] = {wB[0][l], wB[1][l], wB[2][l]};
+                }
+            }
+        }
+    }
+}
+
+void RigidBodySolver::integrate(float timestep) {
+    for (uint32_t slot : awakeBodies) {
+        positions[slot] += linearVelocities[slot] * timestep;
+        const glm::vec3 w = angularVelocities[slot] * (0.5f * timestep);
+        const glm::quat& q = orientations[slot];
+        orientations[slot] = glm::normalize(q + glm::quat(0.0f, w.x, w.y, w.z) * q);
+    }
+}
+
+void RigidBodySolver::updateSleep(float timestep) {
+    for (uint32_t slot : awakeBodies) {
+        const glm::vec3 v = linearVelocities[slot];
+        const glm::vec3 w = angularVelocities[slot];
+        const bool still = glm::dot(v, v) < kSleepLinearSpeed * kSleepLinearSpeed && glm::dot(w, w) < kSleepAngularSpeed * kSleepAngularSpeed;
+        sleepTimers[slot] = still ? sleepTimers[slot] + timestep : 0.0f;
+    }
+    for (const auto& [begin, end] : islandBodyRanges) {
+        bool rested = true;
+        for (uint32_t k = begin; k < end && rested; ++k) {
+            rested = sleepTimers[islandBodies[k]] >= kTimeToSleep;
+        }
+        if (!rested) continue;
+        for (uint32_t k = begin; k < end; ++k) {
+            const uint32_t slot = islandBodies[k];
+            awake[slot] = 0;
+            linearVelocities[slot] = glm::vec3(0.0f);
+            angularVelocities[slot] = glm::vec3(0.0f);
+        }
+    }
+}
+
+void RigidBodySolver::writeToEntities() {
+    for (uint32_t slot : awakeBodies) {
+        RigidBody* body = owners[slot];
+        body->setPosition(positions[slot]);
+        body->setRotation(rotationToEuler(orientations[slot]));
+        writtenPositions[slot] = body->getPosition();
+        writtenRotations[slot] = body->getRotation();
+        refreshSubtree(body);
+    }
+}
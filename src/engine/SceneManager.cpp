@@ -1,6 +1,11 @@
 #include <SceneManager.h>
 #include <UIManager.h>
+#include <PhysicsRecorder.h>
+#include <EntityManager.h>
+#include <EntityPool.h>
+#include <Renderer.h>
 #include "../game/Scenes.h"
+#include <iostream>
 #include <utility>
 
 SceneManager::SceneManager() {
@@ -26,8 +31,23 @@ void SceneManager::switchScene(int id) {
     if (it != scenes.end()) {
         UIManager* uiMgr = UIManager::getInstance();
         uiMgr->clear();
+        EntityManager* entityMgr = EntityManager::getInstance();
+        if (!entityMgr->getAllEntities().empty()) {
+            // The last frame may still be drawing with these entities' uniform buffers.
+            Renderer* renderer = Renderer::getInstance();
+            if (renderer && renderer->getDevice() != VK_NULL_HANDLE) {
+                vkDeviceWaitIdle(renderer->getDevice());
+            }
+            entityMgr->shutdown();
+        }
+        // Hands the old scene's memory back at once, unless something outlived it.
+        EntityPool* pool = EntityPool::getInstance();
+        if (!pool->releaseChunks()) {
+            std::cerr << "SceneManager: " << pool->getLiveCount() << " pooled entities outlived scene " << currentScene << std::endl;
+        }
         currentScene = id;
         it->second();
+        PhysicsRecorder::getInstance()->onSceneStarted(id);
     }
 }
 
@@ -1,9 +1,17 @@
 #include <Skybox.h>
+#include <JobSystem.h>
 
 void Skybox::update(float deltaTime) {
-    if (camera) {
-        setPosition(camera->getPosition());
+    EntityManager* entityManager = EntityManager::getInstance();
+    Entity* cameraEntity = entityManager->getEntity(camera);
+    if (!cameraEntity) {
+        Entity* player = entityManager->getEntity("player");
+        cameraEntity = player ? player->getChild("camera") : nullptr;
+        if (!cameraEntity) return;
+        camera = cameraEntity->getHandle();
     }
+    cameraEntity->updateWorldTransform();
+    setPosition(cameraEntity->getWorldPosition());
 }
 
 std::vector<std::string> Skybox::ensureCubemapTexture() {
@@ -104,11 +112,12 @@ bool Skybox::createCubemapTexture() {
     };
 
     const int faceSizeInt = static_cast<int>(faceSize);
-#if defined(USE_OPENMP)
-    #pragma omp parallel for collapse(3)
-#endif
-    for (int face = 0; face < 6; ++face) {
-        for (int y = 0; y < faceSizeInt; ++y) {
+    // One item per row of a face; 16 rows is a few thousand texel samples.
+    const size_t rowCount = 6 * static_cast<size_t>(faceSizeInt);
+    JobSystem::getInstance()->parallelFor("Skybox::createCubemapTexture", rowCount, 16, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row) {
+            const int face = static_cast<int>(row / static_cast<size_t>(faceSizeInt));
+            const int y = static_cast<int>(row % static_cast<size_t>(faceSizeInt));
             for (int x = 0; x < faceSizeInt; ++x) {
                 const float s = (static_cast<float>(x) + 0.5f) / static_cast<float>(faceSizeInt) * 2.0f - 1.0f;
                 const float t = (static_cast<float>(y) + 0.5f) / static_cast<float>(faceSizeInt) * 2.0f - 1.0f;
@@ -129,7 +138,7 @@ bool Skybox::createCubemapTexture() {
                 cubemapData[baseIndex + 3] = 1.0f;
             }
         }
-    }
+    });
 
     if (hdrPixels) {
         stbi_image_free(hdrPixels);
@@ -1,6 +1,8 @@
 #include <TextureManager.h>
 #include <Renderer.h>
+#include <JobSystem.h>
 #include <filesystem>
+#include <iostream>
 #include <stb/stb_image.h>
 #include <utils.h>
 
@@ -55,44 +57,40 @@ void TextureManager::findAllTextures(std::string path, std::string prevName) {
 }
 void TextureManager::prepareTextureAtlas() {
     struct ImageLoadResult {
-        std::string name;
+        Image* texture;
         void* pixels;
         int width;
         int height;
         bool isHDR;
     };
-    std::vector<ImageLoadResult> loadedImages;
-    
-#if defined(USE_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i < static_cast<int>(textureAtlas.size()); ++i) {
-        auto it = std::next(textureAtlas.begin(), i);
-        stbi_set_flip_vertically_on_load(true);
+    std::vector<Image*> targets;
+    targets.reserve(textureAtlas.size());
+    for (auto& [name, image] : textureAtlas) {
+        targets.push_back(&image);
+    }
+    std::vector<ImageLoadResult> loadedImages(targets.size());
+
+    // Each file decodes on the pool; its upload follows on the main thread,
+    // where the Vulkan calls belong, as soon as that decode is done.
+    stbi_set_flip_vertically_on_load(true);
+    auto decode = [&](size_t i) {
         int texWidth, texHeight, texChannels;
         void* pixels = nullptr;
         bool isHDR = false;
         
-        if (it->second.path.ends_with(".hdr")) {
-            pixels = stbi_loadf(it->second.path.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+        if (targets[i]->path.ends_with(".hdr")) {
+            pixels = stbi_loadf(targets[i]->path.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
             isHDR = true;
         } else {
-            pixels = stbi_load(it->second.path.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+            pixels = stbi_load(targets[i]->path.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
             isHDR = false;
         }
-        
-#if defined(USE_OPENMP)
-        #pragma omp critical
-#endif
-        {
-            loadedImages.push_back({it->first, pixels, texWidth, texHeight, isHDR});
-        }
-    }
-    
-    for (auto& imageData : loadedImages) {
-        Image& texture = textureAtlas[imageData.name];
+        loadedImages[i] = {targets[i], pixels, texWidth, texHeight, isHDR};
+    };
+    auto upload = [&](ImageLoadResult& imageData) {
+        Image& texture = *imageData.texture;
         void* pixels = imageData.pixels;
-        if (!pixels || imageData.width <= 0 || imageData.height <= 0) continue;
+        if (!pixels || imageData.width <= 0 || imageData.height <= 0) return;
         
         VkFormat imageFormat;
         VkDeviceSize pixelSize;
@@ -164,8 +162,34 @@ void TextureManager::prepareTextureAtlas() {
         }
         
         stbi_image_free(pixels);
+    };
+
+    JobSystem* jobs = JobSystem::getInstance();
+    std::vector<JobSystem::JobHandle> uploads;
+    uploads.reserve(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i) {
+        JobSystem::JobHandle decoded = jobs->schedule("TextureManager::decode", [&decode, i] { decode(i); });
+        uploads.push_back(jobs->schedule("TextureManager::upload", [&upload, &loadedImages, i] { upload(loadedImages[i]); }, {decoded}, JobSystem::Affinity::MainThread));
+    }
+    for (const JobSystem::JobHandle& job : uploads) {
+        jobs->wait(job);
     }
 }
+bool TextureManager::loadHeightmap(const std::string& path, std::vector<uint16_t>& samples, int& width, int& height) {
+    const std::string resolved = resolvePath(path).string();
+    stbi_set_flip_vertically_on_load(false);
+    int channels = 0;
+    stbi_us* pixels = stbi_load_16(resolved.c_str(), &width, &height, &channels, 1);
+    if (!pixels || width <= 0 || height <= 0) {
+        std::cerr << "TextureManager::loadHeightmap - failed to load " << resolved << ": " << stbi_failure_reason() << "\n";
+        if (pixels) stbi_image_free(pixels);
+        return false;
+    }
+    samples.assign(pixels, pixels + static_cast<size_t>(width) * static_cast<size_t>(height));
+    stbi_image_free(pixels);
+    return true;
+}
+
 Image* TextureManager::getTexture(const std::string& name) {
     auto it = textureAtlas.find(name);
     if(it != textureAtlas.end()) {
@@ -2,25 +2,34 @@
 #include <CharacterEntity.h>
 #include <EntityManager.h>
 #include <Collider.h>
+#include <CollisionWorld.h>
+#include "Player.h"
 
-class Player;
-
+// Sensor volume around the enemy. CollisionWorld reports which characters
+// enter and leave it, so nothing here is polled per frame.
 class DetectorAABB : public AABBCollider {
 public:
     DetectorAABB(const glm::vec3& position, const glm::vec3& rotation, const std::string& parentName = "", const glm::vec3& halfSize = {0.5f, 0.5f, 0.5f})
-        : AABBCollider(position, rotation, parentName + "_detector", halfSize) {}
+        : AABBCollider(position, rotation, parentName + "_detector", halfSize) {
+        setTrigger(true);
+        setCollisionLayer(CollisionLayer::Sensor);
+        setCollisionMask(CollisionLayer::Character);
+    }
 
-    bool isEntityInside(Entity* entity) const {
+    bool isEntityInside(const Entity* entity) const {
         if (!entity) return false;
+        return std::any_of(inside.begin(), inside.end(), [entity](const Collider* c) { return c->getParent() == entity; });
+    }
 
-        ColliderAABB myAABB = getWorldAABB();
-
-        glm::vec3 entityPos = entity->getPosition();
-
-        return (entityPos.x >= myAABB.min.x && entityPos.x <= myAABB.max.x &&
-                entityPos.y >= myAABB.min.y && entityPos.y <= myAABB.max.y &&
-                entityPos.z >= myAABB.min.z && entityPos.z <= myAABB.max.z);
+    void onTriggerEnter(Collider* other) override {
+        inside.push_back(other);
+    }
+    void onTriggerExit(Collider* other) override {
+        inside.erase(std::remove(inside.begin(), inside.end(), other), inside.end());
     }
+
+private:
+    std::vector<Collider*> inside;
 };
 
 class Enemy : public CharacterEntity {
@@ -31,6 +40,9 @@ private:
     glm::vec3 computedWorldDirection = glm::vec3(0.0f);
     glm::vec3 lastPlayerPosition = glm::vec3(0.0f);
     bool hasLastPlayerPosition = false;
+    // Resolved through the handle, and looked up by name again whenever that
+    // fails, so a player that is replaced or respawned is found again.
+    EntityHandle player;
     const float playerMoveThreshold = 0.02f;
 
 public:
@@ -83,13 +95,15 @@ public:
         tailRight->setModel(ModelManager::getInstance()->getModel("cube"));
         this->addChild(tailRight);
 
-        OBBCollider* obbBox = new OBBCollider(
+        CapsuleCollider* capsule = new CapsuleCollider(
             {0.0f, 0.6f, 0.0f},
             {0.0f, 0.0f, 0.0f},
             this->getName(),
-            {0.5f, 1.8f, 0.5f}
+            0.5f,
+            1.8f
         );
-        this->addChild(obbBox);
+        capsule->setCollisionLayer(CollisionLayer::Character);
+        this->addChild(capsule);
 
         detectorAABB = new DetectorAABB(
             {0.0f, 0.0f, 0.0f},
@@ -124,6 +138,10 @@ private:
 
     float shootCooldown = 0.5f;
     float shootTimer = 0.0f;
+    const float shootRange = 100.0f;
+    const float shootDamage = 5.0f;
+    const float eyeHeight = 1.6f;
+    const float aimHeight = 0.6f;
 
 
     float jumpCooldown = 0.5f;
@@ -133,6 +151,7 @@ private:
     const float stuckMovementThreshold = 0.05f;
     const int maxStuckFrames = 10;
     int stuckFrameCount = 0;
+    uint64_t lastPhysicsTick = 0;
     float chaseSpeed = 6.0f;
     void haltMovement() {
         if (glm::length(lastMoveDirection) > 0.001f) {
@@ -239,7 +258,7 @@ private:
 
         
         if (shootTimer >= shootCooldown) {
-            shoot();
+            shoot(playerEntity);
             shootTimer = 0.0f;
         }
     }
@@ -261,24 +280,16 @@ private:
         if (glm::length(computedWorldDirection) > 0.001f && jumpTimer >= jumpCooldown) {
             
             float lookAheadDist = 1.5f; 
-            glm::vec3 lookAheadPos = computedWorldDirection * lookAheadDist;
-            lookAheadPos.y = 0.0f; 
-
-            collision futureCollision = willCollide(lookAheadPos);
-
-            if (futureCollision.other) {
-                
-                float mtvLen = glm::length(futureCollision.mtv);
-                if (mtvLen > 0.001f) {
-                    glm::vec3 collisionNormal = futureCollision.mtv / mtvLen;
-
-                    
-                    
-                    if (std::abs(collisionNormal.y) < 0.7f) {
-                        jump();
-                        jumpTimer = 0.0f;
-                        stuckFrameCount = 0;
-                    }
+            glm::vec3 lookAheadDir = computedWorldDirection;
+            lookAheadDir.y = 0.0f; 
+
+            RaycastHit obstacle;
+            if (glm::length(lookAheadDir) > 0.001f && castBody(lookAheadDir, lookAheadDist, obstacle)) {
+                // Walls ahead are worth jumping; slopes and the floor are not.
+                if (std::abs(obstacle.normal.y) < 0.7f) {
+                    jump();
+                    jumpTimer = 0.0f;
+                    stuckFrameCount = 0;
                 }
             }
         }
@@ -289,7 +300,13 @@ private:
             move(lastMoveDirection);
         }
 
-       
+        // Frames without a physics step cannot have moved us; don't count them as stuck.
+        const uint64_t physicsTick = PhysicsWorld::getInstance()->getTick();
+        if (physicsTick == lastPhysicsTick) {
+            return;
+        }
+        lastPhysicsTick = physicsTick;
+
         glm::vec3 currentPos = getPosition();
         glm::vec3 positionDelta = currentPos - lastPosition;
         positionDelta.y = 0.0f;
@@ -314,8 +331,22 @@ private:
         lastPosition = currentPos;
     }
 
-    void shoot() {
+    // Hitscan from eye height at the player's chest; walls in between block the shot.
+    void shoot(Entity* target) {
         std::cout << "[Enemy] Shooting at player!" << std::endl;
+        const glm::vec3 origin = getPosition() + glm::vec3(0.0f, eyeHeight, 0.0f);
+        const glm::vec3 aim = target->getPosition() + glm::vec3(0.0f, aimHeight, 0.0f) - origin;
+        QueryFilter filter;
+        filter.ignore = this;
+        filter.layer = CollisionLayer::Projectile;
+        RaycastHit hit;
+        if (!CollisionWorld::getInstance()->raycast(origin, aim, shootRange, hit, filter)) {
+            return;
+        }
+        PhysicsWorld::getInstance()->wake(hit.collider->getParent());
+        if (Player* player = dynamic_cast<Player*>(hit.collider->getParent())) {
+            player->registerHit(shootDamage);
+        }
     }
 
 public:
@@ -323,10 +354,12 @@ public:
         static int frameCount = 0;
         frameCount++;
 
-        Entity* playerEntity = EntityManager::getInstance()->getEntity("player");
+        EntityManager* entityManager = EntityManager::getInstance();
+        Entity* playerEntity = entityManager->getEntity(player);
         if (!playerEntity) {
-            CharacterEntity::update(deltaTime);
-            return;
+            player = entityManager->findEntity("player");
+            playerEntity = entityManager->getEntity(player);
+            if (!playerEntity) return;
         }
 
       
@@ -365,6 +398,5 @@ public:
         }
 
         applyComputedMovement(deltaTime);
-        CharacterEntity::update(deltaTime);
     }
 };
@@ -16,14 +16,18 @@ private:
 
     float health = 100.0f;
     float maxHealth = 100.0f;
+    // Resolved through the handle, and looked up by name again whenever that
+    // fails, so an enemy that is replaced or respawned is found again.
+    EntityHandle enemy;
 
 public:
     Player(const glm::vec3& position = {0.0f, 0.0f, 0.0f}, const glm::vec3& rotation = {0.0f, 0.0f, 0.0f})
         : CharacterEntity("player", "gbuffer", position, rotation) {
         playerCamera = new Camera({0.0f, 1.6f, 0.0f}, {0.0f, rotation.y, 0.0f}, 70.0f);
         this->addChild(playerCamera);
-        OBBCollider* box = new OBBCollider({0.0f, 0.6f, 0.0f}, {0.0f, 0.0f, 0.0f}, this->getName(), {0.5f, 1.8f, 0.5f});
-        this->addChild(box);
+        CapsuleCollider* capsule = new CapsuleCollider({0.0f, 0.6f, 0.0f}, {0.0f, 0.0f, 0.0f}, this->getName(), 0.5f, 1.8f);
+        capsule->setCollisionLayer(CollisionLayer::Character);
+        this->addChild(capsule);
         Renderer::getInstance()->setActiveCamera(playerCamera);
         InputManager::getInstance()->registerListener([this](const std::vector<InputEvent>& events) { this->registerInput(events); });
     }
@@ -94,17 +98,20 @@ public:
             glm::vec3 myPos = getPosition();
 
             // Get enemy position if it exists
-            Entity* enemyEntity = EntityManager::getInstance()->getEntity("enemy");
+            EntityManager* entityManager = EntityManager::getInstance();
+            Entity* enemyEntity = entityManager->getEntity(enemy);
+            if (!enemyEntity) {
+                enemy = entityManager->findEntity("enemy");
+                enemyEntity = entityManager->getEntity(enemy);
+            }
             if (enemyEntity) {
                 glm::vec3 enemyPos = enemyEntity->getPosition();
                 glm::vec3 toEnemy = enemyPos - myPos;
                 glm::vec3 toEnemyXZ = toEnemy;
                 toEnemyXZ.y = 0.0f;
                 float distanceXZ = glm::length(toEnemyXZ);
+            }
         }
-
-        // Call parent update
-        CharacterEntity::update(deltaTime);
     }
 
     float getHealth() const { return health; }
@@ -15,6 +15,9 @@
 #include <Camera.h>
 #include <Renderer.h>
 #include <Collider.h>
+#include <ConvexDecomposition.h>
+#include <MeshCollider.h>
+#include <RigidBody.h>
 #include <Skybox.h>
 #include <utils.h>
 #include "Scenes.h"
@@ -22,7 +25,9 @@
 
 #define PI 3.14159265358979323846
 
-Skybox* skybox;
+namespace {
+    constexpr float kCrateMass = 20.0f;
+}
 
 void MainMenu() {
     Renderer::getInstance()->setUIMode(true);
@@ -33,34 +38,35 @@ void MainMenu() {
     ButtonObject* startButton = new ButtonObject({0.0f, -60.0f}, {200.0f, 50.0f}, {1, 1}, "startButton", "window", "Start Game", StartGame);
     container->addChild(startButton);
     uiMgr->addUIObject(container);
-    skybox = new Skybox();
+    // The game scene's sky is its own entity; only the cubemap is built here.
+    Skybox::ensureCubemapTexture();
 }
 
 void Scene1() {
     Renderer::getInstance()->setUIMode(false);
     ModelManager* modelMgr = ModelManager::getInstance();
     EntityManager* entityMgr = EntityManager::getInstance();
-    Entity* cube1 = new Entity("exampleCube", "gbuffer", blenderPosToEngine({16.226f, -9.377f, 0.338f}), blenderRotToEngine({-0.915f, -4.86f, 36.1f}), {1.0f, 1.0f, 1.0f}, {"materials_crate_albedo", "materials_crate_metallic", "materials_crate_roughness", "materials_crate_normal"});
+    RigidBody* cube1 = new RigidBody("exampleCube", "gbuffer", blenderPosToEngine({16.226f, -9.377f, 0.338f}), blenderRotToEngine({-0.915f, -4.86f, 36.1f}), kCrateMass, {"materials_crate_albedo", "materials_crate_metallic", "materials_crate_roughness", "materials_crate_normal"});
     cube1->setModel(modelMgr->getModel("cube"));
     OBBCollider* box1 = new OBBCollider({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, cube1->getName(), {1.0f, 1.0f, 1.0f});
     cube1->addChild(box1);
     entityMgr->addEntity("exampleCube", cube1);
-    Entity* cube2 = new Entity("exampleCube2", "gbuffer", blenderPosToEngine({-3.428f, 9.697f, 0.038f}), blenderRotToEngine({0.805f, -5.75f, 20.8f}), {1.0f, 1.0f, 1.0f}, {"materials_crate_albedo", "materials_crate_metallic", "materials_crate_roughness", "materials_crate_normal"});
+    RigidBody* cube2 = new RigidBody("exampleCube2", "gbuffer", blenderPosToEngine({-3.428f, 9.697f, 0.038f}), blenderRotToEngine({0.805f, -5.75f, 20.8f}), kCrateMass, {"materials_crate_albedo", "materials_crate_metallic", "materials_crate_roughness", "materials_crate_normal"});
     cube2->setModel(modelMgr->getModel("cube"));
     OBBCollider* box2 = new OBBCollider({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, cube2->getName(), {1.0f, 1.0f, 1.0f});
     cube2->addChild(box2);
     entityMgr->addEntity("exampleCube2", cube2);
-    Entity* cube3 = new Entity("exampleCube3", "gbuffer", blenderPosToEngine({-13.327f, -10.937f, 0.063f}), blenderRotToEngine({47.1f, -83.4f, 60.2f}), {1.0f, 1.0f, 1.0f}, {"materials_crate_albedo", "materials_crate_metallic", "materials_crate_roughness", "materials_crate_normal"});
+    RigidBody* cube3 = new RigidBody("exampleCube3", "gbuffer", blenderPosToEngine({-13.327f, -10.937f, 0.063f}), blenderRotToEngine({47.1f, -83.4f, 60.2f}), kCrateMass, {"materials_crate_albedo", "materials_crate_metallic", "materials_crate_roughness", "materials_crate_normal"});
     cube3->setModel(modelMgr->getModel("cube"));
     OBBCollider* box3 = new OBBCollider({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, cube3->getName(), {1.0f, 1.0f, 1.0f});
     cube3->addChild(box3);
     entityMgr->addEntity("exampleCube3", cube3);
-    Entity* cube4 = new Entity("exampleCube4", "gbuffer", blenderPosToEngine({-5.744f, 1.052f, 0.364f}), blenderRotToEngine({96.4f, -1.02f, 83.8f}), {1.0f, 1.0f, 1.0f}, {"materials_crate_albedo", "materials_crate_metallic", "materials_crate_roughness", "materials_crate_normal"});
+    RigidBody* cube4 = new RigidBody("exampleCube4", "gbuffer", blenderPosToEngine({-5.744f, 1.052f, 0.364f}), blenderRotToEngine({96.4f, -1.02f, 83.8f}), kCrateMass, {"materials_crate_albedo", "materials_crate_metallic", "materials_crate_roughness", "materials_crate_normal"});
     cube4->setModel(modelMgr->getModel("cube"));
     OBBCollider* box4 = new OBBCollider({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, cube4->getName(), {1.0f, 1.0f, 1.0f});
     cube4->addChild(box4);
     entityMgr->addEntity("exampleCube4", cube4);
-    Entity* cube5 = new Entity("exampleCube5", "gbuffer", blenderPosToEngine({-5.676f, -1.421f, 0.405f}), blenderRotToEngine({-92.9f, -5.97f, -1.38f}), {1.0f, 1.0f, 1.0f}, {"materials_crate_albedo", "materials_crate_metallic", "materials_crate_roughness", "materials_crate_normal"});
+    RigidBody* cube5 = new RigidBody("exampleCube5", "gbuffer", blenderPosToEngine({-5.676f, -1.421f, 0.405f}), blenderRotToEngine({-92.9f, -5.97f, -1.38f}), kCrateMass, {"materials_crate_albedo", "materials_crate_metallic", "materials_crate_roughness", "materials_crate_normal"});
     cube5->setModel(modelMgr->getModel("cube"));
     OBBCollider* box5 = new OBBCollider({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, cube5->getName(), {1.0f, 1.0f, 1.0f});
     cube5->addChild(box5);
@@ -69,9 +75,9 @@ void Scene1() {
 
     Entity* floor = new Entity("floor", "gbuffer", {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {"materials_ground_albedo", "materials_ground_metallic", "materials_ground_roughness", "materials_ground_normal"});
     floor->setModel(ModelManager::getInstance()->getModel("ground"));
-    ConvexCollider* floorBox = new ConvexCollider({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, floor->getName());
-    floorBox->setVerticesInterleaved(modelMgr->getModel("ground-collider")->getVertices(), 11, 0, modelMgr->getModel("ground-collider")->getIndices(), {0.0f, 0.0f, 0.0f});
-    floor->addChild(floorBox);
+    for (ConvexCollider* floorHull : attachConvexHulls(floor, loadConvexDecomposition(*modelMgr->getModel("ground-collider")))) {
+        floorHull->setStatic(true);
+    }
     entityMgr->addEntity("floor", floor);
 
     Player* player = new Player({16.0f, 10.0f, -9.0f}, {0.0f, 0.0f, 0.0f});
@@ -85,9 +91,13 @@ void Scene1() {
 
     Entity* walls = new Entity("walls", "gbuffer", {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {1.2f, 1.2f, 1.2f}, {"materials_walls_albedo", "materials_walls_metallic", "materials_walls_roughness", "materials_walls_normal"});
     walls->setModel(ModelManager::getInstance()->getModel("walls"));
+    MeshCollider* wallsMesh = new MeshCollider({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, walls->getName());
+    wallsMesh->setVerticesInterleaved(modelMgr->getModel("walls")->getVertices(), 11, 0, modelMgr->getModel("walls")->getIndices());
+    walls->addChild(wallsMesh);
+    wallsMesh->setStatic(true);
     entityMgr->addEntity("walls", walls);
     
-    entityMgr->addEntity("skybox", skybox);
+    entityMgr->addEntity("skybox", new Skybox());
 }
 
 std::map<int, std::function<void()>> Scenes::sceneList = {
@@ -1,6 +1,49 @@
 #include <Renderer.h>
+#include <JobSystem.h>
+#include <PhysicsRecorder.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
 
-int main() {
+namespace {
+    // Parses a whole non-negative count; false for anything else.
+    bool parseCount(const char* text, size_t& out) {
+        const char* end = text + std::strlen(text);
+        const auto [last, error] = std::from_chars(text, end, out);
+        return error == std::errc() && last == end && last != text;
+    }
+}
+
+// --record <file> saves the session's input for replay; --replay <file> runs
+// it back without drawing and exits non-zero if the simulation diverged.
+// --jobs <n> sets how many pool threads run jobs besides the main thread, at
+// most one per hardware thread.
+int main(int argc, char** argv) {
+    PhysicsRecorder* recorder = PhysicsRecorder::getInstance();
+    size_t jobs = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if ((arg == "--record" || arg == "--replay") && i + 1 < argc) {
+            if (arg == "--record") {
+                recorder->recordTo(argv[++i]);
+            } else {
+                recorder->replayFrom(argv[++i]);
+            }
+        } else if (arg == "--jobs" && i + 1 < argc && parseCount(argv[i + 1], jobs)) {
+            ++i;
+            const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+            JobSystem::getInstance()->setWorkerCount(std::min(jobs, hardware));
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--record <file> | --replay <file>] [--jobs <n>]\n";
+            return 1;
+        }
+    }
     Renderer::getInstance()->run();
+    if (recorder->isReplaying() && !recorder->replayMatched()) {
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}